@@ -113,10 +113,10 @@ int main(int argc, char *argv[])
     string benchmark_info="measured with no load on 07.07.";
     Numa* n2 = (Numa*)n->FindSubcomponentById(2, SYS_SAGE_COMPONENT_NUMA);
     if(n2 != NULL){
-        DataPath * dp = (*(n2->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)))[0];
+        DataPath * dp = n2->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING)[0];
         if(dp != NULL)
             dp->attrib["info"]=(void*)&benchmark_info;
-        dp = (*(n2->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)))[2];
+        dp = n2->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING)[2];
         if(dp != NULL)
             dp->attrib["info"]=(void*)&benchmark_info;
     }
@@ -70,11 +70,9 @@ int main(int argc, char *argv[])
 
     //get num caps-benchmark DataPaths
     int caps_dataPaths = 0;
-    vector<DataPath*>* capsDataPaths;
     for(Component* gpu_c: hwlocComponentList)
     {
-        capsDataPaths = gpu_c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        caps_dataPaths += capsDataPaths->size();
+        caps_dataPaths += gpu_c->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size();
     }
 
     //get size of hwloc representation + caps-benchmark DataPaths
@@ -88,14 +86,15 @@ int main(int argc, char *argv[])
     unsigned int max_bw = 0;
     Component* max_bw_component = NULL;
     t_start = high_resolution_clock::now();
-    vector<DataPath*>* dp = numa->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-    for(auto it = std::begin(*dp); it != std::end(*dp); ++it) {
-        if( (*it)->GetBw() > max_bw ){
-            max_bw = (*it)->GetBw();
-            max_bw_component = (*it)->GetTarget();
-        }
+    MetricMatrix* bw_matrix = BuildMatrix(n, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_METRIC_BW);
+    int numa_row = bw_matrix->GetRowIndex(numa);
+    int max_bw_col = bw_matrix->RowArgMax(numa_row);
+    if(max_bw_col >= 0){
+        max_bw = bw_matrix->Get(numa_row, max_bw_col);
+        max_bw_component = bw_matrix->GetColComponent(max_bw_col);
     }
     t_end = high_resolution_clock::now();
+    delete bw_matrix;
     uint64_t time_getNumaMaxBw = t_end.time_since_epoch().count()-t_start.time_since_epoch().count()-timer_overhead;
 
     //time mt4g parser
@@ -125,11 +124,9 @@ int main(int argc, char *argv[])
 
     //get num mt4g DataPaths
     int mt4g_dataPaths = 0;
-    vector<DataPath*>* componentDataPaths;
     for(Component* gpu_c: mt4gComponentList)
     {
-        componentDataPaths = gpu_c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        mt4g_dataPaths += componentDataPaths->size();
+        mt4g_dataPaths += gpu_c->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size();
     }
 
     /////////////////print results
@@ -0,0 +1,238 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+//kind of an object allocated by AllocateObject; stored in the lowest bit of the entry in Arena::objects
+#define ARENA_OBJECT_COMPONENT 0
+#define ARENA_OBJECT_DATAPATH 1
+//alignment of the slots of Components and DataPaths, the same as with plain operator new
+#define ARENA_OBJECT_ALIGNMENT __STDCPP_DEFAULT_NEW_ALIGNMENT__
+
+thread_local Arena* Arena::active = NULL;
+thread_local void* Arena::last_object = NULL;
+thread_local Arena* Arena::last_object_owner = NULL;
+thread_local void* Arena::released_object = NULL;
+thread_local Arena* Arena::released_object_owner = NULL;
+
+//chunks of all Arenas: start -> (end, owner), used by FindOwner()
+//function-local statics, so that they are constructed before the first Arena regardless of the order of static initialization
+static map<uintptr_t, pair<uintptr_t, Arena*>>& GetArenaChunks()
+{
+    static map<uintptr_t, pair<uintptr_t, Arena*>> arena_chunks;
+    return arena_chunks;
+}
+static shared_mutex& GetArenaChunksMutex()
+{
+    static shared_mutex arena_chunks_mutex;
+    return arena_chunks_mutex;
+}
+static atomic<size_t> num_arena_chunks { 0 };
+
+Arena::Arena(size_t _chunk_size) : chunk_size(_chunk_size) {}
+
+Arena::~Arena()
+{
+    //destroy all objects that were not deleted one by one; their memory is released together with the chunks
+    unordered_set<void*> dead;
+    for(auto& slots : free_slots)
+        for(auto& [size, v] : slots)
+            dead.insert(v.begin(), v.end());
+    dead_objects = &dead;
+    for(uintptr_t entry : objects)
+    {
+        void* obj = (void*)(entry & ~(uintptr_t)1);
+        if(!dead.insert(obj).second)
+            continue;
+        if((entry & 1) == ARENA_OBJECT_DATAPATH)
+            ((DataPath*)obj)->~DataPath();
+        else
+            ((Component*)obj)->~Component();
+    }
+    //the objects destroyed above are not released one by one
+    released_object = NULL;
+    for(auto it = finalizers.rbegin(); it != finalizers.rend(); ++it)
+        it->second(it->first);
+    {
+        map<uintptr_t, pair<uintptr_t, Arena*>>& arena_chunks = GetArenaChunks();
+        unique_lock<shared_mutex> lock(GetArenaChunksMutex());
+        for(char* chunk : chunks)
+            arena_chunks.erase((uintptr_t)chunk);
+        num_arena_chunks = arena_chunks.size();
+    }
+    for(char* chunk : chunks)
+        ::operator delete(chunk);
+}
+
+char* Arena::NewRegisteredChunk(size_t size)
+{
+    char* chunk = (char*)::operator new(size);
+    chunks.push_back(chunk);
+    reserved_bytes += size;
+    map<uintptr_t, pair<uintptr_t, Arena*>>& arena_chunks = GetArenaChunks();
+    unique_lock<shared_mutex> lock(GetArenaChunksMutex());
+    arena_chunks[(uintptr_t)chunk] = {(uintptr_t)chunk + size, this};
+    num_arena_chunks = arena_chunks.size();
+    return chunk;
+}
+
+void Arena::NewChunk(size_t min_size)
+{
+    size_t size = std::max(chunk_size, min_size);
+    cur = NewRegisteredChunk(size);
+    end = cur + size;
+}
+
+//size of the slot of an object, so that consecutive objects stay aligned
+static size_t GetSlotSize(size_t object_size)
+{
+    return (object_size + ARENA_OBJECT_ALIGNMENT - 1) & ~(size_t)(ARENA_OBJECT_ALIGNMENT - 1);
+}
+
+void Arena::ReserveObjects(size_t object_size, size_t num_objects)
+{
+    size_t size = num_objects * GetSlotSize(object_size) + ARENA_OBJECT_ALIGNMENT;
+    if(cur == NULL || (size_t)(end - cur) < size)
+        NewChunk(size);
+    objects.reserve(objects.size() + num_objects);
+    reserved_objects = num_objects;
+    reserved_object_size = object_size;
+}
+
+void* Arena::Allocate(size_t size, size_t alignment)
+{
+    allocated_bytes += size;
+    if(size + alignment > chunk_size)
+    {
+        //large allocation -- gets a chunk of its own, the current chunk stays in use
+        char* chunk = NewRegisteredChunk(size + alignment);
+        return (void*)(((uintptr_t)chunk + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    uintptr_t p = ((uintptr_t)cur + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if(cur == NULL || p + size > (uintptr_t)end)
+    {
+        NewChunk(size + alignment);
+        p = ((uintptr_t)cur + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+    cur = (char*)(p + size);
+    return (void*)p;
+}
+
+void* Arena::AllocateSlot(size_t size, int kind)
+{
+    live_objects++;
+    if(reserved_objects > 0 && size == reserved_object_size)
+    {
+        //reserved objects are bumped from the reserved block, so that they stay contiguous
+        reserved_objects--;
+    }
+    else if(num_free_slots > 0)
+    {
+        auto it = free_slots[kind].find(size);
+        if(it != free_slots[kind].end() && !it->second.empty())
+        {
+            void* obj = it->second.back();
+            it->second.pop_back();
+            num_free_slots--;
+            return obj;
+        }
+    }
+    void* obj = Allocate(GetSlotSize(size), ARENA_OBJECT_ALIGNMENT);
+    objects.push_back((uintptr_t)obj | (uintptr_t)kind);
+    return obj;
+}
+
+//Components and DataPaths on the heap come from plain operator new; the constructor of the object takes its owner (see TakeObjectOwner()) and keeps it in its AttributeStore
+void* Arena::AllocateObject(size_t size, int kind)
+{
+    last_object = (active == NULL) ? ::operator new(size) : active->AllocateSlot(size, kind);
+    last_object_owner = active;
+    return last_object;
+}
+
+//objects which were not allocated by AllocateObject() (e.g. on the stack) are not owned by any Arena
+Arena* Arena::TakeObjectOwner(const void* obj)
+{
+    if(obj != last_object)
+        return NULL;
+    last_object = NULL;
+    return last_object_owner;
+}
+
+//called by the destructor of a Component or DataPath, right before its operator delete (if it is deleted)
+void Arena::SetReleasedObject(void* obj, Arena* owner)
+{
+    released_object = obj;
+    released_object_owner = owner;
+}
+
+Arena* Arena::FindOwner(const void* ptr)
+{
+    if(num_arena_chunks == 0)
+        return NULL;
+    map<uintptr_t, pair<uintptr_t, Arena*>>& arena_chunks = GetArenaChunks();
+    shared_lock<shared_mutex> lock(GetArenaChunksMutex());
+    auto it = arena_chunks.upper_bound((uintptr_t)ptr);
+    if(it == arena_chunks.begin())
+        return NULL;
+    --it;
+    return ((uintptr_t)ptr < it->second.first) ? it->second.second : NULL;
+}
+
+void Arena::ReleaseObject(void* ptr, size_t size, int kind)
+{
+    if(ptr == NULL)
+        return;
+    Arena* arena;
+    if(ptr == released_object)
+    {
+        arena = released_object_owner;
+        released_object = NULL;
+    }
+    else
+    {
+        //the destructor did not run (the constructor threw): fall back to the address lookup
+        arena = FindOwner(ptr);
+    }
+    if(arena == NULL)
+        ::operator delete(ptr);
+    else
+        arena->Release(ptr, size, kind);
+}
+
+void Arena::Release(void* obj, size_t size, int kind)
+{
+    //the memory itself is only reclaimed when the whole Arena goes away; until then, the slot is reused
+    live_objects--;
+    if(dead_objects != NULL)
+    {
+        dead_objects->insert(obj);
+        return;
+    }
+    free_slots[kind][size].push_back(obj);
+    num_free_slots++;
+}
+
+size_t Arena::GetAllocatedBytes(){return allocated_bytes;}
+size_t Arena::GetReservedBytes(){return reserved_bytes;}
+size_t Arena::GetNumLiveObjects(){return live_objects;}
+Arena* Arena::GetActive(){return active;}
+
+ArenaScope::ArenaScope(Arena* arena) : previous(Arena::active)
+{
+    if(arena != NULL)
+        Arena::active = arena;
+}
+ArenaScope::~ArenaScope(){Arena::active = previous;}
+
+void* Component::operator new(size_t size){return Arena::AllocateObject(size, ARENA_OBJECT_COMPONENT);}
+void Component::operator delete(void* ptr, size_t size){Arena::ReleaseObject(ptr, size, ARENA_OBJECT_COMPONENT);}
+void* DataPath::operator new(size_t size){return Arena::AllocateObject(size, ARENA_OBJECT_DATAPATH);}
+void DataPath::operator delete(void* ptr, size_t size){Arena::ReleaseObject(ptr, size, ARENA_OBJECT_DATAPATH);}
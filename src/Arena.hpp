@@ -0,0 +1,147 @@
+#ifndef ARENA
+#define ARENA
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <new>
+#include <type_traits>
+
+#include "defines.hpp"
+
+#define SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE (1024*1024) /**< Default size (in Bytes) of one memory chunk of an Arena. */
+
+using namespace std;
+class Component;
+class DataPath;
+
+/**
+Class Arena - a memory pool (chunked bump allocator) for Components, DataPaths and their attribute values.
+\n An Arena is normally owned by a Topology (see Topology::EnableArena()). While an Arena is active in the current thread (see ArenaScope), all Components and DataPaths created with new are allocated from it. The parsers activate the Arena of the Topology they are parsing into automatically.
+\n Objects allocated from an Arena can still be deleted one by one (e.g. by Component::Delete() or DataPath::DeleteDataPath()); their memory is kept in a free list per object size and reused by the next Component or DataPath of the same size, and only released when the Arena is destroyed. Each Component and DataPath records the Arena it was allocated from in its attribute store (see AttributeStore::GetArena()), so deleting an object (on the heap or in an Arena) needs no lookup. When the Arena is destroyed (i.e. when its Topology goes away), all objects still living in it are destroyed and all memory is released at once.
+\n An Arena is not thread-safe; it should be used by one thread at a time.
+*/
+class Arena {
+public:
+    /**
+    Arena constructor. No memory is reserved until the first allocation.
+    @param _chunk_size - size (in Bytes) of one memory chunk, default SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE. Larger allocations get a chunk of their own.
+    */
+    Arena(size_t _chunk_size = SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE);
+    /**
+    Destroys all Components and DataPaths (and attribute values created with New()) still living in the Arena and releases all the memory at once.
+    */
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+    Allocates raw memory from the Arena. The memory is released when the Arena is destroyed.
+    @param size - number of Bytes to allocate
+    @param alignment - required alignment (a power of 2), default alignof(std::max_align_t)
+    @return pointer to the allocated memory
+    */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    /**
+    Constructs an object of type T (e.g. an attribute value) in the Arena. If T is not trivially destructible, its destructor is called when the Arena is destroyed.
+    @return pointer to the new object
+    */
+    template <typename T, typename... Args> T* New(Args&&... args);
+    /**
+    Makes sure that the next num_objects Components or DataPaths of object_size Bytes each (e.g. a batch of DataPaths, see DataPathBatch) are allocated from one contiguous block of a chunk. The free slots of deleted objects are not used for them.
+    @param object_size - size of one object (e.g. sizeof(DataPath))
+    @param num_objects - number of objects
+    */
+    void ReserveObjects(size_t object_size, size_t num_objects);
+
+    /**
+    @returns number of Bytes handed out by the Arena (reused slots of deleted objects are not counted again)
+    */
+    size_t GetAllocatedBytes();
+    /**
+    @returns number of Bytes reserved by the Arena in all its chunks
+    */
+    size_t GetReservedBytes();
+    /**
+    @returns number of Components and DataPaths allocated from the Arena that have not been deleted yet
+    */
+    size_t GetNumLiveObjects();
+
+    /**
+    @returns the Arena active in the current thread, or NULL if Components and DataPaths are currently allocated from the heap.
+    @see ArenaScope
+    */
+    static Arena* GetActive();
+    /**
+    Finds the Arena whose memory contains the given address, e.g. the Arena an attribute value was allocated from. Looks the address up among the registered chunks of all Arenas (under a lock); the Arena of a Component or DataPath is known without a lookup (see AttributeStore::GetArena()).
+    @return the Arena, or NULL if the address does not lie in any Arena (e.g. an object on the heap or on the stack)
+    */
+    static Arena* FindOwner(const void* ptr);
+
+    /// @private
+    static void* AllocateObject(size_t size, int kind);
+    /// @private
+    static Arena* TakeObjectOwner(const void* obj);
+    /// @private
+    static void SetReleasedObject(void* obj, Arena* owner);
+    /// @private
+    static void ReleaseObject(void* ptr, size_t size, int kind);
+
+private:
+    void NewChunk(size_t min_size);
+    char* NewRegisteredChunk(size_t size);
+    void* AllocateSlot(size_t size, int kind);
+    void Release(void* obj, size_t size, int kind);
+
+    size_t chunk_size; /**< Size of a regular chunk (in Bytes). */
+    vector<char*> chunks; /**< All chunks reserved by the Arena. */
+    char* cur { nullptr }; /**< Next free Byte in the current chunk. */
+    char* end { nullptr }; /**< End of the current chunk. */
+    size_t allocated_bytes { 0 }; /**< Bytes handed out so far. */
+    size_t reserved_bytes { 0 }; /**< Bytes reserved in chunks. */
+    size_t live_objects { 0 }; /**< Number of Components and DataPaths not deleted yet. */
+    vector<uintptr_t> objects; /**< Every slot of a Component or DataPath allocated from the Arena (object pointer | kind bit); a reused slot is listed once. */
+    unordered_map<size_t, vector<void*>> free_slots[2]; /**< Per kind of object (Component, DataPath): object size -> slots of deleted objects. */
+    size_t num_free_slots { 0 }; /**< Number of slots in free_slots. */
+    size_t reserved_objects { 0 }; /**< Number of the next objects of reserved_object_size Bytes which bypass free_slots (see ReserveObjects()). */
+    size_t reserved_object_size { 0 }; /**< Size of the objects reserved by ReserveObjects(). */
+    unordered_set<void*>* dead_objects { nullptr }; /**< Slots not to be destroyed; only used while the Arena is being destroyed. */
+    vector<pair<void*, void(*)(void*)>> finalizers; /**< Objects created by New() that need their destructor called. */
+
+    static thread_local Arena* active; /**< Arena active in the current thread. */
+    static thread_local void* last_object; /**< The last object allocated by AllocateObject() in the current thread, until its constructor takes its owner. */
+    static thread_local Arena* last_object_owner; /**< Arena of last_object; NULL for the heap. */
+    static thread_local void* released_object; /**< The last Component or DataPath destroyed in the current thread, whose memory is released next. */
+    static thread_local Arena* released_object_owner; /**< Arena of released_object; NULL for the heap. */
+    friend class ArenaScope;
+};
+
+/**
+Class ArenaScope - activates an Arena in the current thread for its lifetime (RAII). While the scope exists, Components and DataPaths created with new are allocated from the Arena. Scopes can be nested; the previously active Arena is restored when the scope ends.
+\n Constructing a scope with a NULL Arena keeps the currently active Arena (if any).
+*/
+class ArenaScope {
+public:
+    /**
+    @param arena - the Arena to activate (or NULL to keep the current state)
+    */
+    ArenaScope(Arena* arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+private:
+    Arena* previous; /**< Arena active before this scope. */
+};
+
+template <typename T, typename... Args> T* Arena::New(Args&&... args)
+{
+    T* obj = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+        finalizers.push_back({(void*)obj, [](void* p){ ((T*)p)->~T(); }});
+    return obj;
+}
+
+#endif
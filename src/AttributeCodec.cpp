@@ -0,0 +1,200 @@
+#include "AttributeCodec.hpp"
+
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+AttributeCodecRegistry::AttributeCodecRegistry(AttributeCodecRegistry* _parent) : parent(_parent) {}
+
+AttributeCodecRegistry::Codec* AttributeCodecRegistry::GetCodec(AttributeKey key, const std::type_info* type)
+{
+    Codec& c = codecs[key.name];
+    if(c.type == NULL || *c.type != *type)
+        c = Codec { type, NULL, NULL, NULL, NULL };
+    return &c;
+}
+
+//the codec of the name in this registry; NULL if there is none or the value (of a known type) has a different type
+AttributeCodecRegistry::Codec* AttributeCodecRegistry::FindCodec(const string* key, const std::type_info* type)
+{
+    if(codecs.empty())
+        return NULL;
+    auto it = codecs.find(key);
+    if(it == codecs.end())
+        return NULL;
+    if(type != NULL && *type != *it->second.type)
+        return NULL;
+    return &it->second;
+}
+
+void AttributeCodecRegistry::Remove(AttributeKey key)
+{
+    codecs.erase(key.name);
+}
+
+void AttributeCodecRegistry::SetFallbackEncoders(std::function<int(string,void*,string*)> encode, std::function<int(string,void*,xmlNodePtr)> encode_xml)
+{
+    encode_fallback = encode;
+    encode_xml_fallback = encode_xml;
+}
+
+void AttributeCodecRegistry::SetFallbackDecoders(std::function<int(string,string,AttributeStore*)> decode, std::function<int(string,xmlNodePtr,AttributeStore*)> decode_xml)
+{
+    decode_fallback = decode;
+    decode_xml_fallback = decode_xml;
+}
+
+bool AttributeCodecRegistry::Encode(const AttributeStore::Entry& entry, string* out)
+{
+    for(AttributeCodecRegistry* r = this; r != NULL; r = r->parent)
+    {
+        Codec* c = r->FindCodec(entry.key, entry.type);
+        if(c != NULL)
+            return c->encode != NULL && c->encode(entry.value, out);
+        if(r->encode_fallback != NULL && r->encode_fallback(*entry.key, entry.value, out) == 1)
+            return true;
+    }
+    return false;
+}
+
+bool AttributeCodecRegistry::EncodeXml(const AttributeStore::Entry& entry, xmlNodePtr n)
+{
+    for(AttributeCodecRegistry* r = this; r != NULL; r = r->parent)
+    {
+        Codec* c = r->FindCodec(entry.key, entry.type);
+        if(c != NULL)
+        {
+            if(c->encode_xml == NULL)
+                return false;
+            xmlNodePtr attrib_node = xmlNewChild(n, NULL, BAD_CAST "Attribute", NULL);
+            xmlNewProp(attrib_node, BAD_CAST "name", BAD_CAST entry.key->c_str());
+            c->encode_xml(entry.value, attrib_node);
+            return true;
+        }
+        if(r->encode_xml_fallback != NULL && r->encode_xml_fallback(*entry.key, entry.value, n) == 1)
+            return true;
+    }
+    return false;
+}
+
+bool AttributeCodecRegistry::Decode(AttributeKey key, const string& value, AttributeStore* attrib)
+{
+    for(AttributeCodecRegistry* r = this; r != NULL; r = r->parent)
+    {
+        Codec* c = r->FindCodec(key.name, NULL);
+        if(c != NULL)
+            return c->decode != NULL && c->decode(value, key, attrib);
+        if(r->decode_fallback != NULL && r->decode_fallback(key.GetName(), value, attrib) == 1)
+            return true;
+    }
+    return false;
+}
+
+bool AttributeCodecRegistry::DecodeXml(AttributeKey key, xmlNodePtr n, AttributeStore* attrib)
+{
+    for(AttributeCodecRegistry* r = this; r != NULL; r = r->parent)
+    {
+        Codec* c = r->FindCodec(key.name, NULL);
+        if(c != NULL)
+            return c->decode_xml != NULL && c->decode_xml(n, key, attrib);
+        if(r->decode_xml_fallback != NULL && r->decode_xml_fallback(key.GetName(), n, attrib) == 1)
+            return true;
+    }
+    return false;
+}
+
+static bool GetXmlProp(xmlNodePtr n, const char* name, string* out)
+{
+    xmlChar* value = xmlGetProp(n, BAD_CAST name);
+    if(value == NULL)
+        return false;
+    *out = (const char*)value;
+    xmlFree(value);
+    return true;
+}
+
+//registers a text codec writing the value with std::to_string and parsing it with parse
+template <typename T> static void RegisterNumber(AttributeCodecRegistry* r, const char* key, T (*parse)(const string&))
+{
+    r->Register<T>(AttributeKey(key), [](const T& v){ return std::to_string(v); }, [parse](const string& s, T* v){ *v = parse(s); return true; });
+}
+
+//codecs of the attributes used by sys-sage
+static void RegisterDefaultCodecs(AttributeCodecRegistry* r)
+{
+    //value: uint64_t
+    for(const char* key : {"CATcos", "CATL3mask"})
+        RegisterNumber<uint64_t>(r, key, [](const string& s){ return (uint64_t)strtoull(s.c_str(), NULL, 10); });
+    //value: long long
+    RegisterNumber<long long>(r, "mig_size", [](const string& s){ return strtoll(s.c_str(), NULL, 10); });
+    //value: int
+    for(const char* key : {"Number_of_streaming_multiprocessors", "Number_of_cores_in_GPU", "Number_of_cores_per_SM", "Bus_Width_bit"})
+        RegisterNumber<int>(r, key, [](const string& s){ return (int)strtol(s.c_str(), NULL, 10); });
+    //value: double
+    RegisterNumber<double>(r, "Clock_Frequency", [](const string& s){ return strtod(s.c_str(), NULL); });
+    //value: float
+    for(const char* key : {"latency", "latency_min", "latency_max"})
+        RegisterNumber<float>(r, key, [](const string& s){ return strtof(s.c_str(), NULL); });
+    //value: string
+    for(const char* key : {"CUDA_compute_capability", "mig_uuid"})
+        r->Register<string>(AttributeKey(key), [](const string& v){ return v; }, [](const string& s, string* v){ *v = s; return true; });
+
+    //value: std::vector<std::tuple<long long,double>>
+    using FreqHistory = std::vector<std::tuple<long long,double>>;
+    r->RegisterXml<FreqHistory>(AttributeKey("freq_history"),
+        [](const FreqHistory& val, xmlNodePtr n)
+        {
+            for(auto [ ts,freq ] : val)
+            {
+                xmlNodePtr attrib = xmlNewChild(n, NULL, BAD_CAST "freq_history", NULL);
+                xmlNewProp(attrib, BAD_CAST "timestamp", BAD_CAST std::to_string(ts).c_str());
+                xmlNewProp(attrib, BAD_CAST "frequency", BAD_CAST std::to_string(freq).c_str());
+                xmlNewProp(attrib, BAD_CAST "unit", BAD_CAST "MHz");
+            }
+        },
+        [](xmlNodePtr n, FreqHistory* val)
+        {
+            for(xmlNodePtr c = n->children; c != NULL; c = c->next)
+            {
+                string ts, freq;
+                if(c->type == XML_ELEMENT_NODE && GetXmlProp(c, "timestamp", &ts) && GetXmlProp(c, "frequency", &freq))
+                    val->emplace_back(strtoll(ts.c_str(), NULL, 10), strtod(freq.c_str(), NULL));
+            }
+            return true;
+        });
+    //value: std::tuple<double, std::string>
+    using ClockRate = std::tuple<double, std::string>;
+    r->RegisterXml<ClockRate>(AttributeKey("GPU_Clock_Rate"),
+        [](const ClockRate& val, xmlNodePtr n)
+        {
+            auto [ freq, unit ] = val;
+            xmlNodePtr attrib = xmlNewChild(n, NULL, BAD_CAST "GPU_Clock_Rate", NULL);
+            xmlNewProp(attrib, BAD_CAST "frequency", BAD_CAST std::to_string(freq).c_str());
+            xmlNewProp(attrib, BAD_CAST "unit", BAD_CAST unit.c_str());
+        },
+        [](xmlNodePtr n, ClockRate* val)
+        {
+            for(xmlNodePtr c = n->children; c != NULL; c = c->next)
+            {
+                string freq, unit;
+                if(c->type == XML_ELEMENT_NODE && GetXmlProp(c, "frequency", &freq))
+                {
+                    GetXmlProp(c, "unit", &unit);
+                    *val = ClockRate(strtod(freq.c_str(), NULL), unit);
+                    return true;
+                }
+            }
+            return false;
+        });
+}
+
+AttributeCodecRegistry* AttributeCodecRegistry::GetDefault()
+{
+    static AttributeCodecRegistry* registry = []()
+    {
+        AttributeCodecRegistry* r = new AttributeCodecRegistry(NULL);
+        RegisterDefaultCodecs(r);
+        return r;
+    }();
+    return registry;
+}
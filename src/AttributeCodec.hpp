@@ -0,0 +1,153 @@
+#ifndef ATTRIBUTE_CODEC
+#define ATTRIBUTE_CODEC
+
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <typeinfo>
+#include <utility>
+
+#include <libxml/tree.h>
+
+#include "AttributeStore.hpp"
+
+using namespace std;
+
+/**
+Class AttributeCodecRegistry - maps attribute names to the functions which serialize (encode) and deserialize (decode) their values. It is used by exportToXml(), exportToXmlShards(), importFromXml(), importXmlShard() and exportToBinary(), which take the registry of one export/import as a parameter.
+\n The codec of an attribute name (an interned AttributeKey) is typed: it only handles values stored with Set<T>() of its type T (and values of unknown type, stored through the std::map-like interface of AttributeStore). It consists of
+\n - a text encoder/decoder (see Register()), for attributes written as a single string, e.g. <Attribute name="..." value="..."/> in XML or a string in a binary format, and/or
+\n - an XML encoder/decoder (see RegisterXml()), for attributes written as child elements of <Attribute name="...">.
+\n Codecs are found by a hash lookup of the interned key. Attributes without a codec in a registry are passed to its fallback functions (see SetFallbackEncoders(), SetFallbackDecoders()) and then looked up in its parent registry; a codec in the registry hides the codec of the same name in the parent. The default parent is GetDefault(), which contains the codecs of the attributes used by sys-sage.
+\n A registry is not synchronized: register the codecs before using it; concurrent exports and imports may share a registry which is not modified.
+*/
+class AttributeCodecRegistry {
+public:
+    /**
+    Creates an empty registry.
+    @param _parent - registry to look up attributes which do not have a codec in this one (default: GetDefault()); NULL for none
+    */
+    AttributeCodecRegistry(AttributeCodecRegistry* _parent = GetDefault());
+
+    /**
+    Registers a text codec for an attribute name (replaces a previous one; the XML codec of the name is kept if it has the same type).
+    @param key - attribute name
+    @param encode - returns the string representation of a value
+    @param decode - parses a string representation into the output parameter; returns false if it is not valid
+    */
+    template <typename T> void Register(AttributeKey key, std::function<string(const T&)> encode, std::function<bool(const string&, T*)> decode);
+    /**
+    Registers an XML codec for an attribute name (replaces a previous one; the text codec of the name is kept if it has the same type).
+    @param key - attribute name
+    @param encode - adds the child elements representing a value to the <Attribute name="..."> element n
+    @param decode - parses the <Attribute name="..."> element n into the output parameter; returns false if it is not valid
+    */
+    template <typename T> void RegisterXml(AttributeKey key, std::function<void(const T&, xmlNodePtr n)> encode, std::function<bool(xmlNodePtr n, T*)> decode);
+    /**
+    Removes the codecs of an attribute name (which makes the codecs of the parent visible again).
+    */
+    void Remove(AttributeKey key);
+
+    /**
+    Sets functions which encode attributes without a codec in this registry (before the parent is asked). They have the interface of the search_custom_*_fcn parameters of exportToXml(): they are called with the attribute name and a pointer to the value, and return 1 if they have encoded it, 0 otherwise.
+    @param encode - (optional) stores the string representation of the value in the output parameter
+    @param encode_xml - (optional) adds an <Attribute name="..."> element representing the value to the given element
+    */
+    void SetFallbackEncoders(std::function<int(string,void*,string*)> encode, std::function<int(string,void*,xmlNodePtr)> encode_xml);
+    /**
+    Sets functions which decode attributes without a codec in this registry (before the parent is asked). They have the interface of the search_custom_*_fcn parameters of importFromXml(): they are called with the attribute name, its string representation (or the <Attribute> element) and the AttributeStore to store it in, and return 1 if they have stored the attribute, 0 otherwise.
+    */
+    void SetFallbackDecoders(std::function<int(string,string,AttributeStore*)> decode, std::function<int(string,xmlNodePtr,AttributeStore*)> decode_xml);
+
+    /**
+    Encodes an attribute by its text codec.
+    @param entry - the attribute (see AttributeStore::iterator::GetEntry())
+    @param out - output parameter, the string representation of the value
+    @return true if the attribute was encoded
+    */
+    bool Encode(const AttributeStore::Entry& entry, string* out);
+    /**
+    Encodes an attribute by its XML codec: adds an <Attribute name="..."> element with the child elements representing the value to n.
+    @return true if the attribute was encoded
+    */
+    bool EncodeXml(const AttributeStore::Entry& entry, xmlNodePtr n);
+    /**
+    Decodes an attribute from its string representation by its text codec and stores it in attrib.
+    @return true if the attribute was stored
+    */
+    bool Decode(AttributeKey key, const string& value, AttributeStore* attrib);
+    /**
+    Decodes an attribute from its <Attribute name="..."> element n by its XML codec and stores it in attrib.
+    @return true if the attribute was stored
+    */
+    bool DecodeXml(AttributeKey key, xmlNodePtr n, AttributeStore* attrib);
+
+    /**
+    @returns the registry with the codecs of the attributes used by sys-sage (e.g. CATcos, mig_size, freq_history, GPU_Clock_Rate; see search_default_attrib_key()). It has no parent.
+    */
+    static AttributeCodecRegistry* GetDefault();
+
+private:
+    /**
+    Type-erased codec of one attribute name.
+    */
+    struct Codec {
+        const std::type_info* type;
+        std::function<bool(void*, string*)> encode;
+        std::function<bool(const string&, AttributeKey, AttributeStore*)> decode;
+        std::function<void(void*, xmlNodePtr)> encode_xml;
+        std::function<bool(xmlNodePtr, AttributeKey, AttributeStore*)> decode_xml;
+    };
+
+    Codec* GetCodec(AttributeKey key, const std::type_info* type);
+    Codec* FindCodec(const string* key, const std::type_info* type);
+
+    unordered_map<const string*, Codec> codecs; /**< Codecs by the interned attribute name. */
+    AttributeCodecRegistry* parent;
+    std::function<int(string,void*,string*)> encode_fallback;
+    std::function<int(string,void*,xmlNodePtr)> encode_xml_fallback;
+    std::function<int(string,string,AttributeStore*)> decode_fallback;
+    std::function<int(string,xmlNodePtr,AttributeStore*)> decode_xml_fallback;
+};
+
+template <typename T> void AttributeCodecRegistry::Register(AttributeKey key, std::function<string(const T&)> encode, std::function<bool(const string&, T*)> decode)
+{
+    Codec* c = GetCodec(key, &typeid(T));
+    c->encode = NULL;
+    c->decode = NULL;
+    if(encode != NULL)
+        c->encode = [encode](void* value, string* out){ *out = encode(*(T*)value); return true; };
+    if(decode != NULL)
+    {
+        c->decode = [decode](const string& value, AttributeKey k, AttributeStore* attrib)
+        {
+            T v {};
+            if(!decode(value, &v))
+                return false;
+            attrib->Set<T>(k, std::move(v));
+            return true;
+        };
+    }
+}
+
+template <typename T> void AttributeCodecRegistry::RegisterXml(AttributeKey key, std::function<void(const T&, xmlNodePtr n)> encode, std::function<bool(xmlNodePtr n, T*)> decode)
+{
+    Codec* c = GetCodec(key, &typeid(T));
+    c->encode_xml = NULL;
+    c->decode_xml = NULL;
+    if(encode != NULL)
+        c->encode_xml = [encode](void* value, xmlNodePtr n){ encode(*(T*)value, n); };
+    if(decode != NULL)
+    {
+        c->decode_xml = [decode](xmlNodePtr n, AttributeKey k, AttributeStore* attrib)
+        {
+            T v {};
+            if(!decode(n, &v))
+                return false;
+            attrib->Set<T>(k, std::move(v));
+            return true;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "AttributeStore.hpp"
+
+#include <unordered_set>
+#include <mutex>
+#include <algorithm>
+
+AttributeKey::AttributeKey(string_view _name)
+{
+    //function-local statics, so that keys can be created during static initialization
+    static mutex intern_mutex;
+    static unordered_set<string> intern_table;
+    lock_guard<mutex> lock(intern_mutex);
+    //elements of an unordered_set do not move on rehash, so the pointer stays valid
+    name = &*intern_table.emplace(_name).first;
+}
+
+const string& AttributeKey::GetName() const
+{
+    static const string empty;
+    return name == NULL ? empty : *name;
+}
+
+AttributeStore::~AttributeStore()
+{
+    for(Entry& e : entries)
+        Release(e);
+}
+
+void AttributeStore::Release(Entry& entry)
+{
+    if(entry.destroy != NULL)
+        entry.destroy(entry.value);
+    entry.destroy = NULL;
+}
+
+int AttributeStore::FindEntry(const string* key)
+{
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        if(entries[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+int AttributeStore::FindEntry(string_view key)
+{
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        if(*entries[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+int AttributeStore::InsertEntry(const string* key)
+{
+    //keep the entries sorted by name -- the iteration order of the previously used std::map
+    auto pos = std::lower_bound(entries.begin(), entries.end(), *key, [](const Entry& e, const string& k){ return *e.key < k; });
+    pos = entries.insert(pos, Entry{key, NULL, NULL, NULL});
+    return pos - entries.begin();
+}
+
+bool AttributeStore::Has(string_view key){return FindEntry(key) >= 0;}
+
+bool AttributeStore::FormatValue(const Entry& entry, string* out)
+{
+    const std::type_info* t = entry.type;
+    if(t == NULL)
+        return false;
+    if(*t == typeid(int))
+        *out = std::to_string(*(int*)entry.value);
+    else if(*t == typeid(unsigned))
+        *out = std::to_string(*(unsigned*)entry.value);
+    else if(*t == typeid(long))
+        *out = std::to_string(*(long*)entry.value);
+    else if(*t == typeid(unsigned long))
+        *out = std::to_string(*(unsigned long*)entry.value);
+    else if(*t == typeid(long long))
+        *out = std::to_string(*(long long*)entry.value);
+    else if(*t == typeid(unsigned long long))
+        *out = std::to_string(*(unsigned long long*)entry.value);
+    else if(*t == typeid(float))
+        *out = std::to_string(*(float*)entry.value);
+    else if(*t == typeid(double))
+        *out = std::to_string(*(double*)entry.value);
+    else if(*t == typeid(bool))
+        *out = *(bool*)entry.value ? "true" : "false";
+    else if(*t == typeid(string))
+        *out = *(string*)entry.value;
+    else
+        return false;
+    return true;
+}
+
+AttributeStore::Ref AttributeStore::operator[](string_view key)
+{
+    int idx = FindEntry(key);
+    if(idx < 0)
+        idx = InsertEntry(AttributeKey(key).name);
+    return Ref(this, idx);
+}
+
+pair<AttributeStore::iterator, bool> AttributeStore::insert(const pair<string, void*>& attribute)
+{
+    int idx = FindEntry(attribute.first);
+    if(idx >= 0)
+        return {iterator(entries.begin() + idx), false};
+    idx = InsertEntry(AttributeKey(attribute.first).name);
+    entries[idx].value = attribute.second;
+    return {iterator(entries.begin() + idx), true};
+}
+
+AttributeStore::iterator AttributeStore::find(string_view key)
+{
+    int idx = FindEntry(key);
+    if(idx < 0)
+        return end();
+    return iterator(entries.begin() + idx);
+}
+
+size_t AttributeStore::count(string_view key){return FindEntry(key) >= 0 ? 1 : 0;}
+
+size_t AttributeStore::erase(string_view key)
+{
+    int idx = FindEntry(key);
+    if(idx < 0)
+        return 0;
+    Release(entries[idx]);
+    entries.erase(entries.begin() + idx);
+    return 1;
+}
+
+void AttributeStore::clear()
+{
+    for(Entry& e : entries)
+        Release(e);
+    entries.clear();
+}
@@ -0,0 +1,266 @@
+#ifndef ATTRIBUTE_STORE
+#define ATTRIBUTE_STORE
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <typeinfo>
+#include <type_traits>
+#include <new>
+#include <optional>
+
+#include "Arena.hpp"
+
+using namespace std;
+
+/**
+Class AttributeKey - an interned attribute name.
+\n All AttributeKeys created from the same name share one copy of the string, so that two keys are compared by a pointer comparison. Creating a key looks the name up in a global (thread-safe) table; keys used on a hot path should therefore be created once and reused, e.g. static AttributeKey freq_key("freq_history");
+*/
+class AttributeKey {
+public:
+    AttributeKey() = default;
+    /**
+    Interns the name (if not interned yet) and creates a key referring to it.
+    @param _name - the attribute name
+    */
+    explicit AttributeKey(string_view _name);
+    /**
+    @returns the attribute name
+    */
+    const string& GetName() const;
+    bool operator==(const AttributeKey& other) const { return name == other.name; }
+private:
+    const string* name { nullptr }; /**< Pointer to the interned name. */
+    friend class AttributeStore;
+    friend class AttributeCodecRegistry;
+};
+
+/**
+Class AttributeStore - the container of attributes of a Component or a DataPath (Component::attrib, DataPath::attrib).
+\n It is a small flat map from interned keys (see AttributeKey) to values. The typed methods Set<T>() and Get<T>() store an owned copy of the value (destroyed when it is overwritten, erased, or when the store is destroyed) together with its type, and return it only when the requested type matches. The values stored by Set<T>() are allocated from the Arena of the Component or DataPath the store belongs to (see GetArena()), so that they live as long as the store; the values of a store outside of any Arena are allocated from the heap, regardless of the active Arena.
+\n For compatibility, the store also provides the interface of the previously used std::map<string,void*>: operator[], insert(), find(), count(), erase(), iteration over (name, void*) pairs in the order of the names, etc. Values stored through this interface are raw pointers which are not owned by the store (the caller remains responsible for them), and their type is unknown.
+*/
+class AttributeStore {
+public:
+    /**
+    One attribute.
+    */
+    struct Entry {
+        const string* key; /**< Interned attribute name. */
+        void* value; /**< Pointer to the value. */
+        void (*destroy)(void*); /**< Destroys an owned value; NULL if the value is not owned by the store. */
+        const std::type_info* type; /**< Type of the value; NULL if unknown (values stored through the std::map-like interface). */
+    };
+
+    /**
+    Reference to the value of an attribute, returned by operator[]. Converts to any pointer type (as the void* stored in the previously used std::map did); assigning a pointer stores it as a non-owned value of unknown type.
+    */
+    class Ref {
+    public:
+        Ref(AttributeStore* _store, size_t _idx) : store(_store), idx(_idx) {}
+        template <typename T> operator T*() const { return (T*)store->entries[idx].value; }
+        Ref& operator=(void* value)
+        {
+            Entry& e = store->entries[idx];
+            Release(e);
+            e.value = value;
+            e.type = NULL;
+            return *this;
+        }
+    private:
+        AttributeStore* store;
+        size_t idx;
+    };
+
+    /**
+    Iterator over the attributes, ordered by their names. Dereferences to a pair (name, void* value), as the iterator of std::map<string,void*>; e.g. for(auto& [name, value] : c->attrib) works as before.
+    \n The value pointer is read-only (the type and ownership of the value are kept in the entry); replace a value through operator[] or Set<T>().
+    \n The pair (of references to the name and the value) is kept in the iterator, so a reference to it is only valid until the iterator is advanced or destroyed.
+    */
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = pair<const string&, void* const>;
+        using reference = value_type&;
+        using pointer = value_type*;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(vector<Entry>::iterator _it) : it(_it) {}
+        iterator(const iterator& other) : it(other.it) {}
+        iterator& operator=(const iterator& other) { it = other.it; current.reset(); return *this; }
+        reference operator*() const { current.emplace(*it->key, it->value); return *current; }
+        pointer operator->() const { return &**this; }
+        iterator& operator++() { ++it; return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++it; return tmp; }
+        bool operator==(const iterator& other) const { return it == other.it; }
+        /**
+        @returns the underlying entry (with the type and ownership of the value)
+        */
+        Entry& GetEntry() const { return *it; }
+    private:
+        vector<Entry>::iterator it;
+        mutable std::optional<value_type> current; /**< The pair returned by the last dereference. */
+    };
+
+    AttributeStore() = default;
+    /**
+    Creates a store whose typed values are allocated from the given Arena (used by Component and DataPath, see Arena::TakeObjectOwner()).
+    @param _arena - the Arena; NULL for the heap
+    */
+    explicit AttributeStore(Arena* _arena) : arena(_arena) {}
+    /**
+    Destroys all owned values.
+    */
+    ~AttributeStore();
+    AttributeStore(const AttributeStore&) = delete;
+    AttributeStore& operator=(const AttributeStore&) = delete;
+
+    /**
+    Stores a copy of value under the given key, owned by the store. A previous owned value of the same type is assigned in place (the pointer to it stays valid); any other previous value with the same key is destroyed (if owned) and replaced.
+    @return pointer to the stored value (valid until the value is replaced by a value of another type or erased)
+    */
+    template <typename T> T* Set(AttributeKey key, T value);
+    /**
+    @see Set(AttributeKey key, T value)
+    */
+    template <typename T> T* Set(string_view key, T value) { return Set<T>(AttributeKey(key), std::move(value)); }
+    /**
+    Stores a string (the C-string is copied into a std::string).
+    */
+    string* Set(string_view key, const char* value) { return Set<string>(AttributeKey(key), string(value)); }
+    /**
+    Retrieves the value stored under the given key.
+    \n Values stored by Set<T>() are only returned if T matches their type exactly; values of unknown type (stored through the std::map-like interface) are returned retyped to T*, as before.
+    @return pointer to the value, or NULL if there is no such attribute (or the type does not match)
+    */
+    template <typename T> T* Get(AttributeKey key);
+    /**
+    @see Get(AttributeKey key)
+    */
+    template <typename T> T* Get(string_view key);
+    /**
+    @return true if an attribute with the given name exists
+    */
+    bool Has(string_view key);
+
+    /**
+    Converts a value of a known basic type (integer types, float, double, bool, std::string) to a string.
+    @param entry - the attribute
+    @param out - output parameter, the string representation of the value
+    @return true if the value was converted; false if its type is unknown or not basic
+    */
+    static bool FormatValue(const Entry& entry, string* out);
+
+    /**
+    std::map-like access: returns a reference to the value (a new attribute with a NULL value is inserted if it does not exist).
+    */
+    Ref operator[](string_view key);
+    /**
+    std::map-like insertion of a non-owned raw pointer. Nothing is changed if the attribute already exists.
+    @return iterator to the attribute and true if it was inserted
+    */
+    pair<iterator, bool> insert(const pair<string, void*>& attribute);
+    /**
+    std::map-like lookup.
+    @return iterator to the attribute, or end()
+    */
+    iterator find(string_view key);
+    /**
+    @return 1 if an attribute with the given name exists, otherwise 0
+    */
+    size_t count(string_view key);
+    /**
+    Removes an attribute (destroys its value if owned).
+    @return number of removed attributes (0 or 1)
+    */
+    size_t erase(string_view key);
+    /**
+    Removes all attributes (destroys the owned values).
+    */
+    void clear();
+    iterator begin() { return iterator(entries.begin()); }
+    iterator end() { return iterator(entries.end()); }
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    /**
+    @returns the Arena the typed values are allocated from, i.e. the Arena of the Component or DataPath the store belongs to; NULL if they are allocated from the heap
+    */
+    Arena* GetArena() const { return arena; }
+
+private:
+    int FindEntry(const string* key);
+    int FindEntry(string_view key);
+    int InsertEntry(const string* key);
+    template <typename T> static T* Cast(Entry& entry);
+    static void Release(Entry& entry);
+
+    vector<Entry> entries; /**< Attributes sorted by name. */
+    Arena* arena { nullptr }; /**< Arena of the owner of the store; NULL for the heap. */
+};
+
+template <typename T> T* AttributeStore::Set(AttributeKey key, T value)
+{
+    int idx = FindEntry(key.name);
+    if constexpr (std::is_move_assignable_v<T>)
+    {
+        //an owned value of the same type is assigned in place: no new memory is taken from the Arena on every refresh
+        if(idx >= 0 && entries[idx].destroy != NULL && entries[idx].type != NULL && *entries[idx].type == typeid(T))
+        {
+            *(T*)entries[idx].value = std::move(value);
+            return (T*)entries[idx].value;
+        }
+    }
+
+    T* obj;
+    void (*destroy)(void*);
+    //not the active Arena: a store on the heap may outlive it
+    if(arena != NULL)
+    {
+        //the memory is released with the Arena, only the destructor is called by the store
+        obj = new (arena->Allocate(sizeof(T), alignof(T))) T(std::move(value));
+        destroy = [](void* p){ ((T*)p)->~T(); };
+    }
+    else
+    {
+        obj = new T(std::move(value));
+        destroy = [](void* p){ delete (T*)p; };
+    }
+
+    if(idx < 0)
+        idx = InsertEntry(key.name);
+    else
+        Release(entries[idx]);
+    Entry& e = entries[idx];
+    e.value = (void*)obj;
+    e.destroy = destroy;
+    e.type = &typeid(T);
+    return obj;
+}
+
+template <typename T> T* AttributeStore::Cast(Entry& entry)
+{
+    if(entry.type != NULL && entry.type != &typeid(T) && *entry.type != typeid(T))
+        return NULL;
+    return (T*)entry.value;
+}
+
+template <typename T> T* AttributeStore::Get(AttributeKey key)
+{
+    int idx = FindEntry(key.name);
+    if(idx < 0)
+        return NULL;
+    return Cast<T>(entries[idx]);
+}
+
+template <typename T> T* AttributeStore::Get(string_view key)
+{
+    int idx = FindEntry(key);
+    if(idx < 0)
+        return NULL;
+    return Cast<T>(entries[idx]);
+}
+
+#endif
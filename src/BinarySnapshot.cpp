@@ -0,0 +1,466 @@
+#include "BinarySnapshot.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TopologyView.hpp"
+#include "AttributeCodec.hpp"
+
+//string pool of a snapshot under construction; equal strings are stored once
+struct SnapshotStrings {
+    string pool { string(1, '\0') };
+    unordered_map<string, uint32_t> offsets { {"", 0} };
+
+    uint32_t Add(const string& s)
+    {
+        auto it = offsets.find(s);
+        if(it != offsets.end())
+            return it->second;
+        uint32_t offset = pool.size();
+        pool.append(s.c_str(), s.size() + 1);
+        offsets[s] = offset;
+        return offset;
+    }
+};
+
+//appends the attributes of a store to the attribute pool; returns the number of appended attributes
+static uint32_t AddSnapshotAttributes(AttributeStore& attrib, SnapshotStrings& strings, vector<BinarySnapshotAttribute>& out, AttributeCodecRegistry* codecs)
+{
+    uint32_t num = 0;
+    for(auto it = attrib.begin(); it != attrib.end(); ++it)
+    {
+        AttributeStore::Entry& e = it.GetEntry();
+        const std::type_info* t = e.type;
+        BinarySnapshotAttribute a {};
+        string str;
+        if(t == NULL)
+        {
+            //value of unknown type; only attributes with a text codec can be written
+            if(!codecs->Encode(e, &str))
+                continue;
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_STRING;
+        }
+        else if(*t == typeid(int))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_INT, a.value.i = *(int*)e.value;
+        else if(*t == typeid(long))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_INT, a.value.i = *(long*)e.value;
+        else if(*t == typeid(long long))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_INT, a.value.i = *(long long*)e.value;
+        else if(*t == typeid(unsigned))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_UINT, a.value.u = *(unsigned*)e.value;
+        else if(*t == typeid(unsigned long))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_UINT, a.value.u = *(unsigned long*)e.value;
+        else if(*t == typeid(unsigned long long))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_UINT, a.value.u = *(unsigned long long*)e.value;
+        else if(*t == typeid(bool))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_UINT, a.value.u = *(bool*)e.value;
+        else if(*t == typeid(float))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_DOUBLE, a.value.d = *(float*)e.value;
+        else if(*t == typeid(double))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_DOUBLE, a.value.d = *(double*)e.value;
+        else if(*t == typeid(string))
+        {
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_STRING;
+            str = *(string*)e.value;
+        }
+        else if(codecs->Encode(e, &str))
+            a.kind = SYS_SAGE_SNAPSHOT_ATTRIB_STRING;
+        else
+            continue;
+        if(a.kind == SYS_SAGE_SNAPSHOT_ATTRIB_STRING)
+        {
+            a.value.s.offset = strings.Add(str);
+            a.value.s.length = str.size();
+        }
+        a.key = strings.Add(*e.key);
+        out.push_back(a);
+        num++;
+    }
+    return num;
+}
+
+//appends a table to the file contents at the next aligned offset; returns the offset
+template <typename T> static uint64_t AppendTable(string& file, const T* table, size_t count)
+{
+    file.resize((file.size() + SYS_SAGE_SNAPSHOT_ALIGNMENT - 1) / SYS_SAGE_SNAPSHOT_ALIGNMENT * SYS_SAGE_SNAPSHOT_ALIGNMENT, '\0');
+    uint64_t offset = file.size();
+    file.append((const char*)table, count * sizeof(T));
+    return offset;
+}
+
+int exportToBinary(Component* root, string path, AttributeCodecRegistry* codecs)
+{
+    if(codecs == NULL)
+        codecs = AttributeCodecRegistry::GetDefault();
+    TopologyView view(root);
+    int n = view.GetNumComponents();
+
+    //DataPaths with both endpoints in the subtree, each once
+    vector<DataPath*> dps;
+    unordered_set<DataPath*> seen;
+    for(int i = 0; i < n; i++)
+    {
+        for(DataPath* dp : view.GetComponent(i)->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING))
+        {
+            if(seen.insert(dp).second && view.GetIndex(dp->GetSource()) >= 0 && view.GetIndex(dp->GetTarget()) >= 0)
+                dps.push_back(dp);
+        }
+    }
+    vector<vector<uint32_t>> out(n), in(n);
+    for(size_t k = 0; k < dps.size(); k++)
+    {
+        int src = view.GetIndex(dps[k]->GetSource());
+        int dst = view.GetIndex(dps[k]->GetTarget());
+        if(dps[k]->GetOriented() == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        {
+            out[src].push_back(k);
+            in[src].push_back(k);
+            if(dst != src)
+            {
+                out[dst].push_back(k);
+                in[dst].push_back(k);
+            }
+        }
+        else
+        {
+            out[src].push_back(k);
+            in[dst].push_back(k);
+        }
+    }
+
+    SnapshotStrings strings;
+    vector<BinarySnapshotAttribute> attributes;
+    vector<BinarySnapshotComponent> components(n);
+    vector<uint32_t> outgoing, incoming;
+    uint32_t threads = 0;
+    for(int i = 0; i < n; i++)
+    {
+        Component* c = view.GetComponent(i);
+        BinarySnapshotComponent& e = components[i];
+        e.componentType = view.GetComponentType(i);
+        e.id = view.GetId(i);
+        e.parent = view.GetParentIndex(i);
+        e.firstChild = view.GetFirstChildIndex(i);
+        e.nextSibling = view.GetNextSiblingIndex(i);
+        e.subtreeEnd = view.GetSubtreeEnd(i);
+        e.depth = view.GetDepth(i);
+        e.count = c->GetCount();
+        e.name = strings.Add(c->GetName());
+        e.threadsBefore = threads;
+        threads += (e.componentType == SYS_SAGE_COMPONENT_THREAD);
+        e.firstAttribute = attributes.size();
+        e.numAttributes = AddSnapshotAttributes(c->attrib, strings, attributes, codecs);
+        e.firstOutgoing = outgoing.size();
+        e.numOutgoing = out[i].size();
+        outgoing.insert(outgoing.end(), out[i].begin(), out[i].end());
+        e.firstIncoming = incoming.size();
+        e.numIncoming = in[i].size();
+        incoming.insert(incoming.end(), in[i].begin(), in[i].end());
+
+        e.size = -1;
+        switch(e.componentType)
+        {
+            case SYS_SAGE_COMPONENT_CACHE:
+                e.size = ((Cache*)c)->GetCacheSize();
+                e.property[0] = ((Cache*)c)->GetCacheAssociativityWays();
+                e.property[1] = ((Cache*)c)->GetCacheLineSize();
+                e.label[0] = strings.Add(((Cache*)c)->GetCacheName());
+                break;
+            case SYS_SAGE_COMPONENT_CHIP:
+                e.property[0] = ((Chip*)c)->GetChipType();
+                e.label[0] = strings.Add(((Chip*)c)->GetVendor());
+                e.label[1] = strings.Add(((Chip*)c)->GetModel());
+                break;
+            case SYS_SAGE_COMPONENT_SUBDIVISION:
+                e.property[0] = ((Subdivision*)c)->GetSubdivisionType();
+                break;
+            case SYS_SAGE_COMPONENT_NUMA:
+                e.size = ((Numa*)c)->GetSize();
+                e.property[0] = ((Numa*)c)->GetSubdivisionType();
+                break;
+            case SYS_SAGE_COMPONENT_MEMORY:
+                e.size = ((Memory*)c)->GetSize();
+                e.property[0] = ((Memory*)c)->GetIsVolatile();
+                break;
+            case SYS_SAGE_COMPONENT_STORAGE:
+                e.size = ((Storage*)c)->GetSize();
+                break;
+        }
+    }
+    vector<BinarySnapshotDataPath> data_paths(dps.size());
+    for(size_t k = 0; k < dps.size(); k++)
+    {
+        BinarySnapshotDataPath& e = data_paths[k];
+        e.source = view.GetIndex(dps[k]->GetSource());
+        e.target = view.GetIndex(dps[k]->GetTarget());
+        e.oriented = dps[k]->GetOriented();
+        e.dp_type = dps[k]->GetDpType();
+        e.bw = dps[k]->GetBw();
+        e.latency = dps[k]->GetLatency();
+        e.firstAttribute = attributes.size();
+        e.numAttributes = AddSnapshotAttributes(dps[k]->attrib, strings, attributes, codecs);
+    }
+
+    BinarySnapshotHeader header {};
+    memcpy(header.magic, SYS_SAGE_SNAPSHOT_MAGIC, sizeof(SYS_SAGE_SNAPSHOT_MAGIC));
+    header.version = SYS_SAGE_SNAPSHOT_VERSION;
+    header.byte_order = SYS_SAGE_SNAPSHOT_BYTE_ORDER;
+    header.num_components = n;
+    header.num_data_paths = dps.size();
+    header.num_attributes = attributes.size();
+    header.num_dp_indices = outgoing.size();
+
+    string file((const char*)&header, sizeof(header));
+    header.components_offset = AppendTable(file, components.data(), components.size());
+    header.data_paths_offset = AppendTable(file, data_paths.data(), data_paths.size());
+    header.outgoing_offset = AppendTable(file, outgoing.data(), outgoing.size());
+    header.incoming_offset = AppendTable(file, incoming.data(), incoming.size());
+    header.attributes_offset = AppendTable(file, attributes.data(), attributes.size());
+    header.strings_offset = AppendTable(file, strings.pool.data(), strings.pool.size());
+    header.strings_size = strings.pool.size();
+    header.file_size = file.size();
+    memcpy(file.data(), &header, sizeof(header));
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if(!f.good() || !f.write(file.data(), file.size()))
+    {
+        cerr << "exportToBinary: could not write " << path << endl;
+        return 1;
+    }
+    return 0;
+}
+
+//does the table lie within the file and is it aligned?
+static bool IsValidTable(uint64_t offset, uint64_t count, size_t entry_size, size_t file_size)
+{
+    return offset % SYS_SAGE_SNAPSHOT_ALIGNMENT == 0 && offset <= file_size && count <= (file_size - offset) / entry_size;
+}
+
+//does the range [first, first+num) lie within a table of size entries?
+static bool IsValidRange(uint64_t first, uint64_t num, uint64_t size)
+{
+    return first <= size && num <= size - first;
+}
+
+//are all indexes and offsets stored in the entries of the tables within their bounds? (the tables themselves are valid)
+static bool AreValidEntries(const char* data, const BinarySnapshotHeader* h)
+{
+    const BinarySnapshotComponent* components = (const BinarySnapshotComponent*)(data + h->components_offset);
+    const BinarySnapshotDataPath* data_paths = (const BinarySnapshotDataPath*)(data + h->data_paths_offset);
+    const uint32_t* outgoing = (const uint32_t*)(data + h->outgoing_offset);
+    const uint32_t* incoming = (const uint32_t*)(data + h->incoming_offset);
+    const BinarySnapshotAttribute* attributes = (const BinarySnapshotAttribute*)(data + h->attributes_offset);
+    int64_t n = h->num_components;
+    for(int64_t i = 0; i < n; i++)
+    {
+        const BinarySnapshotComponent& c = components[i];
+        //DFS pre-order: the parent comes first and the subtree is nested in the subtree of the parent
+        if(i == 0 ? c.parent != -1 : (c.parent < 0 || c.parent >= i))
+            return false;
+        if(c.subtreeEnd <= i || c.subtreeEnd > (i == 0 ? n : components[c.parent].subtreeEnd))
+            return false;
+        if((c.firstChild != -1 && (c.firstChild <= i || c.firstChild >= c.subtreeEnd)) || (c.nextSibling != -1 && (c.nextSibling <= i || c.nextSibling >= n)))
+            return false;
+        if(c.name >= h->strings_size || c.label[0] >= h->strings_size || c.label[1] >= h->strings_size)
+            return false;
+        if(!IsValidRange(c.firstAttribute, c.numAttributes, h->num_attributes) ||
+            !IsValidRange(c.firstOutgoing, c.numOutgoing, h->num_dp_indices) ||
+            !IsValidRange(c.firstIncoming, c.numIncoming, h->num_dp_indices))
+            return false;
+    }
+    for(uint32_t dp = 0; dp < h->num_data_paths; dp++)
+    {
+        const BinarySnapshotDataPath& p = data_paths[dp];
+        if(p.source < 0 || p.source >= n || p.target < 0 || p.target >= n || !IsValidRange(p.firstAttribute, p.numAttributes, h->num_attributes))
+            return false;
+    }
+    for(uint32_t i = 0; i < h->num_dp_indices; i++)
+    {
+        if(outgoing[i] >= h->num_data_paths || incoming[i] >= h->num_data_paths)
+            return false;
+    }
+    for(uint32_t a = 0; a < h->num_attributes; a++)
+    {
+        if(attributes[a].key >= h->strings_size)
+            return false;
+        if(attributes[a].kind == SYS_SAGE_SNAPSHOT_ATTRIB_STRING && !IsValidRange(attributes[a].value.s.offset, attributes[a].value.s.length, h->strings_size))
+            return false;
+    }
+    return true;
+}
+
+BinarySnapshot* openBinarySnapshot(string path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        cerr << "openBinarySnapshot: could not open " << path << endl;
+        return NULL;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BinarySnapshotHeader))
+    {
+        cerr << "openBinarySnapshot: " << path << " is not a sys-sage snapshot" << endl;
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        cerr << "openBinarySnapshot: could not map " << path << endl;
+        return NULL;
+    }
+
+    const BinarySnapshotHeader* h = (const BinarySnapshotHeader*)data;
+    const char* error = NULL;
+    if(memcmp(h->magic, SYS_SAGE_SNAPSHOT_MAGIC, sizeof(SYS_SAGE_SNAPSHOT_MAGIC)) != 0)
+        error = "is not a sys-sage snapshot";
+    else if(h->byte_order != SYS_SAGE_SNAPSHOT_BYTE_ORDER)
+        error = "was created on a machine with a different byte order";
+    else if(h->version != SYS_SAGE_SNAPSHOT_VERSION)
+        error = "has an unsupported version";
+    else if(h->file_size != size ||
+        !IsValidTable(h->components_offset, h->num_components, sizeof(BinarySnapshotComponent), size) ||
+        !IsValidTable(h->data_paths_offset, h->num_data_paths, sizeof(BinarySnapshotDataPath), size) ||
+        !IsValidTable(h->outgoing_offset, h->num_dp_indices, sizeof(uint32_t), size) ||
+        !IsValidTable(h->incoming_offset, h->num_dp_indices, sizeof(uint32_t), size) ||
+        !IsValidTable(h->attributes_offset, h->num_attributes, sizeof(BinarySnapshotAttribute), size) ||
+        !IsValidTable(h->strings_offset, h->strings_size, 1, size) ||
+        h->strings_size == 0 || ((const char*)data)[h->strings_offset + h->strings_size - 1] != '\0' ||
+        !AreValidEntries((const char*)data, h))
+        error = "is truncated or corrupted";
+    if(error != NULL)
+    {
+        cerr << "openBinarySnapshot: " << path << " " << error << endl;
+        munmap(data, size);
+        return NULL;
+    }
+    return new BinarySnapshot((const char*)data, size);
+}
+
+BinarySnapshot::BinarySnapshot(const char* _data, size_t _size): data(_data), size(_size)
+{
+    header = (const BinarySnapshotHeader*)data;
+    components = (const BinarySnapshotComponent*)(data + header->components_offset);
+    data_paths = (const BinarySnapshotDataPath*)(data + header->data_paths_offset);
+    outgoing = (const uint32_t*)(data + header->outgoing_offset);
+    incoming = (const uint32_t*)(data + header->incoming_offset);
+    attributes = (const BinarySnapshotAttribute*)(data + header->attributes_offset);
+    strings = data + header->strings_offset;
+}
+
+BinarySnapshot::~BinarySnapshot()
+{
+    munmap((void*)data, size);
+}
+
+const char* BinarySnapshot::GetString(uint32_t offset)
+{
+    return (offset < header->strings_size) ? strings + offset : "";
+}
+
+int BinarySnapshot::GetNumComponents(){return header->num_components;}
+int BinarySnapshot::GetComponentType(int idx){return components[idx].componentType;}
+int BinarySnapshot::GetId(int idx){return components[idx].id;}
+const char* BinarySnapshot::GetName(int idx){return GetString(components[idx].name);}
+int BinarySnapshot::GetCount(int idx){return components[idx].count;}
+long long BinarySnapshot::GetSize(int idx){return components[idx].size;}
+const BinarySnapshotComponent* BinarySnapshot::GetComponentEntry(int idx){return &components[idx];}
+int BinarySnapshot::GetParentIndex(int idx){return components[idx].parent;}
+int BinarySnapshot::GetFirstChildIndex(int idx){return components[idx].firstChild;}
+int BinarySnapshot::GetNextSiblingIndex(int idx){return components[idx].nextSibling;}
+int BinarySnapshot::GetSubtreeEnd(int idx){return components[idx].subtreeEnd;}
+int BinarySnapshot::GetDepth(int idx){return components[idx].depth;}
+
+int BinarySnapshot::GetSubcomponentIndexById(int _id, int _componentType, int idx)
+{
+    if(idx < 0 || idx >= GetNumComponents())
+        return -1;
+    int end = components[idx].subtreeEnd;
+    for(int i = idx; i < end; i++)
+    {
+        if(components[i].componentType == _componentType && components[i].id == _id)
+            return i;
+    }
+    return -1;
+}
+
+vector<int> BinarySnapshot::GetAllSubcomponentIndexesByType(int _componentType, int idx)
+{
+    vector<int> ret;
+    if(idx < 0 || idx >= GetNumComponents())
+        return ret;
+    int end = components[idx].subtreeEnd;
+    for(int i = idx; i < end; i++)
+    {
+        if(components[i].componentType == _componentType)
+            ret.push_back(i);
+    }
+    return ret;
+}
+
+int BinarySnapshot::CountAllSubcomponentsByType(int _componentType, int idx)
+{
+    if(idx < 0 || idx >= GetNumComponents())
+        return 0;
+    int end = components[idx].subtreeEnd;
+    int cnt = 0;
+    for(int i = idx + 1; i < end; i++)
+        cnt += (components[i].componentType == _componentType);
+    return cnt;
+}
+
+int BinarySnapshot::GetNumThreads(int idx)
+{
+    if(idx < 0 || idx >= GetNumComponents())
+        return 0;
+    int end = components[idx].subtreeEnd;
+    int last = end - 1;
+    //threads before the end of the subtree = threads before its last component (+1 if that one is a thread)
+    return components[last].threadsBefore + (components[last].componentType == SYS_SAGE_COMPONENT_THREAD) - components[idx].threadsBefore;
+}
+
+int BinarySnapshot::GetNumDataPaths(){return header->num_data_paths;}
+const BinarySnapshotDataPath* BinarySnapshot::GetDataPath(int dp){return &data_paths[dp];}
+
+span<const uint32_t> BinarySnapshot::GetDataPaths(int idx, int orientation)
+{
+    const BinarySnapshotComponent& c = components[idx];
+    if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
+        return span<const uint32_t>(outgoing + c.firstOutgoing, c.numOutgoing);
+    else if(orientation == SYS_SAGE_DATAPATH_INCOMING)
+        return span<const uint32_t>(incoming + c.firstIncoming, c.numIncoming);
+    return span<const uint32_t>();
+}
+
+int BinarySnapshot::FindAttribute(uint32_t first, uint32_t num, string_view key)
+{
+    for(uint32_t a = first; a < first + num; a++)
+    {
+        if(key == GetString(attributes[a].key))
+            return a;
+    }
+    return -1;
+}
+int BinarySnapshot::FindAttribute(int idx, string_view key){return FindAttribute(components[idx].firstAttribute, components[idx].numAttributes, key);}
+int BinarySnapshot::FindDataPathAttribute(int dp, string_view key){return FindAttribute(data_paths[dp].firstAttribute, data_paths[dp].numAttributes, key);}
+const char* BinarySnapshot::GetAttributeKey(int attr){return GetString(attributes[attr].key);}
+int BinarySnapshot::GetAttributeKind(int attr){return attributes[attr].kind;}
+int64_t BinarySnapshot::GetAttributeInt(int attr){return attributes[attr].value.i;}
+uint64_t BinarySnapshot::GetAttributeUint(int attr){return attributes[attr].value.u;}
+double BinarySnapshot::GetAttributeDouble(int attr){return attributes[attr].value.d;}
+string_view BinarySnapshot::GetAttributeString(int attr)
+{
+    const BinarySnapshotAttribute& a = attributes[attr];
+    return string_view(GetString(a.value.s.offset), a.value.s.length);
+}
@@ -0,0 +1,268 @@
+#ifndef BINARY_SNAPSHOT
+#define BINARY_SNAPSHOT
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+#define SYS_SAGE_SNAPSHOT_MAGIC "SYSSAGE" /**< First bytes of a binary snapshot file (including the terminating zero). */
+#define SYS_SAGE_SNAPSHOT_VERSION 1 /**< Version of the binary snapshot format written by exportToBinary(); openBinarySnapshot() only opens files of this version. */
+#define SYS_SAGE_SNAPSHOT_BYTE_ORDER 0x01020304 /**< Written in the native byte order, to detect snapshots created on a machine with a different one. */
+#define SYS_SAGE_SNAPSHOT_ALIGNMENT 8 /**< Alignment (in bytes) of each table of a binary snapshot. */
+
+//kinds of attribute values in a binary snapshot
+#define SYS_SAGE_SNAPSHOT_ATTRIB_INT 1 /**< Signed integer (int, long, long long); see BinarySnapshot::GetAttributeInt(). */
+#define SYS_SAGE_SNAPSHOT_ATTRIB_UINT 2 /**< Unsigned integer (unsigned, unsigned long, unsigned long long, uint64_t) or bool; see BinarySnapshot::GetAttributeUint(). */
+#define SYS_SAGE_SNAPSHOT_ATTRIB_DOUBLE 3 /**< Floating point number (float, double); see BinarySnapshot::GetAttributeDouble(). */
+#define SYS_SAGE_SNAPSHOT_ATTRIB_STRING 4 /**< String; see BinarySnapshot::GetAttributeString(). */
+
+using namespace std;
+
+/**
+Header of a binary snapshot file. All offsets are relative to the start of the file.
+*/
+struct BinarySnapshotHeader {
+    char magic[8]; /**< SYS_SAGE_SNAPSHOT_MAGIC */
+    uint32_t version; /**< SYS_SAGE_SNAPSHOT_VERSION */
+    uint32_t byte_order; /**< SYS_SAGE_SNAPSHOT_BYTE_ORDER */
+    uint64_t file_size; /**< Size of the whole file. */
+    uint32_t num_components; /**< Number of entries of the component table. */
+    uint32_t num_data_paths; /**< Number of entries of the DataPath table. */
+    uint32_t num_attributes; /**< Number of entries of the attribute pool. */
+    uint32_t num_dp_indices; /**< Number of entries of each of the outgoing and incoming DataPath index. */
+    uint64_t components_offset; /**< Component table (BinarySnapshotComponent). */
+    uint64_t data_paths_offset; /**< DataPath table (BinarySnapshotDataPath). */
+    uint64_t outgoing_offset; /**< Outgoing DataPath index (uint32_t DataPath numbers, grouped by component). */
+    uint64_t incoming_offset; /**< Incoming DataPath index (uint32_t DataPath numbers, grouped by component). */
+    uint64_t attributes_offset; /**< Attribute pool (BinarySnapshotAttribute). */
+    uint64_t strings_offset; /**< String pool (zero-terminated strings; offset 0 is the empty string). */
+    uint64_t strings_size; /**< Size of the string pool in bytes. */
+};
+
+/**
+One component in the component table of a binary snapshot. The components are stored in DFS pre-order, as in TopologyView.
+*/
+struct BinarySnapshotComponent {
+    int32_t componentType;
+    int32_t id;
+    int32_t parent; /**< Index of the parent; -1 for the root. */
+    int32_t firstChild; /**< Index of the first child; -1 for leaves. */
+    int32_t nextSibling; /**< Index of the next sibling; -1 for the last child. */
+    int32_t subtreeEnd; /**< End (exclusive) of the index range of the subtree. */
+    int32_t depth; /**< Distance from the root. */
+    int32_t count; /**< Component::count */
+    uint32_t name; /**< Offset of the name in the string pool. */
+    uint32_t threadsBefore; /**< Number of threads at lower indexes. */
+    uint32_t firstAttribute; /**< First attribute in the attribute pool. */
+    uint32_t numAttributes;
+    uint32_t firstOutgoing; /**< First entry in the outgoing DataPath index. */
+    uint32_t numOutgoing;
+    uint32_t firstIncoming; /**< First entry in the incoming DataPath index. */
+    uint32_t numIncoming;
+    int64_t size; /**< Memory, Storage, Numa: size; Cache: cache size; -1 otherwise. */
+    int32_t property[2]; /**< Cache: associativity ways, cache line size; Chip: chip type; Subdivision: subdivision type; Memory: is volatile (0/1). */
+    uint32_t label[2]; /**< Offsets in the string pool. Cache: cache type (e.g. "3"); Chip: vendor, model. */
+};
+
+/**
+One DataPath in the DataPath table of a binary snapshot.
+*/
+struct BinarySnapshotDataPath {
+    int32_t source; /**< Index of the source component. */
+    int32_t target; /**< Index of the target component. */
+    int32_t oriented;
+    int32_t dp_type;
+    double bw;
+    double latency;
+    uint32_t firstAttribute; /**< First attribute in the attribute pool. */
+    uint32_t numAttributes;
+};
+
+/**
+One attribute in the attribute pool of a binary snapshot.
+*/
+struct BinarySnapshotAttribute {
+    uint32_t key; /**< Offset of the attribute name in the string pool. */
+    uint32_t kind; /**< SYS_SAGE_SNAPSHOT_ATTRIB_* */
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        struct {
+            uint32_t offset; /**< Offset in the string pool. */
+            uint32_t length;
+        } s;
+    } value;
+};
+
+/**
+Writes the subtree of root (including root), the DataPaths between its components and their attributes into a binary snapshot file, which can be opened with openBinarySnapshot().
+\n Attributes are written if their value is of a basic type (see the SYS_SAGE_SNAPSHOT_ATTRIB_* kinds) or has a text codec in codecs (written as a string, see AttributeCodecRegistry::Encode()); other attributes are left out. DataPath matrices are not written.
+@param root - the root of the snapshot
+@param path - path of the file to write
+@param codecs - (optional) the registry of attribute codecs; NULL (the default) for AttributeCodecRegistry::GetDefault()
+@return 0 on success; 1 if the file could not be written
+*/
+int exportToBinary(Component* root, string path, AttributeCodecRegistry* codecs = NULL);
+
+/**
+Class BinarySnapshot - a read-only view of a topology stored in a binary snapshot file (see exportToBinary()).
+\n The file is memory-mapped: nothing is parsed or copied (opening it only checks, in one pass over the tables, that all indexes and offsets stored in them are within bounds), and all processes of a node that open the same file share its pages. The snapshot consists of a component table (in DFS pre-order, see TopologyView), a DataPath table, outgoing and incoming DataPath indexes, an attribute pool and a string pool, all addressed by offsets relative to the start of the file.
+\n Components and DataPaths are addressed by their index in the respective table. The query methods mirror those of TopologyView; each of them takes the index of the component to start from (default 0, i.e. the root of the snapshot). Returned strings point into the mapping and are valid as long as the snapshot is open.
+*/
+class BinarySnapshot {
+public:
+    /**
+    Unmaps the file.
+    */
+    ~BinarySnapshot();
+    BinarySnapshot(const BinarySnapshot&) = delete;
+    BinarySnapshot& operator=(const BinarySnapshot&) = delete;
+
+    /**
+    @returns the number of components in the snapshot
+    */
+    int GetNumComponents();
+    /**
+    @returns component type of the component at index idx
+    */
+    int GetComponentType(int idx);
+    /**
+    @returns id of the component at index idx
+    */
+    int GetId(int idx);
+    /**
+    @returns name of the component at index idx
+    */
+    const char* GetName(int idx);
+    /**
+    @returns count of the component at index idx (see Component::count)
+    */
+    int GetCount(int idx);
+    /**
+    @returns size of the component at index idx: size of a Memory, Storage or Numa, cache size of a Cache; -1 for other components
+    */
+    long long GetSize(int idx);
+    /**
+    @returns the raw entry of the component at index idx (e.g. for the type-specific properties)
+    */
+    const BinarySnapshotComponent* GetComponentEntry(int idx);
+    /**
+    @returns index of the parent of the component at index idx, or -1 for the root
+    */
+    int GetParentIndex(int idx);
+    /**
+    @returns index of the first child of the component at index idx, or -1 if it is a leaf
+    */
+    int GetFirstChildIndex(int idx);
+    /**
+    @returns index of the next sibling of the component at index idx, or -1 if it is the last child of its parent
+    */
+    int GetNextSiblingIndex(int idx);
+    /**
+    @returns the end (exclusive) of the index range occupied by the subtree of the component at index idx
+    */
+    int GetSubtreeEnd(int idx);
+    /**
+    @returns distance of the component at index idx from the root (the root has depth 0)
+    */
+    int GetDepth(int idx);
+
+    /**
+    Searches the subtree of the component at index idx for a component with a matching id and componentType (the first match in DFS order, as TopologyView::GetSubcomponentById()).
+    @return index of the found component; -1 if no match found
+    */
+    int GetSubcomponentIndexById(int _id, int _componentType, int idx = 0);
+    /**
+    Retrieves the indexes of all components of type _componentType in the subtree of the component at index idx (including itself), in DFS order.
+    */
+    vector<int> GetAllSubcomponentIndexesByType(int _componentType, int idx = 0);
+    /**
+    Counts the components of type _componentType in the subtree of the component at index idx (not including the component itself).
+    */
+    int CountAllSubcomponentsByType(int _componentType, int idx = 0);
+    /**
+    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree of the component at index idx. Answered in O(1).
+    */
+    int GetNumThreads(int idx = 0);
+
+    /**
+    @returns the number of DataPaths in the snapshot
+    */
+    int GetNumDataPaths();
+    /**
+    @returns the DataPath with index dp
+    */
+    const BinarySnapshotDataPath* GetDataPath(int dp);
+    /**
+    Retrieves the DataPaths of the component at index idx, as Component::GetDataPathList(): the outgoing (SYS_SAGE_DATAPATH_OUTGOING) or incoming (SYS_SAGE_DATAPATH_INCOMING) oriented DataPaths, together with the bidirectional ones.
+    @return indexes of the DataPaths (see GetDataPath()); empty if the orientation is not valid
+    */
+    span<const uint32_t> GetDataPaths(int idx, int orientation);
+
+    /**
+    Looks up an attribute of the component at index idx.
+    @return index of the attribute (see GetAttributeKind() etc.); -1 if the component does not have it
+    */
+    int FindAttribute(int idx, string_view key);
+    /**
+    Looks up an attribute of the DataPath with index dp.
+    @return index of the attribute (see GetAttributeKind() etc.); -1 if the DataPath does not have it
+    */
+    int FindDataPathAttribute(int dp, string_view key);
+    /**
+    @returns name of the attribute with index attr
+    */
+    const char* GetAttributeKey(int attr);
+    /**
+    @returns kind of the value of the attribute with index attr (SYS_SAGE_SNAPSHOT_ATTRIB_*)
+    */
+    int GetAttributeKind(int attr);
+    /**
+    @returns value of an attribute of kind SYS_SAGE_SNAPSHOT_ATTRIB_INT
+    */
+    int64_t GetAttributeInt(int attr);
+    /**
+    @returns value of an attribute of kind SYS_SAGE_SNAPSHOT_ATTRIB_UINT
+    */
+    uint64_t GetAttributeUint(int attr);
+    /**
+    @returns value of an attribute of kind SYS_SAGE_SNAPSHOT_ATTRIB_DOUBLE
+    */
+    double GetAttributeDouble(int attr);
+    /**
+    @returns value of an attribute of kind SYS_SAGE_SNAPSHOT_ATTRIB_STRING
+    */
+    string_view GetAttributeString(int attr);
+
+private:
+    BinarySnapshot(const char* _data, size_t _size);
+    const char* GetString(uint32_t offset);
+    int FindAttribute(uint32_t first, uint32_t num, string_view key);
+
+    const char* data; /**< Start of the mapping. */
+    size_t size; /**< Size of the mapping. */
+    const BinarySnapshotHeader* header;
+    const BinarySnapshotComponent* components;
+    const BinarySnapshotDataPath* data_paths;
+    const uint32_t* outgoing;
+    const uint32_t* incoming;
+    const BinarySnapshotAttribute* attributes;
+    const char* strings;
+
+    friend BinarySnapshot* openBinarySnapshot(string path);
+};
+
+/**
+Opens a binary snapshot written by exportToBinary().
+@param path - path of the snapshot file
+@return the snapshot (delete it to close it); NULL if the file could not be opened or is not a valid snapshot of the current version
+*/
+BinarySnapshot* openBinarySnapshot(string path);
+
+#endif
@@ -126,15 +126,13 @@ int Node::UpdateL3CATCoreCOS(){
         {
             Thread* thread = *it_threads;
             //std::cout << "  thread " << thread->GetComponentTypeStr() << " id " << thread->GetId() << std::endl;
-            uint64_t* cos = new uint64_t();
-            uint64_t* mask = new uint64_t();
-            *cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
-            if(*cos == std::numeric_limits<uint64_t>::max()){
+            uint64_t cos = getCoreCOS(socket->GetId(), thread->GetId(), p_l3cat_ids, l3cat_id_count, p_cpu);
+            if(cos == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCoreCOS failed" << endl;
                 continue;
             }
-            *mask = getCOSL3Bitmask(socket->GetId(), *cos, p_l3cat_ids, l3cat_id_count);
-            if(*mask == std::numeric_limits<uint64_t>::max()){
+            uint64_t mask = getCOSL3Bitmask(socket->GetId(), cos, p_l3cat_ids, l3cat_id_count);
+            if(mask == std::numeric_limits<uint64_t>::max()){
                 cerr << "getCOSL3Bitmask failed" << endl;
                 continue;
             }
@@ -151,12 +149,10 @@ int Node::UpdateL3CATCoreCOS(){
                 cerr << "L3 cache not found" << endl; continue;
             }
 
-            //TODO check if exists -> overwrite
-
-            //add DataPath to thread and L3
-            DataPath* d = NewDataPath(thread, c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
-            d->attrib.insert({"CATcos", (void*)cos});
-            d->attrib.insert({"CATL3mask", (void*)mask});
+            //add DataPath to thread and L3, or overwrite the settings of the existing one
+            DataPath* d = UpsertDataPath(thread, c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+            d->attrib.Set<uint64_t>("CATcos", cos);
+            d->attrib.Set<uint64_t>("CATL3mask", mask);
         }
     }
     return 1;
@@ -164,15 +160,13 @@ int Node::UpdateL3CATCoreCOS(){
 
 long long Thread::GetCATAwareL3Size()
 {
-    //look for dp_outgoing where attrib contains "CATL3mask"
-    for(auto it = std::begin(dp_outgoing); it != std::end(dp_outgoing); ++it)
+    //look for L3CAT data paths where attrib contains "CATL3mask"
+    for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING))
     {
-        DataPath* dp = *it;
-        auto search = dp->attrib.find("CATL3mask");
-        if (search == dp->attrib.end()) {
+        uint64_t* mask = dp->attrib.Get<uint64_t>("CATL3mask");
+        if (mask == NULL) {
             continue;
         }
-        uint64_t* mask = (uint64_t*)search->second;
 
         Cache* c = (Cache*)dp->GetTarget();
         int available_cache_associativity_ways = 0;
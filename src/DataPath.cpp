@@ -1,7 +1,10 @@
 #include "DataPath.hpp"
+#include "DataPathHistory.hpp"
 
 #include <cstdint>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
 
 DataPath* NewDataPath(Component* _source, Component* _target, int _oriented, int _type){
     return NewDataPath(_source,_target,_oriented,_type,(double)-1,(double)-1);
@@ -15,6 +18,90 @@ DataPath* NewDataPath(Component* _source, Component* _target, int _oriented, int
     return p;
 }
 
+//the component keeping the index entry of a relation of UpsertDataPath(), and the other endpoint
+static void GetIndexEndpoints(Component* _source, Component* _target, int _oriented, Component** owner, Component** other)
+{
+    if(_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL && std::less<Component*>()(_target, _source))
+        std::swap(_source, _target);
+    *owner = _source;
+    *other = _target;
+}
+
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency)
+{
+    if(_oriented != SYS_SAGE_DATAPATH_BIDIRECTIONAL && _oriented != SYS_SAGE_DATAPATH_ORIENTED)
+    {
+        cerr << "UpsertDataPath: invalid orientation " << _oriented << endl;
+        return NULL;
+    }
+    Component *owner, *other;
+    GetIndexEndpoints(_source, _target, _oriented, &owner, &other);
+    DataPath* p = NULL;
+    DataPathBucket* bucket = owner->FindDpBucket(_type);
+    if(bucket != NULL)
+    {
+        unordered_map<Component*, DataPath*>& index = (_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL) ? bucket->upserted_bidirectional : bucket->upserted_outgoing;
+        auto it = index.find(other);
+        if(it != index.end())
+        {
+            p = it->second;
+            if(p->bw != _bw)
+                p->SetBw(_bw);
+            if(p->latency != _latency)
+                p->SetLatency(_latency);
+            return p;
+        }
+
+        //first call for the relation: reuse a matching DataPath created otherwise
+        for(DataPath* dp : (_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL) ? bucket->bidirectional : bucket->outgoing)
+        {
+            Component* dp_other = (dp->source == owner) ? dp->target : dp->source;
+            if(!dp->indexed && dp_other == other)
+            {
+                p = dp;
+                break;
+            }
+        }
+    }
+    if(p == NULL)
+    {
+        p = new DataPath(_source, _target, _oriented, _type, _bw, _latency);
+        bucket = owner->FindDpBucket(_type);
+    }
+    else
+    {
+        if(p->bw != _bw)
+            p->SetBw(_bw);
+        if(p->latency != _latency)
+            p->SetLatency(_latency);
+    }
+    p->indexed = true;
+    ((_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL) ? bucket->upserted_bidirectional : bucket->upserted_outgoing)[other] = p;
+    return p;
+}
+
+//drops the DataPath from the index of UpsertDataPath() when it is unlinked from the component c keeping its index entry
+void DataPath::Unindex(Component* c, DataPathBucket* bucket)
+{
+    Component *owner, *other;
+    GetIndexEndpoints(source, target, oriented, &owner, &other);
+    if(!indexed || c != owner)
+        return;
+    unordered_map<Component*, DataPath*>& index = (oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL) ? bucket->upserted_bidirectional : bucket->upserted_outgoing;
+    auto it = index.find(other);
+    if(it != index.end() && it->second == this)
+        index.erase(it);
+    indexed = false;
+}
+
+static const vector<DataPath*> no_data_paths;
+DataPathList::DataPathList(): DataPathList(&no_data_paths, &no_data_paths) {}
+DataPathList::DataPathList(const vector<DataPath*>* _oriented, const vector<DataPath*>* _bidirectional): oriented(_oriented), bidirectional(_bidirectional) {}
+bool DataPathList::operator==(const vector<DataPath*>& other) const
+{
+    return size() == other.size() && std::equal(begin(), end(), other.begin());
+}
+
 Component * DataPath::GetSource() {return source;}
 Component * DataPath::GetTarget() {return target;}
 double DataPath::GetBw() {return bw;}
@@ -22,19 +109,59 @@ double DataPath::GetLatency() {return latency;}
 int DataPath::GetDpType() {return dp_type;}
 int DataPath::GetOriented() {return oriented;}
 
+void DataPath::SetBw(double _bw)
+{
+    bw = _bw;
+    source->dp_stamp = target->dp_stamp = ++version;
+}
+void DataPath::SetLatency(double _latency)
+{
+    latency = _latency;
+    source->dp_stamp = target->dp_stamp = ++version;
+}
+
+DataPathHistory* DataPath::EnableHistory(size_t capacity, double alpha)
+{
+    if(history == NULL)
+        history = new DataPathHistory(capacity, alpha);
+    return history;
+}
+void DataPath::DisableHistory()
+{
+    delete history;
+    history = NULL;
+}
+DataPathHistory* DataPath::GetHistory(){ return history; }
+void DataPath::AddSample(double timestamp, double _bw, double _latency)
+{
+    if(_bw >= 0)
+        SetBw(_bw);
+    if(_latency >= 0)
+        SetLatency(_latency);
+    if(history != NULL)
+        history->Add(timestamp, _bw, _latency);
+}
+
+std::atomic<uint64_t> DataPath::version { 0 };
+std::atomic<uint64_t> DataPath::structure_version { 0 };
+uint64_t DataPath::GetVersion() {return version;}
+uint64_t DataPath::GetStructureVersion() {return structure_version;}
+DataPath::~DataPath()
+{
+    version++;
+    structure_version++;
+    delete history;
+    Arena::SetReleasedObject(this, attrib.GetArena());
+}
+
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, int _type): DataPath(_source, _target, _oriented, _type, -1, -1) {}
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, double _bw, double _latency): DataPath(_source, _target, _oriented, SYS_SAGE_DATAPATH_TYPE_NONE, _bw, _latency) {}
 DataPath::DataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency): source(_source), target(_target), oriented(_oriented), dp_type(_type), bw(_bw), latency(_latency)
 {
-    if(_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
-    {
-        _source->AddDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
-        _target->AddDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
-        _source->AddDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
-        _target->AddDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
-    }
-    else if(_oriented == SYS_SAGE_DATAPATH_ORIENTED)
+    version++;
+    if(_oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL || _oriented == SYS_SAGE_DATAPATH_ORIENTED)
     {
+        //a bidirectional data path is stored once per endpoint (see Component::GetDataPathList())
         _source->AddDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
         _target->AddDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
     }
@@ -47,25 +174,8 @@ DataPath::DataPath(Component* _source, Component* _target, int _oriented, int _t
 
 void DataPath::DeleteDataPath()
 {
-    if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
-    {
-        std::vector<DataPath*>* source_dp_outgoing = source->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* source_dp_incoming = source->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        std::vector<DataPath*>* target_dp_outgoing = target->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* target_dp_incoming = target->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-
-        source_dp_outgoing->erase(std::remove(source_dp_outgoing->begin(), source_dp_outgoing->end(), this), source_dp_outgoing->end());
-        target_dp_outgoing->erase(std::remove(target_dp_outgoing->begin(), target_dp_outgoing->end(), this), target_dp_outgoing->end());
-        source_dp_incoming->erase(std::remove(source_dp_incoming->begin(), source_dp_incoming->end(), this), source_dp_incoming->end());
-        target_dp_incoming->erase(std::remove(target_dp_incoming->begin(), target_dp_incoming->end(), this), target_dp_incoming->end());
-    }
-    else if(oriented == SYS_SAGE_DATAPATH_ORIENTED)
-    {
-        std::vector<DataPath*>* source_dp_outgoing = source->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        std::vector<DataPath*>* target_dp_incoming = target->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        source_dp_outgoing->erase(std::remove(source_dp_outgoing->begin(), source_dp_outgoing->end(), this), source_dp_outgoing->end());
-        target_dp_incoming->erase(std::remove(target_dp_incoming->begin(), target_dp_incoming->end(), this), target_dp_incoming->end());
-    }
+    source->RemoveDataPath(this, SYS_SAGE_DATAPATH_OUTGOING);
+    target->RemoveDataPath(this, SYS_SAGE_DATAPATH_INCOMING);
     delete this;
 }
 
@@ -76,9 +186,11 @@ void DataPath::Print()
     if(!attrib.empty())
     {
         cout << " - attrib: ";
-        for (const auto& n : attrib) {
-            uint64_t* val = (uint64_t*)n.second;
-            std::cout << n.first << " = " << *val << "; ";
+        for (auto it = attrib.begin(); it != attrib.end(); ++it) {
+            string val;
+            if(!AttributeStore::FormatValue(it.GetEntry(), &val))
+                val = "<" + std::to_string((uintptr_t)it->second) + ">";
+            std::cout << it->first << " = " << val << "; ";
         }
     }
     cout << endl;
@@ -2,9 +2,12 @@
 #define DATAPATH
 
 #include <map>
+#include <atomic>
 
 #include "defines.hpp"
 #include "Topology.hpp"
+#include "AttributeStore.hpp"
+#include "DataPathList.hpp"
 
 //Component pointing to a DataPath 
 #define SYS_SAGE_DATAPATH_NONE 1 /**< TODO */
@@ -23,10 +26,15 @@
 #define SYS_SAGE_DATAPATH_TYPE_MIG 512 /**< DataPath type describing GPU partitioning settings. */
 #define SYS_SAGE_DATAPATH_TYPE_DATATRANSFER 1024 /**< DataPath type describing data transfer attributes. */
 #define SYS_SAGE_DATAPATH_TYPE_C2C 2048 /**< DataPath type describing cache-to-cache latencies (cccbench data source). */
+#define SYS_SAGE_DATAPATH_TYPE_ANY 0 /**< Not a type of a DataPath; used in queries to select DataPaths of all types. */
+
+#define SYS_SAGE_DATAPATH_HISTORY_EWMA_ALPHA 0.125 /**< Default weight of a new sample in the exponentially weighted moving average of a DataPathHistory. */
 
 using namespace std;
 class Component;
+struct DataPathBucket;
 class DataPath;
+class DataPathHistory;
 
 /**
 Obsolete; use DataPath() constructors directly instead
@@ -43,6 +51,19 @@ Obsolete; use DataPath() constructors directly instead
 @see DataPath()
 */
 DataPath* NewDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
+/**
+Creates a DataPath unless it already exists, in which case only its bandwidth and latency are updated (see DataPath::SetBw(), DataPath::SetLatency()). Meant for periodic refreshes of the same relations (e.g. Node::UpdateL3CATCoreCOS()), which should not add duplicate DataPaths.
+\n The DataPaths created or found by this function are indexed by (source, target, orientation, type) in the DataPathBucket of the type of the source (of the endpoint with the lower address for bidirectional DataPaths), so repeated calls for the same relation take constant time; the index is destroyed with the DataPaths and the component. Like the creation of DataPaths, calls with the same endpoints must not run concurrently. The first call for a relation searches the DataPaths of _source of the given type, so that a matching DataPath created otherwise is reused as well. Bidirectional DataPaths match regardless of the order of _source and _target.
+@param _source - pointer to the source Component
+@param _target - pointer to the target Component
+@param _oriented - SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL
+@param _type - type of the Data Path
+@param _bw - bandwidth from the source to the target
+@param _latency - data load latency from the source to the target
+@return the created or updated DataPath
+@see DataPath()
+*/
+DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw = -1, double _latency = -1);
 
 /**
 Class DataPath represents Data Paths in the topology -- Data Paths represent an arbitrary relation (or data movement) between two Components from the Component Tree.
@@ -81,6 +102,29 @@ public:
     @param _latency - Data load latency from the source(provides the data) to the target(requests the data)
     */
     DataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
+    /**
+    Allocates memory for a DataPath. If an Arena is active in the current thread, the DataPath is allocated from it, otherwise from the heap.
+    @see ArenaScope
+    */
+    static void* operator new(size_t size);
+    /**
+    Releases memory of a DataPath. DataPaths allocated from an Arena only give their memory back when the Arena is destroyed; until then, it is reused for new DataPaths.
+    */
+    static void operator delete(void* ptr, size_t size);
+    /**
+    DataPath destructor. Does not remove the DataPath from its source and target Components (use DeleteDataPath() for that).
+    */
+    ~DataPath();
+    /**
+    Retrieves the global version of the DataPath graph. The version is incremented whenever any DataPath is created, deleted or modified; it is used to invalidate data derived from the DataPaths (e.g. DataPathGraph).
+    @returns the current version
+    */
+    static uint64_t GetVersion();
+    /**
+    Retrieves the global version of the structure of the DataPath graph. Unlike GetVersion(), it is only incremented when a DataPath is created or deleted, or added to or removed from a Component, but not when its bandwidth or latency changes (e.g. by AddSample()).
+    @returns the current structure version
+    */
+    static uint64_t GetStructureVersion();
 
     /**
     @returns Pointer to the source Component
@@ -99,6 +143,36 @@ public:
     */
     double GetLatency();
     /**
+    Sets the bandwidth from the source to the target, and increments the version of the DataPath graph (see GetVersion()).
+    */
+    void SetBw(double _bw);
+    /**
+    Sets the data load latency from the source to the target, and increments the version of the DataPath graph (see GetVersion()).
+    */
+    void SetLatency(double _latency);
+    /**
+    Starts recording the bandwidth and latency of the DataPath over time (see AddSample()). If the history is already enabled, it is kept as it is.
+    @param capacity - number of samples kept (see DataPathHistory)
+    @param alpha - weight of a new sample in the exponentially weighted moving average
+    @return the history of the DataPath
+    */
+    DataPathHistory* EnableHistory(size_t capacity, double alpha = SYS_SAGE_DATAPATH_HISTORY_EWMA_ALPHA);
+    /**
+    Stops recording the bandwidth and latency of the DataPath and deletes the recorded history.
+    */
+    void DisableHistory();
+    /**
+    @returns the recorded history of the bandwidth and latency; NULL if it is not enabled (see EnableHistory())
+    */
+    DataPathHistory* GetHistory();
+    /**
+    Records a new measurement: sets the bandwidth and latency (see SetBw(), SetLatency()) and, if the history is enabled, adds the sample to it.
+    @param timestamp - time of the measurement
+    @param _bw - measured bandwidth; negative if unknown (the bandwidth of the DataPath is then left unchanged)
+    @param _latency - measured latency; negative if unknown (the latency of the DataPath is then left unchanged)
+    */
+    void AddSample(double timestamp, double _bw, double _latency);
+    /**
     @returns Type of the Data Path.
     @see dp_type
     */
@@ -109,21 +183,24 @@ public:
     int GetOriented();
 
     /**
-    Prints basic information about the Data Path to stdout. Prints componentType and Id of the source and target Components, the bandwidth, load latency, and the attributes; for each attribute, the name and value are printed, however the value is only retyped to uint64_t (therefore will print nonsensical values for other data types).
+    Prints basic information about the Data Path to stdout. Prints componentType and Id of the source and target Components, the bandwidth, load latency, and the attributes; for each attribute, the name and value are printed. Values of basic types stored with attrib.Set<T>() are printed as such (see AttributeStore::FormatValue()); for other values, only their address is printed.
     */
     void Print();
 
     /**
     Deletes and de-allocated the DataPath pointer from the list(std::vector) of outgoing and incoming DataPaths of source and target Components.
+    \n Takes constant time: the DataPath knows its position in each list, and the last DataPath of the list is moved to its place (i.e. the order of the remaining DataPaths in the lists changes).
     @see dp_incoming
     @see dp_outgoing
     */
     void DeleteDataPath();
 
     /**
-     * TODO
+    Attributes of the data path (key -> value).
+    \n Use attrib.Set<T>(key, value) and attrib.Get<T>(key) for typed values owned by the data path; the std::map<string,void*>-like interface (attrib[key], attrib.insert(), ...) stores raw pointers owned by the caller.
+    @see AttributeStore
     */
-    map<string,void*> attrib;
+    AttributeStore attrib { Arena::TakeObjectOwner(this) };
 private:
     Component * source; /**< TODO */
     Component * target; /**< TODO */
@@ -134,6 +211,15 @@ private:
     double bw; /**< TODO */
     double latency; /**< TODO */
 
+    static std::atomic<uint64_t> version; /**< Version of the DataPath graph; atomic, as DataPaths of separate components may be changed concurrently. @see GetVersion() */
+    static std::atomic<uint64_t> structure_version; /**< @see GetStructureVersion() */
+
+    friend class Component;
+    friend DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
+    void Unindex(Component* c, DataPathBucket* bucket);
+    DataPathHistory* history { nullptr }; /**< Recorded bandwidth and latency; NULL unless enabled. @see EnableHistory() */
+    bool indexed { false }; /**< Is the DataPath in the index of UpsertDataPath()? */
+    int slots[2][2] { {-1, -1}, {-1, -1} }; /**< Position of this DataPath in the lists of its endpoints, indexed by [source/target][list of the Component (dp_outgoing, dp_incoming or dp_bidirectional) / list of the type bucket]; -1 if it is not in the list. A bidirectional loop (source == target) is only registered as the source. Maintained by Component::AddDataPath() and Component::RemoveDataPath(). */
 };
 
 #endif
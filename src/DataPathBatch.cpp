@@ -0,0 +1,94 @@
+#include "DataPathBatch.hpp"
+
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+
+#include "Arena.hpp"
+
+DataPathBatch::DataPathBatch(int _oriented): oriented(_oriented) {}
+DataPathBatch::~DataPathBatch() {}
+
+void DataPathBatch::Reserve(size_t n)
+{
+    sources.reserve(n);
+    targets.reserve(n);
+    types.reserve(n);
+    bws.reserve(n);
+    latencies.reserve(n);
+}
+
+size_t DataPathBatch::Add(Component* _source, Component* _target, int _type, double _bw, double _latency)
+{
+    sources.push_back(_source);
+    targets.push_back(_target);
+    types.push_back(_type);
+    bws.push_back(_bw);
+    latencies.push_back(_latency);
+    return sources.size() - 1;
+}
+
+size_t DataPathBatch::Size(){ return sources.size(); }
+
+//number of new DataPaths per (component, dp_type) and list
+struct DataPathCounts {
+    size_t outgoing { 0 };
+    size_t incoming { 0 };
+    size_t bidirectional { 0 };
+};
+struct ComponentTypeHash {
+    size_t operator()(const pair<Component*, int>& k) const { return std::hash<Component*>()(k.first) * 31 + std::hash<int>()(k.second); }
+};
+
+int DataPathBatch::Commit(vector<DataPath*>* outDataPaths)
+{
+    if(oriented != SYS_SAGE_DATAPATH_ORIENTED && oriented != SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+    {
+        cerr << "DataPathBatch::Commit: invalid orientation " << oriented << endl;
+        return -1;
+    }
+    size_t n = sources.size();
+
+    //grow the DataPath lists of every endpoint once
+    unordered_map<pair<Component*, int>, DataPathCounts, ComponentTypeHash> counts;
+    for(size_t i = 0; i < n; i++)
+    {
+        if(oriented == SYS_SAGE_DATAPATH_ORIENTED)
+        {
+            counts[{sources[i], types[i]}].outgoing++;
+            counts[{targets[i], types[i]}].incoming++;
+        }
+        else
+        {
+            counts[{sources[i], types[i]}].bidirectional++;
+            if(targets[i] != sources[i])
+                counts[{targets[i], types[i]}].bidirectional++;
+        }
+    }
+    for(auto& [key, c] : counts)
+        key.first->ReserveDataPaths(key.second, c.outgoing, c.incoming, c.bidirectional);
+
+    Arena* arena = Arena::GetActive();
+    if(arena != NULL)
+        arena->ReserveObjects(sizeof(DataPath), n);
+    //create all DataPaths first, so that they lie next to each other, then fill in the attributes column by column
+    vector<DataPath*> created(n);
+    for(size_t i = 0; i < n; i++)
+        created[i] = new DataPath(sources[i], targets[i], oriented, types[i], bws[i], latencies[i]);
+    for(unique_ptr<AttributeColumn>& column : columns)
+    {
+        size_t rows = std::min(n, column->Size());
+        for(size_t i = 0; i < rows; i++)
+            column->Apply(created[i], i);
+    }
+    if(outDataPaths != NULL)
+        outDataPaths->insert(outDataPaths->end(), created.begin(), created.end());
+
+    sources.clear();
+    targets.clear();
+    types.clear();
+    bws.clear();
+    latencies.clear();
+    columns.clear();
+    return n;
+}
@@ -0,0 +1,90 @@
+#ifndef DATAPATH_BATCH
+#define DATAPATH_BATCH
+
+#include <vector>
+#include <memory>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+#include "AttributeStore.hpp"
+
+using namespace std;
+
+/**
+Class DataPathBatch - creates many DataPaths at once, e.g. all N*(N-1) core-to-core DataPaths of a benchmark.
+\n The DataPaths are first collected as rows (source, target, type, bandwidth, latency), optionally with attribute columns, and created by Commit(). Commit() reserves the capacity of the DataPath lists of all endpoints up front, so that they are not reallocated repeatedly, and, if an Arena is active (see ArenaScope), allocates all the DataPaths from one contiguous block of it (bypassing the free slots of deleted DataPaths, see Arena::ReserveObjects()). The created DataPaths are ordinary DataPaths (e.g. they can be deleted one by one).
+\n Example:
+\n DataPathBatch batch;
+\n vector<float>* lat = batch.AddAttributeColumn<float>(AttributeKey("latency"));
+\n for(...) { batch.Add(src, dst, SYS_SAGE_DATAPATH_TYPE_C2C, 0, mean); lat->push_back(mean); }
+\n batch.Commit();
+*/
+class DataPathBatch {
+public:
+    /**
+    Creates an empty batch.
+    @param _oriented - orientation of all DataPaths of the batch (SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+    */
+    DataPathBatch(int _oriented = SYS_SAGE_DATAPATH_ORIENTED);
+    ~DataPathBatch();
+    DataPathBatch(const DataPathBatch&) = delete;
+    DataPathBatch& operator=(const DataPathBatch&) = delete;
+
+    /**
+    Reserves memory for n rows.
+    */
+    void Reserve(size_t n);
+    /**
+    Adds a DataPath to the batch (see the DataPath() constructor for the parameters).
+    @return index of the row
+    */
+    size_t Add(Component* _source, Component* _target, int _type, double _bw = -1, double _latency = -1);
+    /**
+    @returns number of rows in the batch
+    */
+    size_t Size();
+    /**
+    Adds an attribute column: element i of the returned vector becomes the attribute key of the DataPath of row i (see AttributeStore::Set()). Rows beyond the end of the vector do not get the attribute.
+    @param key - the attribute key
+    @return the column, to be filled by the caller; valid until Commit()
+    */
+    template <typename T> vector<T>* AddAttributeColumn(AttributeKey key);
+    /**
+    Creates the DataPaths of all rows and empties the batch.
+    @param outDataPaths - (optional) output parameter; the created DataPaths are pushed back in the order of the rows
+    @return number of created DataPaths; -1 if the orientation of the batch is not valid (nothing is created)
+    */
+    int Commit(vector<DataPath*>* outDataPaths = NULL);
+
+private:
+    struct AttributeColumn {
+        AttributeKey key;
+        AttributeColumn(AttributeKey _key): key(_key) {}
+        virtual ~AttributeColumn() {}
+        virtual size_t Size() = 0;
+        virtual void Apply(DataPath* dp, size_t row) = 0;
+    };
+    template <typename T> struct TypedAttributeColumn : AttributeColumn {
+        vector<T> values;
+        TypedAttributeColumn(AttributeKey _key): AttributeColumn(_key) {}
+        size_t Size() override { return values.size(); }
+        void Apply(DataPath* dp, size_t row) override { dp->attrib.Set<T>(key, std::move(values[row])); }
+    };
+
+    int oriented;
+    vector<Component*> sources;
+    vector<Component*> targets;
+    vector<int> types;
+    vector<double> bws;
+    vector<double> latencies;
+    vector<unique_ptr<AttributeColumn>> columns;
+};
+
+template <typename T> vector<T>* DataPathBatch::AddAttributeColumn(AttributeKey key)
+{
+    TypedAttributeColumn<T>* column = new TypedAttributeColumn<T>(key);
+    columns.emplace_back(column);
+    return &column->values;
+}
+
+#endif
@@ -0,0 +1,403 @@
+#include "DataPathGraph.hpp"
+
+#include "Traversal.hpp"
+
+#include <queue>
+#include <set>
+#include <limits>
+#include <algorithm>
+
+DataPathGraph::DataPathGraph(Component* _root) : root(_root) {}
+
+bool DataPathGraph::IsStale()
+{
+    return !built || dp_version != DataPath::GetVersion() || tree_epoch != root->GetTreeEpoch();
+}
+
+void DataPathGraph::Refresh()
+{
+    if(!built || dp_structure_version != DataPath::GetStructureVersion() || tree_epoch != root->GetTreeEpoch())
+        Build();
+    else if(dp_version != DataPath::GetVersion())
+        ReloadMetrics();
+}
+
+static void ReloadCsrMetrics(DataPathCsr* csr)
+{
+    for(int e = 0; e < csr->GetNumEdges(); e++)
+    {
+        csr->bw[e] = csr->dps[e]->GetBw();
+        csr->latency[e] = csr->dps[e]->GetLatency();
+    }
+}
+
+//only bandwidths and latencies have changed (e.g. by DataPath::AddSample()): the edges stay, but the cached paths may not be the best ones anymore
+void DataPathGraph::ReloadMetrics()
+{
+    dp_version = DataPath::GetVersion();
+    ReloadCsrMetrics(&all);
+    for(auto& [type, csr] : by_type)
+        ReloadCsrMetrics(&csr);
+    path_cache.clear();
+}
+
+//calls f(dp, v) for each edge leading from vertex u (component c) to a vertex v of the graph
+template <typename F>
+static void ForEachEdge(Component* c, unordered_map<Component*, int>& index, F f)
+{
+    for(DataPath* dp : c->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING))
+    {
+        Component* other;
+        if(dp->GetOriented() == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+            other = (dp->GetSource() == c) ? dp->GetTarget() : dp->GetSource();
+        else
+            other = dp->GetTarget();
+        auto it = index.find(other);
+        if(it != index.end())
+            f(dp, it->second);
+    }
+}
+
+static void FillCsr(DataPathCsr* csr, vector<int>& counts)
+{
+    int n = counts.size();
+    csr->offsets.assign(n + 1, 0);
+    for(int v = 0; v < n; v++)
+        csr->offsets[v+1] = csr->offsets[v] + counts[v];
+    int m = csr->offsets[n];
+    csr->neighbors.resize(m);
+    csr->bw.resize(m);
+    csr->latency.resize(m);
+    csr->dps.resize(m);
+    //reuse counts as the fill positions
+    for(int v = 0; v < n; v++)
+        counts[v] = csr->offsets[v];
+}
+
+static void AddEdge(DataPathCsr* csr, vector<int>& pos, int u, int v, DataPath* dp)
+{
+    int e = pos[u]++;
+    csr->neighbors[e] = v;
+    csr->bw[e] = dp->GetBw();
+    csr->latency[e] = dp->GetLatency();
+    csr->dps[e] = dp;
+}
+
+void DataPathGraph::Build()
+{
+    vertices.clear();
+    index.clear();
+    for(Component* c : subtree(root))
+    {
+        index[c] = vertices.size();
+        vertices.push_back(c);
+    }
+    int n = vertices.size();
+
+    //first pass: count the edges of each vertex, per type
+    vector<int> all_counts(n, 0);
+    map<int, vector<int>> type_counts;
+    for(int u = 0; u < n; u++)
+    {
+        ForEachEdge(vertices[u], index, [&](DataPath* dp, int){
+            all_counts[u]++;
+            auto it = type_counts.find(dp->GetDpType());
+            if(it == type_counts.end())
+                it = type_counts.emplace(dp->GetDpType(), vector<int>(n, 0)).first;
+            it->second[u]++;
+        });
+    }
+
+    //second pass: fill the arrays
+    FillCsr(&all, all_counts);
+    by_type.clear();
+    for(auto& [type, counts] : type_counts)
+        FillCsr(&by_type[type], counts);
+    for(int u = 0; u < n; u++)
+    {
+        ForEachEdge(vertices[u], index, [&](DataPath* dp, int v){
+            AddEdge(&all, all_counts, u, v, dp);
+            AddEdge(&by_type[dp->GetDpType()], type_counts[dp->GetDpType()], u, v, dp);
+        });
+    }
+    empty.offsets.assign(n + 1, 0);
+    path_cache.clear();
+
+    dp_version = DataPath::GetVersion();
+    dp_structure_version = DataPath::GetStructureVersion();
+    tree_epoch = root->GetTreeEpoch();
+    built = true;
+}
+
+int DataPathGraph::GetNumVertices()
+{
+    Refresh();
+    return vertices.size();
+}
+
+Component* DataPathGraph::GetComponent(int v)
+{
+    Refresh();
+    return vertices[v];
+}
+
+int DataPathGraph::GetIndex(Component* c)
+{
+    Refresh();
+    auto it = index.find(c);
+    if(it == index.end())
+        return -1;
+    return it->second;
+}
+
+DataPathCsr* DataPathGraph::GetCsr(int dp_type)
+{
+    Refresh();
+    if(dp_type == SYS_SAGE_DATAPATH_TYPE_ANY)
+        return &all;
+    auto it = by_type.find(dp_type);
+    if(it == by_type.end())
+        return &empty;
+    return &it->second;
+}
+
+vector<int> DataPathGraph::GetDpTypes()
+{
+    Refresh();
+    vector<int> ret;
+    for(auto& [type, csr] : by_type)
+        ret.push_back(type);
+    return ret;
+}
+
+Component* DataPathGraph::GetRoot(){return root;}
+
+#define PATH_QUERY_LOWEST_LATENCY 0
+#define PATH_QUERY_WIDEST 1
+#define PATH_QUERY_K_LOWEST_LATENCY 2
+
+//Dijkstra over the edges with a known (non-negative) latency, avoiding the banned vertices and edges
+double DataPathGraph::ShortestPath(DataPathCsr* csr, int src, int dst, vector<char>& banned_vertices, vector<char>& banned_edges, vector<int>* outEdges)
+{
+    int n = vertices.size();
+    vector<double> dist(n, std::numeric_limits<double>::infinity());
+    vector<int> pred(n, -1);
+    priority_queue<pair<double,int>, vector<pair<double,int>>, greater<pair<double,int>>> queue;
+    dist[src] = 0;
+    queue.push({0, src});
+    while(!queue.empty())
+    {
+        auto [d, u] = queue.top();
+        queue.pop();
+        if(d > dist[u])
+            continue;
+        if(u == dst)
+            break;
+        for(int e = csr->Begin(u); e < csr->End(u); e++)
+        {
+            int v = csr->neighbors[e];
+            if(csr->latency[e] < 0 || banned_edges[e] || banned_vertices[v])
+                continue;
+            double nd = d + csr->latency[e];
+            if(nd < dist[v])
+            {
+                dist[v] = nd;
+                pred[v] = e;
+                queue.push({nd, v});
+            }
+        }
+    }
+    if(dist[dst] == std::numeric_limits<double>::infinity())
+        return -1;
+    //walk back from dst; the source of edge e is the vertex u with Begin(u) <= e < End(u)
+    outEdges->clear();
+    for(int v = dst; v != src; )
+    {
+        int e = pred[v];
+        outEdges->push_back(e);
+        v = std::upper_bound(csr->offsets.begin(), csr->offsets.end(), e) - csr->offsets.begin() - 1;
+    }
+    std::reverse(outEdges->begin(), outEdges->end());
+    return dist[dst];
+}
+
+//Dijkstra variant maximizing the minimal bandwidth along the path
+double DataPathGraph::WidestPath(DataPathCsr* csr, int src, int dst, vector<int>* outEdges)
+{
+    int n = vertices.size();
+    vector<double> width(n, -1);
+    vector<int> pred(n, -1);
+    priority_queue<pair<double,int>> queue;
+    width[src] = std::numeric_limits<double>::infinity();
+    queue.push({width[src], src});
+    while(!queue.empty())
+    {
+        auto [w, u] = queue.top();
+        queue.pop();
+        if(w < width[u])
+            continue;
+        if(u == dst)
+            break;
+        for(int e = csr->Begin(u); e < csr->End(u); e++)
+        {
+            int v = csr->neighbors[e];
+            if(csr->bw[e] < 0)
+                continue;
+            double nw = std::min(w, csr->bw[e]);
+            if(nw > width[v])
+            {
+                width[v] = nw;
+                pred[v] = e;
+                queue.push({nw, v});
+            }
+        }
+    }
+    if(width[dst] < 0)
+        return -1;
+    outEdges->clear();
+    for(int v = dst; v != src; )
+    {
+        int e = pred[v];
+        outEdges->push_back(e);
+        v = std::upper_bound(csr->offsets.begin(), csr->offsets.end(), e) - csr->offsets.begin() - 1;
+    }
+    std::reverse(outEdges->begin(), outEdges->end());
+    return width[dst];
+}
+
+void DataPathGraph::YenKShortestPaths(DataPathCsr* csr, int src, int dst, int k, vector<pair<double, vector<int>>>* outPaths)
+{
+    int n = vertices.size();
+    vector<char> banned_vertices(n, 0);
+    vector<char> banned_edges(csr->GetNumEdges(), 0);
+    vector<int> edges;
+    double cost = ShortestPath(csr, src, dst, banned_vertices, banned_edges, &edges);
+    if(cost < 0)
+        return;
+    outPaths->push_back({cost, edges});
+
+    set<pair<double, vector<int>>> candidates;
+    while((int)outPaths->size() < k)
+    {
+        vector<int> prev = outPaths->back().second;
+        //deviate from the previous path at each of its vertices (the spur vertex)
+        int spur = src;
+        double root_cost = 0;
+        for(size_t i = 0; i < prev.size(); i++)
+        {
+            //ban the next edge of all found paths sharing the same root, and the vertices of the root
+            vector<int> banned;
+            for(auto& [c, path] : *outPaths)
+            {
+                if(path.size() > i && std::equal(prev.begin(), prev.begin() + i, path.begin()))
+                {
+                    banned_edges[path[i]] = 1;
+                    banned.push_back(path[i]);
+                }
+            }
+            vector<int> spur_edges;
+            double spur_cost = ShortestPath(csr, spur, dst, banned_vertices, banned_edges, &spur_edges);
+            if(spur_cost >= 0)
+            {
+                vector<int> path(prev.begin(), prev.begin() + i);
+                path.insert(path.end(), spur_edges.begin(), spur_edges.end());
+                candidates.insert({root_cost + spur_cost, path});
+            }
+            for(int e : banned)
+                banned_edges[e] = 0;
+            banned_vertices[spur] = 1;
+            root_cost += csr->latency[prev[i]];
+            spur = csr->neighbors[prev[i]];
+        }
+        banned_vertices[src] = 0;
+        for(size_t i = 0; i + 1 < prev.size(); i++)
+            banned_vertices[csr->neighbors[prev[i]]] = 0;
+
+        //take the best candidate not found yet
+        bool added = false;
+        while(!candidates.empty() && !added)
+        {
+            auto best = candidates.begin();
+            if(std::find_if(outPaths->begin(), outPaths->end(), [&](auto& p){ return p.second == best->second; }) == outPaths->end())
+            {
+                outPaths->push_back(*best);
+                added = true;
+            }
+            candidates.erase(best);
+        }
+        if(!added)
+            break;
+    }
+}
+
+vector<pair<double, vector<int>>>* DataPathGraph::FindPaths(int kind, Component* src, Component* dst, int k, int dp_type)
+{
+    int s = GetIndex(src);
+    int d = GetIndex(dst);
+    if(s < 0 || d < 0)
+        return NULL;
+    auto key = make_tuple(kind, dp_type, s, d, k);
+    auto it = path_cache.find(key);
+    if(it != path_cache.end())
+        return &it->second;
+
+    vector<pair<double, vector<int>>>& paths = path_cache[key];
+    DataPathCsr* csr = GetCsr(dp_type);
+    vector<int> edges;
+    double cost = -1;
+    if(kind == PATH_QUERY_LOWEST_LATENCY)
+    {
+        vector<char> banned_vertices(vertices.size(), 0);
+        vector<char> banned_edges(csr->GetNumEdges(), 0);
+        cost = ShortestPath(csr, s, d, banned_vertices, banned_edges, &edges);
+    }
+    else if(kind == PATH_QUERY_WIDEST)
+        cost = WidestPath(csr, s, d, &edges);
+    else
+        YenKShortestPaths(csr, s, d, k, &paths);
+    if(cost >= 0)
+        paths.push_back({cost, edges});
+    return &paths;
+}
+
+double DataPathGraph::GetLowestLatencyPath(Component* src, Component* dst, vector<DataPath*>* outPath, int dp_type)
+{
+    vector<pair<double, vector<int>>>* paths = FindPaths(PATH_QUERY_LOWEST_LATENCY, src, dst, 1, dp_type);
+    if(paths == NULL || paths->empty())
+        return -1;
+    DataPathCsr* csr = GetCsr(dp_type);
+    for(int e : paths->front().second)
+        outPath->push_back(csr->dps[e]);
+    return paths->front().first;
+}
+
+double DataPathGraph::GetWidestPath(Component* src, Component* dst, vector<DataPath*>* outPath, int dp_type)
+{
+    vector<pair<double, vector<int>>>* paths = FindPaths(PATH_QUERY_WIDEST, src, dst, 1, dp_type);
+    if(paths == NULL || paths->empty())
+        return -1;
+    DataPathCsr* csr = GetCsr(dp_type);
+    for(int e : paths->front().second)
+        outPath->push_back(csr->dps[e]);
+    return paths->front().first;
+}
+
+int DataPathGraph::GetKLowestLatencyPaths(Component* src, Component* dst, int k, vector<vector<DataPath*>>* outPaths, vector<double>* outLatencies, int dp_type)
+{
+    if(k <= 0)
+        return 0;
+    vector<pair<double, vector<int>>>* paths = FindPaths(PATH_QUERY_K_LOWEST_LATENCY, src, dst, k, dp_type);
+    if(paths == NULL)
+        return 0;
+    DataPathCsr* csr = GetCsr(dp_type);
+    for(auto& [cost, edges] : *paths)
+    {
+        vector<DataPath*> path;
+        for(int e : edges)
+            path.push_back(csr->dps[e]);
+        outPaths->push_back(path);
+        if(outLatencies != NULL)
+            outLatencies->push_back(cost);
+    }
+    return paths->size();
+}
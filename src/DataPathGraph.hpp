@@ -0,0 +1,145 @@
+#ifndef DATAPATH_GRAPH
+#define DATAPATH_GRAPH
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include <tuple>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+
+/**
+Compressed sparse row (CSR) adjacency of the DataPaths of one type (or of all types).
+\n The outgoing edges of the vertex v are stored at the positions [offsets[v], offsets[v+1]) of the arrays neighbors, bw, latency and dps. An oriented DataPath is an edge from its source to its target; a bidirectional DataPath is an edge in both directions.
+*/
+struct DataPathCsr {
+    vector<int> offsets; /**< offsets[v] = position of the first edge of vertex v; has GetNumVertices()+1 elements. */
+    vector<int> neighbors; /**< Vertex index of the other end of each edge. */
+    vector<double> bw; /**< Bandwidth of each edge (DataPath::GetBw()). */
+    vector<double> latency; /**< Latency of each edge (DataPath::GetLatency()). */
+    vector<DataPath*> dps; /**< The DataPath each edge comes from. */
+
+    /**
+    @returns number of edges
+    */
+    int GetNumEdges() { return neighbors.size(); }
+    /**
+    @returns position of the first outgoing edge of vertex v
+    */
+    int Begin(int v) { return offsets[v]; }
+    /**
+    @returns position after the last outgoing edge of vertex v
+    */
+    int End(int v) { return offsets[v+1]; }
+};
+
+/**
+Class DataPathGraph - a compiled, read-only view of the DataPath graph among the components of a subtree, for graph algorithms that would otherwise chase pointers through the DataPath vectors of the Components.
+\n The components of the subtree (in DFS pre-order) are the vertices, numbered 0..GetNumVertices()-1. The DataPaths are stored in compressed sparse row form (see DataPathCsr), partitioned by dp_type; DataPaths leading outside of the subtree are left out.
+\n The view is built lazily on the first query and rebuilt on the first query after any DataPath has been added or removed or the Component Tree of root has changed (see DataPath::GetStructureVersion() and Component::GetTreeEpoch()); if only bandwidths or latencies have changed (see DataPath::GetVersion()), the query just reloads them into the CSR arrays. Pointers and references returned by a query stay valid until the next rebuild.
+\n Routing queries (GetLowestLatencyPath(), GetWidestPath(), GetKLowestLatencyPaths()) run on the CSR arrays; their results are cached until the next rebuild.
+*/
+class DataPathGraph {
+public:
+    /**
+    Creates a (not yet built) view of the DataPaths among the components in the subtree of root.
+    @param root - root of the subtree; any component can be the root
+    */
+    DataPathGraph(Component* root);
+
+    /**
+    Rebuilds the view if any DataPath or the Component Tree of root has changed since the last build, or reloads the bandwidths and latencies if only they have changed. Called by all queries.
+    */
+    void Refresh();
+    /**
+    @returns true if the view has not been built yet or would be rebuilt (or its metrics reloaded) by the next query
+    */
+    bool IsStale();
+
+    /**
+    @returns number of vertices, i.e. components in the subtree of root
+    */
+    int GetNumVertices();
+    /**
+    @returns the component represented by vertex v
+    */
+    Component* GetComponent(int v);
+    /**
+    @returns index of the vertex representing component c, or -1 if c is not in the subtree of root
+    */
+    int GetIndex(Component* c);
+    /**
+    Retrieves the adjacency of the DataPaths of one type.
+    @param dp_type - the DataPath type, or SYS_SAGE_DATAPATH_TYPE_ANY for the DataPaths of all types
+    @return the adjacency (empty if there are no DataPaths of the type)
+    */
+    DataPathCsr* GetCsr(int dp_type = SYS_SAGE_DATAPATH_TYPE_ANY);
+    /**
+    @returns all DataPath types present in the view (in ascending order)
+    */
+    vector<int> GetDpTypes();
+    /**
+    @returns the root of the subtree
+    */
+    Component* GetRoot();
+
+    /**
+    Finds the path with the lowest total latency from src to dst (Dijkstra's algorithm). DataPaths with an unknown (negative) latency are not used.
+    \n Results are cached until the view is rebuilt.
+    @param src - the first component of the path
+    @param dst - the last component of the path
+    @param outPath - output parameter; the DataPaths of the path (from src to dst) are pushed back (nothing if no path exists)
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @return total latency of the path; -1 if there is no path or src or dst are not in the view
+    */
+    double GetLowestLatencyPath(Component* src, Component* dst, vector<DataPath*>* outPath, int dp_type = SYS_SAGE_DATAPATH_TYPE_ANY);
+    /**
+    Finds the path from src to dst with the highest bottleneck bandwidth, i.e. the path maximizing the minimal bandwidth of its DataPaths. DataPaths with an unknown (negative) bandwidth are not used.
+    \n Results are cached until the view is rebuilt.
+    @param src - the first component of the path
+    @param dst - the last component of the path
+    @param outPath - output parameter; the DataPaths of the path (from src to dst) are pushed back (nothing if no path exists)
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @return bandwidth of the path (the minimal bandwidth of its DataPaths; infinity if src == dst); -1 if there is no path or src or dst are not in the view
+    */
+    double GetWidestPath(Component* src, Component* dst, vector<DataPath*>* outPath, int dp_type = SYS_SAGE_DATAPATH_TYPE_ANY);
+    /**
+    Finds up to k loopless paths from src to dst with the lowest total latency (Yen's algorithm), in ascending order of the latency. DataPaths with an unknown (negative) latency are not used.
+    \n Results are cached until the view is rebuilt.
+    @param src - the first component of the paths
+    @param dst - the last component of the paths
+    @param k - maximal number of paths
+    @param outPaths - output parameter; the paths (each a vector of DataPaths from src to dst) are pushed back
+    @param outLatencies - (optional) output parameter; the total latencies of the paths are pushed back
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @return number of paths found
+    */
+    int GetKLowestLatencyPaths(Component* src, Component* dst, int k, vector<vector<DataPath*>>* outPaths, vector<double>* outLatencies = NULL, int dp_type = SYS_SAGE_DATAPATH_TYPE_ANY);
+
+private:
+    void Build();
+    void ReloadMetrics();
+    vector<pair<double, vector<int>>>* FindPaths(int kind, Component* src, Component* dst, int k, int dp_type);
+    double ShortestPath(DataPathCsr* csr, int src, int dst, vector<char>& banned_vertices, vector<char>& banned_edges, vector<int>* outEdges);
+    double WidestPath(DataPathCsr* csr, int src, int dst, vector<int>* outEdges);
+    void YenKShortestPaths(DataPathCsr* csr, int src, int dst, int k, vector<pair<double, vector<int>>>* outPaths);
+
+    Component* root; /**< Root of the subtree. */
+    uint64_t dp_version { 0 }; /**< DataPath::GetVersion() at the time of the last build or reload of the metrics. */
+    uint64_t dp_structure_version { 0 }; /**< DataPath::GetStructureVersion() at the time of the last build. */
+    uint64_t tree_epoch { 0 }; /**< Component::GetTreeEpoch() at the time of the last build. */
+    bool built { false }; /**< Was the view built at least once? */
+
+    vector<Component*> vertices; /**< Components of the subtree in DFS pre-order. */
+    unordered_map<Component*, int> index; /**< Component -> vertex index. */
+    DataPathCsr all; /**< Adjacency of the DataPaths of all types. */
+    map<int, DataPathCsr> by_type; /**< dp_type -> adjacency of the DataPaths of that type. */
+    DataPathCsr empty; /**< Returned for types without DataPaths. */
+    map<tuple<int, int, int, int, int>, vector<pair<double, vector<int>>>> path_cache; /**< (query kind, dp_type, src, dst, k) -> found paths (cost and CSR edge positions); cleared on every rebuild. */
+};
+
+#endif
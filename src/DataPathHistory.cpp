@@ -0,0 +1,104 @@
+#include "DataPathHistory.hpp"
+
+#include <algorithm>
+
+DataPathHistory::DataPathHistory(size_t _capacity, double _alpha): capacity(std::max<size_t>(_capacity, 1)), alpha(_alpha)
+{
+    samples.reserve(capacity);
+}
+
+void DataPathHistory::Add(double timestamp, double bw, double latency)
+{
+    DataPathSample s {timestamp, bw, latency};
+    if(samples.size() < capacity)
+        samples.push_back(s);
+    else
+    {
+        samples[head] = s;
+        head = (head + 1) % capacity;
+    }
+    num_added++;
+    if(bw >= 0)
+        Update(bw_summary, bw);
+    if(latency >= 0)
+        Update(latency_summary, latency);
+}
+
+void DataPathHistory::Update(Summary& s, double value)
+{
+    if(!s.known)
+    {
+        s.known = true;
+        s.min = s.max = s.ewma = value;
+        return;
+    }
+    s.min = std::min(s.min, value);
+    s.max = std::max(s.max, value);
+    s.ewma += alpha * (value - s.ewma);
+}
+
+void DataPathHistory::Clear()
+{
+    samples.clear();
+    head = 0;
+    num_added = 0;
+    bw_summary = Summary();
+    latency_summary = Summary();
+}
+
+size_t DataPathHistory::Size(){ return samples.size(); }
+size_t DataPathHistory::GetCapacity(){ return capacity; }
+uint64_t DataPathHistory::GetNumAdded(){ return num_added; }
+double DataPathHistory::GetAlpha(){ return alpha; }
+
+DataPathSample* DataPathHistory::Get(size_t i)
+{
+    if(i >= samples.size())
+        return NULL;
+    return &samples[(head + i) % samples.size()];
+}
+
+DataPathSample* DataPathHistory::GetLatest()
+{
+    if(samples.empty())
+        return NULL;
+    return Get(samples.size() - 1);
+}
+
+DataPathHistory::Summary* DataPathHistory::GetSummary(int metric)
+{
+    return (metric == SYS_SAGE_METRIC_BW) ? &bw_summary : &latency_summary;
+}
+double DataPathHistory::GetMin(int metric){ return GetSummary(metric)->min; }
+double DataPathHistory::GetMax(int metric){ return GetSummary(metric)->max; }
+double DataPathHistory::GetEwma(int metric){ return GetSummary(metric)->ewma; }
+
+double DataPathHistory::GetValue(const DataPathSample& s, int metric)
+{
+    return (metric == SYS_SAGE_METRIC_BW) ? s.bw : s.latency;
+}
+
+DataPathStats DataPathHistory::GetWindowStats(int metric, double from, double to)
+{
+    DataPathStats stats;
+    for(const DataPathSample& s : samples)
+    {
+        double value = GetValue(s, metric);
+        if(s.timestamp >= from && s.timestamp <= to && value >= 0)
+            stats.Add(value);
+    }
+    return stats;
+}
+
+DataPathStats DataPathHistory::GetLatestStats(int metric, size_t n)
+{
+    DataPathStats stats;
+    size_t size = samples.size();
+    for(size_t i = size - std::min(n, size); i < size; i++)
+    {
+        double value = GetValue(*Get(i), metric);
+        if(value >= 0)
+            stats.Add(value);
+    }
+    return stats;
+}
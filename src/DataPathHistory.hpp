@@ -0,0 +1,121 @@
+#ifndef DATAPATH_HISTORY
+#define DATAPATH_HISTORY
+
+#include <vector>
+
+#include "DataPath.hpp"
+#include "DataPathRollup.hpp"
+
+using namespace std;
+
+/**
+One measurement of the bandwidth and latency of a DataPath.
+*/
+struct DataPathSample {
+    double timestamp; /**< Time of the measurement (user-defined unit, e.g. seconds since the epoch). */
+    double bw; /**< Measured bandwidth; negative if unknown. */
+    double latency; /**< Measured latency; negative if unknown. */
+};
+
+/**
+Class DataPathHistory - bounded time series of the bandwidth and latency of a DataPath (see DataPath::EnableHistory()), e.g. to track the drift of the inter-NUMA bandwidth over repeated benchmark runs.
+\n The last GetCapacity() samples are kept in a ring buffer; older samples are overwritten. In addition, the minimum, maximum and exponentially weighted moving average (EWMA) of each metric are updated with each sample, covering all samples ever added. Unknown (negative) values of a metric are left out of its summaries.
+*/
+class DataPathHistory {
+public:
+    /**
+    Creates an empty history.
+    @param _capacity - number of samples kept (at least 1)
+    @param _alpha - weight of a new sample in the EWMA, in (0, 1]
+    */
+    DataPathHistory(size_t _capacity, double _alpha = SYS_SAGE_DATAPATH_HISTORY_EWMA_ALPHA);
+
+    /**
+    Adds a sample, overwriting the oldest one if the history is full, and updates the summaries.
+    */
+    void Add(double timestamp, double bw, double latency);
+    /**
+    Removes all samples and resets the summaries.
+    */
+    void Clear();
+    /**
+    @returns number of samples kept (at most GetCapacity())
+    */
+    size_t Size();
+    /**
+    @returns maximal number of samples kept
+    */
+    size_t GetCapacity();
+    /**
+    @returns number of samples added since the creation (or the last Clear()) of the history, including the overwritten ones
+    */
+    uint64_t GetNumAdded();
+    /**
+    @returns weight of a new sample in the EWMA
+    */
+    double GetAlpha();
+    /**
+    Retrieves a kept sample.
+    @param i - index of the sample; 0 is the oldest kept sample, Size()-1 the latest
+    @return pointer to the sample; NULL if i is out of range. Valid until the next Add().
+    */
+    DataPathSample* Get(size_t i);
+    /**
+    @returns pointer to the latest sample; NULL if the history is empty. Valid until the next Add().
+    */
+    DataPathSample* GetLatest();
+    /**
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    @returns smallest known value of the metric over all added samples; -1 if there is none
+    */
+    double GetMin(int metric);
+    /**
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    @returns largest known value of the metric over all added samples; -1 if there is none
+    */
+    double GetMax(int metric);
+    /**
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    @returns exponentially weighted moving average of the known values of the metric over all added samples (the first value initializes it); -1 if there is none
+    */
+    double GetEwma(int metric);
+    /**
+    Aggregates the known values of a metric of the kept samples within a time window.
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    @param from - start of the window (inclusive)
+    @param to - end of the window (inclusive)
+    @return statistics of the values (count 0 if there are none)
+    */
+    DataPathStats GetWindowStats(int metric, double from, double to);
+    /**
+    Aggregates the known values of a metric of the latest n kept samples.
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    @param n - number of samples (all kept samples if there are fewer)
+    @return statistics of the values (count 0 if there are none)
+    */
+    DataPathStats GetLatestStats(int metric, size_t n);
+
+private:
+    /**
+    Incrementally maintained summary of one metric.
+    */
+    struct Summary {
+        bool known { false };
+        double min { -1 };
+        double max { -1 };
+        double ewma { -1 };
+    };
+    void Update(Summary& s, double value);
+    Summary* GetSummary(int metric);
+    static double GetValue(const DataPathSample& s, int metric);
+
+    vector<DataPathSample> samples; /**< Ring buffer; grows up to capacity. */
+    size_t capacity;
+    size_t head { 0 }; /**< Index of the oldest sample once the ring buffer is full. */
+    uint64_t num_added { 0 };
+    double alpha;
+    Summary bw_summary;
+    Summary latency_summary;
+};
+
+#endif
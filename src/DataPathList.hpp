@@ -0,0 +1,75 @@
+#ifndef DATAPATH_LIST
+#define DATAPATH_LIST
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+using namespace std;
+class DataPath;
+
+/**
+Read-only view of the DataPaths of a Component in one direction (see Component::GetDataPathList()): the oriented DataPaths in that direction, followed by the bidirectional DataPaths of the Component.
+\n The view does not copy anything; it shows the current content of the lists of the Component (adding or removing DataPaths of the Component invalidates its iterators).
+*/
+class DataPathList {
+public:
+    /**
+    Forward iterator over the DataPaths of a DataPathList.
+    */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = DataPath*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = DataPath* const*;
+        using reference = DataPath* const&;
+
+        iterator() = default;
+        iterator(const vector<DataPath*>* _oriented, const vector<DataPath*>* _bidirectional, size_t _pos) : oriented(_oriented), bidirectional(_bidirectional), pos(_pos) {}
+        reference operator*() const { return (pos < oriented->size()) ? (*oriented)[pos] : (*bidirectional)[pos - oriented->size()]; }
+        iterator& operator++() { pos++; return *this; }
+        iterator operator++(int) { iterator ret = *this; pos++; return ret; }
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+    private:
+        const vector<DataPath*>* oriented { nullptr };
+        const vector<DataPath*>* bidirectional { nullptr };
+        size_t pos { 0 };
+    };
+
+    /**
+    Creates an empty list.
+    */
+    DataPathList();
+    /**
+    Creates a view of two lists of DataPaths.
+    @param _oriented - the oriented DataPaths
+    @param _bidirectional - the bidirectional DataPaths
+    */
+    DataPathList(const vector<DataPath*>* _oriented, const vector<DataPath*>* _bidirectional);
+
+    iterator begin() const { return iterator(oriented, bidirectional, 0); }
+    iterator end() const { return iterator(oriented, bidirectional, size()); }
+    /**
+    @returns number of DataPaths in the list
+    */
+    size_t size() const { return oriented->size() + bidirectional->size(); }
+    /**
+    @returns true if there are no DataPaths in the list
+    */
+    bool empty() const { return size() == 0; }
+    /**
+    @returns the i-th DataPath of the list
+    */
+    DataPath* operator[](size_t i) const { return (i < oriented->size()) ? (*oriented)[i] : (*bidirectional)[i - oriented->size()]; }
+    /**
+    @returns true if the list contains the same DataPaths as other, in the same order
+    */
+    bool operator==(const vector<DataPath*>& other) const;
+
+private:
+    const vector<DataPath*>* oriented;
+    const vector<DataPath*>* bidirectional;
+};
+
+#endif
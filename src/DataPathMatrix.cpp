@@ -0,0 +1,151 @@
+#include "DataPathMatrix.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+bool DataPathMatrixEntry::IsValid(){ return matrix != NULL && src >= 0 && dst >= 0 && matrix->Has(src, dst); }
+//the getters of an entry that does not exist (e.g. found by DataPathMatrix::GetDataPath() for components not in the matrix) return NULL or -1
+Component* DataPathMatrixEntry::GetSource(){ return IsValid() ? (*matrix->GetComponents())[src] : NULL; }
+Component* DataPathMatrixEntry::GetTarget(){ return IsValid() ? (*matrix->GetComponents())[dst] : NULL; }
+double DataPathMatrixEntry::GetBw(){ return IsValid() ? matrix->GetBw(src, dst) : -1; }
+double DataPathMatrixEntry::GetLatency(){ return IsValid() ? matrix->GetLatency(src, dst) : -1; }
+int DataPathMatrixEntry::GetDpType(){ return (matrix != NULL) ? matrix->GetDpType() : -1; }
+int DataPathMatrixEntry::GetOriented(){ return (matrix != NULL) ? matrix->GetOriented() : -1; }
+float DataPathMatrixEntry::GetMetric(const string& name)
+{
+    if(!IsValid())
+        return -1;
+    int metric = matrix->GetMetricIndex(name);
+    if(metric < 0)
+        return std::numeric_limits<float>::quiet_NaN();
+    return matrix->GetMetric(metric, src, dst);
+}
+
+void DataPathMatrixList::iterator::Skip()
+{
+    int size = (list->matrix == NULL) ? 0 : list->matrix->GetSize();
+    while(pos < size && !list->Has(pos))
+        pos++;
+}
+DataPathMatrixList::iterator DataPathMatrixList::end() const
+{
+    return iterator(this, (matrix == NULL) ? 0 : matrix->GetSize());
+}
+size_t DataPathMatrixList::size() const
+{
+    return std::distance(begin(), end());
+}
+bool DataPathMatrixList::Has(int pos) const
+{
+    return (orientation == SYS_SAGE_DATAPATH_OUTGOING) ? matrix->Has(index, pos) : matrix->Has(pos, index);
+}
+DataPathMatrixEntry DataPathMatrixList::Entry(int pos) const
+{
+    return (orientation == SYS_SAGE_DATAPATH_OUTGOING) ? DataPathMatrixEntry(matrix, index, pos) : DataPathMatrixEntry(matrix, pos, index);
+}
+
+DataPathMatrix::DataPathMatrix(Component* _owner, vector<Component*> _components, int _dp_type, int _oriented): owner(_owner), components(_components), dp_type(_dp_type), oriented(_oriented)
+{
+    for(size_t i = 0; i < components.size(); i++)
+        index[components[i]] = i;
+    size_t n = components.size() * components.size();
+    exists.assign(n, 0);
+    bw.assign(n, -1);
+    latency.assign(n, -1);
+    owner->AddDataPathMatrix(this);
+}
+
+DataPathMatrix::~DataPathMatrix()
+{
+    if(owner != NULL)
+        owner->RemoveDataPathMatrix(this);
+}
+
+Component* DataPathMatrix::GetOwner(){ return owner; }
+int DataPathMatrix::GetDpType(){ return dp_type; }
+int DataPathMatrix::GetOriented(){ return oriented; }
+int DataPathMatrix::GetSize(){ return components.size(); }
+vector<Component*>* DataPathMatrix::GetComponents(){ return &components; }
+int DataPathMatrix::GetIndex(Component* c)
+{
+    auto it = index.find(c);
+    return (it == index.end()) ? -1 : it->second;
+}
+
+int DataPathMatrix::AddMetric(const string& name)
+{
+    int metric = GetMetricIndex(name);
+    if(metric >= 0)
+        return metric;
+    metric_names.push_back(name);
+    metrics.emplace_back(exists.size(), std::numeric_limits<float>::quiet_NaN());
+    return metrics.size() - 1;
+}
+int DataPathMatrix::GetMetricIndex(const string& name)
+{
+    auto it = std::find(metric_names.begin(), metric_names.end(), name);
+    return (it == metric_names.end()) ? -1 : it - metric_names.begin();
+}
+vector<string> DataPathMatrix::GetMetricNames(){ return metric_names; }
+
+void DataPathMatrix::Set(int src, int dst, double _bw, double _latency)
+{
+    size_t p = Pos(src, dst);
+    num_data_paths += !exists[p];
+    exists[p] = 1;
+    bw[p] = _bw;
+    latency[p] = _latency;
+    if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL && src != dst)
+    {
+        p = Pos(dst, src);
+        num_data_paths += !exists[p];
+        exists[p] = 1;
+        bw[p] = _bw;
+        latency[p] = _latency;
+    }
+}
+int DataPathMatrix::Set(Component* source, Component* target, double _bw, double _latency)
+{
+    int src = GetIndex(source), dst = GetIndex(target);
+    if(src < 0 || dst < 0)
+        return 1;
+    Set(src, dst, _bw, _latency);
+    return 0;
+}
+void DataPathMatrix::SetMetric(int metric, int src, int dst, float value)
+{
+    metrics[metric][Pos(src, dst)] = value;
+    if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        metrics[metric][Pos(dst, src)] = value;
+}
+void DataPathMatrix::Remove(int src, int dst)
+{
+    size_t p = Pos(src, dst);
+    num_data_paths -= exists[p];
+    exists[p] = 0;
+    if(oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL && src != dst)
+    {
+        p = Pos(dst, src);
+        num_data_paths -= exists[p];
+        exists[p] = 0;
+    }
+}
+bool DataPathMatrix::Has(int src, int dst){ return exists[Pos(src, dst)]; }
+double DataPathMatrix::GetBw(int src, int dst){ return bw[Pos(src, dst)]; }
+double DataPathMatrix::GetLatency(int src, int dst){ return latency[Pos(src, dst)]; }
+float DataPathMatrix::GetMetric(int metric, int src, int dst){ return metrics[metric][Pos(src, dst)]; }
+int DataPathMatrix::GetNumDataPaths(){ return num_data_paths; }
+
+DataPathMatrixEntry DataPathMatrix::GetDataPath(Component* source, Component* target)
+{
+    return DataPathMatrixEntry(this, GetIndex(source), GetIndex(target));
+}
+
+DataPathMatrixList DataPathMatrix::GetDataPaths(Component* c, int orientation)
+{
+    int i = GetIndex(c);
+    if(i < 0 || (orientation != SYS_SAGE_DATAPATH_OUTGOING && orientation != SYS_SAGE_DATAPATH_INCOMING))
+        return DataPathMatrixList();
+    return DataPathMatrixList(this, i, orientation);
+}
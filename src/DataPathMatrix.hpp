@@ -0,0 +1,258 @@
+#ifndef DATAPATH_MATRIX
+#define DATAPATH_MATRIX
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+using namespace std;
+class DataPathMatrix;
+
+/**
+Read-only view of one entry of a DataPathMatrix, offering the getters of a DataPath. The view is created on demand and only refers to the matrix; it is valid as long as the matrix exists.
+*/
+class DataPathMatrixEntry {
+public:
+    DataPathMatrixEntry() = default;
+    DataPathMatrixEntry(DataPathMatrix* _matrix, int _src, int _dst) : matrix(_matrix), src(_src), dst(_dst) {}
+    /**
+    @returns true if the entry exists in the matrix (i.e. the matrix holds a DataPath from the source to the target)
+    */
+    bool IsValid();
+    /**
+    @returns Pointer to the source Component; NULL if the entry is not valid (see IsValid())
+    */
+    Component* GetSource();
+    /**
+    @returns Pointer to the target Component; NULL if the entry is not valid
+    */
+    Component* GetTarget();
+    /**
+    @returns Bandwidth from the source to the target; -1 if the entry is not valid
+    */
+    double GetBw();
+    /**
+    @returns Data load latency from the source to the target; -1 if the entry is not valid
+    */
+    double GetLatency();
+    /**
+    @returns Type of the DataPaths of the matrix; -1 if the entry has no matrix
+    */
+    int GetDpType();
+    /**
+    @returns Orientation of the DataPaths of the matrix (SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL); -1 if the entry has no matrix
+    */
+    int GetOriented();
+    /**
+    @returns Value of an additional metric of the matrix (see DataPathMatrix::AddMetric()); NaN if the matrix has no such metric; -1 if the entry is not valid
+    */
+    float GetMetric(const string& name);
+    /**
+    @returns row (source index) of the entry in the matrix
+    */
+    int GetSourceIndex() { return src; }
+    /**
+    @returns column (target index) of the entry in the matrix
+    */
+    int GetTargetIndex() { return dst; }
+private:
+    DataPathMatrix* matrix { nullptr };
+    int src { -1 };
+    int dst { -1 };
+};
+
+/**
+Lazy view of the entries of a DataPathMatrix leading from (or to) one component -- the counterpart of Component::GetDataPathList() for DataPaths stored in a matrix. Iterating yields DataPathMatrixEntry views of the existing entries of one row (or column) of the matrix.
+*/
+class DataPathMatrixList {
+public:
+    /**
+    Forward iterator over the existing entries of a DataPathMatrixList.
+    */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = DataPathMatrixEntry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = DataPathMatrixEntry;
+
+        iterator() = default;
+        iterator(const DataPathMatrixList* _list, int _pos) : list(_list), pos(_pos) { Skip(); }
+        DataPathMatrixEntry operator*() const { return list->Entry(pos); }
+        iterator& operator++() { pos++; Skip(); return *this; }
+        iterator operator++(int) { iterator ret = *this; ++(*this); return ret; }
+        bool operator==(const iterator& other) const { return pos == other.pos; }
+    private:
+        void Skip();
+        const DataPathMatrixList* list { nullptr };
+        int pos { 0 };
+    };
+
+    /**
+    Creates an empty list.
+    */
+    DataPathMatrixList() = default;
+    /**
+    Creates a view of the row (SYS_SAGE_DATAPATH_OUTGOING) or column (SYS_SAGE_DATAPATH_INCOMING) of the matrix belonging to the component with the given index.
+    */
+    DataPathMatrixList(DataPathMatrix* _matrix, int _index, int _orientation) : matrix(_matrix), index(_index), orientation(_orientation) {}
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const;
+    /**
+    @returns number of existing entries in the list (counted on each call)
+    */
+    size_t size() const;
+    /**
+    @returns true if there are no entries in the list
+    */
+    bool empty() const { return begin() == end(); }
+
+private:
+    bool Has(int pos) const;
+    DataPathMatrixEntry Entry(int pos) const;
+    DataPathMatrix* matrix { nullptr };
+    int index { -1 };
+    int orientation { 0 };
+};
+
+/**
+Class DataPathMatrix - DataPaths of one type among all pairs of a set of components (e.g. the core-to-core latencies measured by cccbench), stored densely instead of as N^2 DataPath objects.
+\n The matrix holds for each pair (source, target) whether the DataPath exists, its bandwidth and latency, and the values of any number of additional float metrics (e.g. "latency_min", "latency_max"). Single entries are accessed through DataPathMatrixEntry views (see GetDataPath(), GetDataPaths()), which offer the getters of a DataPath.
+\n A matrix is attached to an owner component (e.g. the Node), which lists it in Component::GetDataPathMatrices() and deletes it when it is deleted itself; exportToXml() exports the matrices attached to the exported components. The components of the matrix must outlive it.
+*/
+class DataPathMatrix {
+public:
+    /**
+    Creates an empty matrix (no DataPaths exist yet) and attaches it to the owner.
+    @param _owner - the component the matrix is attached to
+    @param _components - the components of the matrix; component i is the source of row i and the target of column i
+    @param _dp_type - type of the DataPaths (see DataPath::GetDpType())
+    @param _oriented - SYS_SAGE_DATAPATH_ORIENTED, or SYS_SAGE_DATAPATH_BIDIRECTIONAL for a symmetric matrix (setting an entry sets its mirrored entry, too)
+    */
+    DataPathMatrix(Component* _owner, vector<Component*> _components, int _dp_type, int _oriented = SYS_SAGE_DATAPATH_ORIENTED);
+    /**
+    Detaches the matrix from its owner and releases it.
+    */
+    ~DataPathMatrix();
+    DataPathMatrix(const DataPathMatrix&) = delete;
+    DataPathMatrix& operator=(const DataPathMatrix&) = delete;
+
+    /**
+    @returns the component the matrix is attached to
+    */
+    Component* GetOwner();
+    /**
+    @returns type of the DataPaths
+    */
+    int GetDpType();
+    /**
+    @returns orientation of the DataPaths (SYS_SAGE_DATAPATH_ORIENTED or SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+    */
+    int GetOriented();
+    /**
+    @returns number of components (rows, columns) of the matrix
+    */
+    int GetSize();
+    /**
+    @returns the components of the matrix
+    */
+    vector<Component*>* GetComponents();
+    /**
+    @returns index of component c in the matrix; -1 if it is not a component of the matrix
+    */
+    int GetIndex(Component* c);
+
+    /**
+    Adds an additional float metric to all entries of the matrix (initially NaN).
+    @param name - name of the metric
+    @return index of the metric (the existing one if the name is already used)
+    */
+    int AddMetric(const string& name);
+    /**
+    @returns index of the metric with the given name; -1 if there is none
+    */
+    int GetMetricIndex(const string& name);
+    /**
+    @returns names of the additional metrics, in the order of their indices
+    */
+    vector<string> GetMetricNames();
+
+    /**
+    Creates (or overwrites) the DataPath from the component with index src to the component with index dst.
+    */
+    void Set(int src, int dst, double bw, double latency);
+    /**
+    Creates (or overwrites) the DataPath from source to target.
+    @return 0 on success; 1 if source or target are not components of the matrix
+    */
+    int Set(Component* source, Component* target, double bw, double latency);
+    /**
+    Sets the value of an additional metric of the entry [src][dst] (see AddMetric()).
+    */
+    void SetMetric(int metric, int src, int dst, float value);
+    /**
+    Removes the DataPath from the component with index src to the component with index dst.
+    */
+    void Remove(int src, int dst);
+    /**
+    @returns true if the DataPath from the component with index src to the component with index dst exists
+    */
+    bool Has(int src, int dst);
+    /**
+    @returns bandwidth of the entry [src][dst]
+    */
+    double GetBw(int src, int dst);
+    /**
+    @returns latency of the entry [src][dst]
+    */
+    double GetLatency(int src, int dst);
+    /**
+    @returns value of an additional metric of the entry [src][dst]
+    */
+    float GetMetric(int metric, int src, int dst);
+    /**
+    @returns number of existing DataPaths in the matrix (for a bidirectional matrix, each pair is counted once per direction)
+    */
+    int GetNumDataPaths();
+
+    /**
+    @returns view of the DataPath from source to target (invalid, see DataPathMatrixEntry::IsValid(), if there is none)
+    */
+    DataPathMatrixEntry GetDataPath(Component* source, Component* target);
+    /**
+    Returns the DataPaths of the matrix leading from (SYS_SAGE_DATAPATH_OUTGOING) or to (SYS_SAGE_DATAPATH_INCOMING) component c; see Component::GetDataPathList().
+    @return lazy view of the entries; empty if c is not a component of the matrix or the orientation is not valid
+    */
+    DataPathMatrixList GetDataPaths(Component* c, int orientation);
+
+    /**
+    Writes the XML representation of the matrix to the writer (used by exportToXml()): a "datapath-matrix" element with the attributes owner, dp_type, oriented, size and endpoints (addresses of the components), and one "metric" child per metric (bw, latency and the additional metrics) listing the values row by row; missing entries are NaN.
+    */
+    void WriteXml(xmlTextWriterPtr writer);
+
+private:
+    size_t Pos(int src, int dst) { return (size_t)src * components.size() + dst; }
+
+    Component* owner; /**< The component the matrix is attached to. */
+    vector<Component*> components; /**< Components of the rows and columns. */
+    unordered_map<Component*, int> index; /**< Component -> its row/column. */
+    int dp_type;
+    int oriented;
+    int num_data_paths { 0 }; /**< Number of set entries of exists. */
+    vector<uint8_t> exists; /**< Does the entry [src][dst] exist? Row by row. */
+    vector<double> bw; /**< Bandwidth of each entry, row by row. */
+    vector<double> latency; /**< Latency of each entry, row by row. */
+    vector<string> metric_names; /**< Names of the additional metrics. */
+    vector<vector<float>> metrics; /**< Values of the additional metrics, each row by row. */
+
+    friend class Component;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "DataPathRollup.hpp"
+
+#include "Traversal.hpp"
+
+#include <thread>
+#include <algorithm>
+
+void DataPathStats::Add(double value)
+{
+    if(count == 0 || value < min)
+        min = value;
+    if(count == 0 || value > max)
+        max = value;
+    sum += value;
+    count++;
+}
+
+void DataPathStats::Merge(const DataPathStats& other)
+{
+    if(other.count == 0)
+        return;
+    if(count == 0 || other.min < min)
+        min = other.min;
+    if(count == 0 || other.max > max)
+        max = other.max;
+    sum += other.sum;
+    count += other.count;
+}
+
+double DataPathStats::GetMean()
+{
+    return (count == 0) ? 0 : sum / count;
+}
+
+DataPathRollup::DataPathRollup(Component* _root, int _groupType, int _dp_type, int _metric): root(_root), groupType(_groupType), dp_type(_dp_type), metric(_metric) {}
+
+DataPathRollup::DataPathRollup(Component* _root, vector<Component*> _groups, int _dp_type, int _metric): root(_root), groupType(0), dp_type(_dp_type), metric(_metric), groups(_groups) {}
+
+bool DataPathRollup::IsStale()
+{
+    return !built || tree_epoch != root->GetTreeEpoch() || dp_version != DataPath::GetVersion();
+}
+
+void DataPathRollup::Refresh()
+{
+    if(!built || tree_epoch != root->GetTreeEpoch())
+        Build();
+    else if(dp_version != DataPath::GetVersion())
+        Update();
+}
+
+void DataPathRollup::Build()
+{
+    tree_epoch = root->GetTreeEpoch();
+    dp_version = DataPath::GetVersion();
+    built = true;
+
+    //explicitly given groups are kept (in DFS pre-order) as long as they are in the subtree
+    std::set<Component*> given(groups.begin(), groups.end());
+    groups.clear();
+    group_of.clear();
+    members.clear();
+    member_group.clear();
+    group_members.clear();
+    for(Component* c : subtree(root))
+    {
+        int g = -1;
+        if(groupType > 0 ? c->GetComponentType() == groupType : given.count(c) > 0)
+        {
+            g = groups.size();
+            groups.push_back(c);
+            group_members.emplace_back();
+        }
+        else if(c != root)
+        {
+            auto it = group_of.find(c->GetParent());
+            if(it != group_of.end())
+                g = it->second;
+        }
+        if(g < 0)
+            continue;
+        group_of[c] = g;
+        group_members[g].push_back(members.size());
+        members.push_back(c);
+        member_group.push_back(g);
+    }
+
+    partials.assign(members.size(), {});
+    vector<int> all(members.size());
+    for(size_t m = 0; m < members.size(); m++)
+        all[m] = m;
+    Scan(all);
+    num_rescanned = members.size();
+
+    rows.assign(groups.size(), {});
+    for(size_t g = 0; g < groups.size(); g++)
+        Aggregate(g);
+}
+
+void DataPathRollup::Update()
+{
+    vector<int> changed;
+    for(size_t m = 0; m < members.size(); m++)
+    {
+        if(members[m]->GetDataPathStamp() > dp_version)
+            changed.push_back(m);
+    }
+    dp_version = DataPath::GetVersion();
+    Scan(changed);
+    num_rescanned = changed.size();
+
+    std::set<int> dirty;
+    for(int m : changed)
+        dirty.insert(member_group[m]);
+    for(int g : dirty)
+        Aggregate(g);
+}
+
+void DataPathRollup::Scan(vector<int>& todo)
+{
+    //each worker only reads the topology and writes the partials of its own members
+    auto scan_range = [this, &todo](size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; i++)
+        {
+            int m = todo[i];
+            Component* c = members[m];
+            map<int, DataPathStats> per_group;
+            DataPathList dps = (dp_type == SYS_SAGE_DATAPATH_TYPE_ANY) ? c->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING) : c->GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_OUTGOING);
+            for(DataPath* dp : dps)
+            {
+                if(excluded_types.count(dp->GetDpType()) > 0)
+                    continue;
+                Component* other = dp->GetTarget();
+                if(dp->GetOriented() == SYS_SAGE_DATAPATH_BIDIRECTIONAL && other == c)
+                    other = dp->GetSource();
+                auto it = group_of.find(other);
+                if(it == group_of.end())
+                    continue;
+                double value = (metric == SYS_SAGE_METRIC_BW) ? dp->GetBw() : dp->GetLatency();
+                if(value < 0)
+                    continue;
+                per_group[it->second].Add(value);
+            }
+            partials[m].assign(per_group.begin(), per_group.end());
+        }
+    };
+
+    size_t num_threads = (max_threads > 0) ? max_threads : std::thread::hardware_concurrency();
+    num_threads = std::max<size_t>(1, std::min<size_t>(num_threads, todo.size() / SYS_SAGE_ROLLUP_MIN_COMPONENTS_PER_THREAD));
+    if(num_threads == 1)
+    {
+        scan_range(0, todo.size());
+        return;
+    }
+    vector<std::thread> workers;
+    size_t chunk = (todo.size() + num_threads - 1) / num_threads;
+    for(size_t begin = 0; begin < todo.size(); begin += chunk)
+        workers.emplace_back(scan_range, begin, std::min(begin + chunk, todo.size()));
+    for(std::thread& w : workers)
+        w.join();
+}
+
+void DataPathRollup::Aggregate(int group)
+{
+    map<int, DataPathStats>& row = rows[group];
+    row.clear();
+    for(int m : group_members[group])
+    {
+        for(auto& [dst, stats] : partials[m])
+            row[dst].Merge(stats);
+    }
+}
+
+vector<Component*>* DataPathRollup::GetGroups()
+{
+    Refresh();
+    return &groups;
+}
+
+DataPathStats* DataPathRollup::GetStats(Component* srcGroup, Component* dstGroup)
+{
+    Refresh();
+    auto src = group_of.find(srcGroup);
+    auto dst = group_of.find(dstGroup);
+    if(src == group_of.end() || dst == group_of.end() || groups[src->second] != srcGroup || groups[dst->second] != dstGroup)
+        return NULL;
+    auto it = rows[src->second].find(dst->second);
+    if(it == rows[src->second].end())
+        return NULL;
+    return &it->second;
+}
+
+int DataPathRollup::CreateDataPaths(int new_dp_type, int stat)
+{
+    if(stat != SYS_SAGE_ROLLUP_MIN && stat != SYS_SAGE_ROLLUP_MEAN && stat != SYS_SAGE_ROLLUP_MAX)
+    {
+        cerr << "DataPathRollup::CreateDataPaths: unknown statistic " << stat << endl;
+        return -1;
+    }
+    Refresh();
+    //DataPaths of the type may already have been rolled up
+    if(excluded_types.insert(new_dp_type).second && dp_type == SYS_SAGE_DATAPATH_TYPE_ANY)
+        built = false;
+    int created = 0;
+    for(size_t g = 0; g < groups.size(); g++)
+    {
+        for(auto& [dst, stats] : rows[g])
+        {
+            double value = (stat == SYS_SAGE_ROLLUP_MIN) ? stats.min : (stat == SYS_SAGE_ROLLUP_MAX) ? stats.max : stats.GetMean();
+            //refreshing the roll-up updates the DataPaths created before
+            DataPath* dp;
+            if(metric == SYS_SAGE_METRIC_BW)
+                dp = UpsertDataPath(groups[g], groups[dst], SYS_SAGE_DATAPATH_ORIENTED, new_dp_type, value, -1);
+            else
+                dp = UpsertDataPath(groups[g], groups[dst], SYS_SAGE_DATAPATH_ORIENTED, new_dp_type, -1, value);
+            dp->attrib.Set<int>("count", stats.count);
+            created++;
+        }
+    }
+    return created;
+}
+
+int DataPathRollup::GetNumRescanned(){ return num_rescanned; }
+void DataPathRollup::SetNumThreads(int num_threads){ max_threads = num_threads; }
@@ -0,0 +1,133 @@
+#ifndef DATAPATH_ROLLUP
+#define DATAPATH_ROLLUP
+
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+#include "MetricMatrix.hpp"
+
+#define SYS_SAGE_ROLLUP_MIN 1 /**< Aggregate DataPaths created by DataPathRollup::CreateDataPaths() carry the minimum of the rolled-up values. */
+#define SYS_SAGE_ROLLUP_MEAN 2 /**< Aggregate DataPaths created by DataPathRollup::CreateDataPaths() carry the mean of the rolled-up values. */
+#define SYS_SAGE_ROLLUP_MAX 3 /**< Aggregate DataPaths created by DataPathRollup::CreateDataPaths() carry the maximum of the rolled-up values. */
+
+#define SYS_SAGE_ROLLUP_MIN_COMPONENTS_PER_THREAD 256 /**< DataPathRollup only starts another thread for every this many components to scan. */
+
+using namespace std;
+
+/**
+Minimum, maximum, sum and count of a set of DataPath metric values.
+*/
+struct DataPathStats {
+    int count { 0 }; /**< Number of values. */
+    double min { 0 }; /**< Smallest value (valid if count > 0). */
+    double max { 0 }; /**< Largest value (valid if count > 0). */
+    double sum { 0 }; /**< Sum of the values. */
+
+    /**
+    Adds a value.
+    */
+    void Add(double value);
+    /**
+    Adds all values of other.
+    */
+    void Merge(const DataPathStats& other);
+    /**
+    @returns mean of the values (0 if there are none)
+    */
+    double GetMean();
+};
+
+/**
+Class DataPathRollup - aggregates the DataPaths between components of a subtree up to the level of their ancestors, e.g. the core-to-core SYS_SAGE_DATAPATH_TYPE_C2C latencies to socket-to-socket latencies, so that coarse placement decisions do not have to scan all N^2 DataPaths.
+\n Each component of the subtree belongs to its closest group, i.e. the closest ancestor (or the component itself) that is one of the group components. For each pair of groups (A, B), the rollup keeps the statistics (DataPathStats) of the metric of all DataPaths leading from a component of A to a component of B; bidirectional DataPaths count in both directions, DataPaths with an unknown (negative) value of the metric are left out.
+\n The rollup is built lazily on the first query. Later queries only rescan the DataPaths of the components whose DataPaths have been added or removed since (see Component::GetDataPathStamp()) and only re-aggregate the affected groups; a change of the Component Tree of root causes a full rebuild. Scanning runs in parallel (see SetNumThreads()).
+*/
+class DataPathRollup {
+public:
+    /**
+    Creates a (not yet built) rollup of the DataPaths in the subtree of root to the components of type groupType.
+    @param root - root of the subtree
+    @param groupType - component type of the groups (e.g. SYS_SAGE_COMPONENT_CHIP); each component is rolled up to its closest ancestor of this type
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @param metric - SYS_SAGE_METRIC_LATENCY or SYS_SAGE_METRIC_BW
+    */
+    DataPathRollup(Component* root, int groupType, int dp_type, int metric);
+    /**
+    Creates a (not yet built) rollup of the DataPaths in the subtree of root to the given group components, e.g. to all L3 caches.
+    @param root - root of the subtree
+    @param groups - the group components (in the subtree of root); each component is rolled up to its closest ancestor among them
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @param metric - SYS_SAGE_METRIC_LATENCY or SYS_SAGE_METRIC_BW
+    */
+    DataPathRollup(Component* root, vector<Component*> groups, int dp_type, int metric);
+
+    /**
+    Brings the rollup up to date with the DataPaths and the Component Tree. Called by all queries.
+    */
+    void Refresh();
+    /**
+    @returns true if the rollup has not been built yet or would be updated by the next query
+    */
+    bool IsStale();
+
+    /**
+    @returns the group components, in DFS pre-order
+    */
+    vector<Component*>* GetGroups();
+    /**
+    Retrieves the aggregated metric of the DataPaths leading from the components of one group to the components of another (or the same) group.
+    @param srcGroup - the group of the sources of the DataPaths
+    @param dstGroup - the group of the targets of the DataPaths
+    @return the statistics; NULL if there is no such DataPath or the components are not groups of this rollup. The pointer is valid until the next query.
+    */
+    DataPathStats* GetStats(Component* srcGroup, Component* dstGroup);
+    /**
+    Creates an oriented DataPath of type new_dp_type between each pair of groups with rolled-up DataPaths, or updates the one created by a previous call (see UpsertDataPath()). The DataPath carries the chosen statistic as its bandwidth or latency (depending on the metric; the other one is -1) and the number of rolled-up DataPaths in the attribute "count" (int).
+    \n DataPaths of type new_dp_type are not rolled up by this rollup from then on.
+    @param new_dp_type - type of the created DataPaths
+    @param stat - SYS_SAGE_ROLLUP_MIN, SYS_SAGE_ROLLUP_MEAN or SYS_SAGE_ROLLUP_MAX
+    @return number of created or updated DataPaths; -1 if stat is not valid
+    */
+    int CreateDataPaths(int new_dp_type, int stat);
+    /**
+    @returns number of components whose DataPaths were (re)scanned by the last update
+    */
+    int GetNumRescanned();
+    /**
+    Sets the maximal number of threads used for scanning the DataPaths.
+    @param num_threads - the number of threads; 0 (the default) for std::thread::hardware_concurrency()
+    */
+    void SetNumThreads(int num_threads);
+
+private:
+    void Build();
+    void Update();
+    void Scan(vector<int>& todo);
+    void Aggregate(int group);
+
+    Component* root; /**< Root of the subtree. */
+    int groupType; /**< Component type of the groups; 0 if the groups were given explicitly. */
+    int dp_type;
+    int metric;
+    uint64_t dp_version { 0 }; /**< DataPath::GetVersion() at the time of the last update. */
+    uint64_t tree_epoch { 0 }; /**< Component::GetTreeEpoch() at the time of the last build. */
+    bool built { false }; /**< Was the rollup built at least once? */
+    int num_rescanned { 0 };
+    int max_threads { 0 }; /**< @see SetNumThreads() */
+
+    vector<Component*> groups; /**< Group components in DFS pre-order. */
+    unordered_map<Component*, int> group_of; /**< Component of the subtree -> index of its group (components without a group are left out). */
+    vector<Component*> members; /**< Components of the subtree that belong to a group, in DFS pre-order. */
+    vector<int> member_group; /**< Index of the group of each member. */
+    vector<vector<int>> group_members; /**< Group index -> indices of its members. */
+    vector<vector<pair<int, DataPathStats>>> partials; /**< Member index -> statistics of its own DataPaths per target group (ordered by the group index). */
+    vector<map<int, DataPathStats>> rows; /**< Source group index -> target group index -> statistics. */
+    set<int> excluded_types; /**< Types of the DataPaths created by CreateDataPaths(). */
+};
+
+#endif
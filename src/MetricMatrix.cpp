@@ -0,0 +1,150 @@
+#include "MetricMatrix.hpp"
+
+#include "Traversal.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+MetricMatrix* BuildMatrix(Component* root, int srcType, int dstType, int dp_type, int metric)
+{
+    return new MetricMatrix(root, srcType, dstType, dp_type, metric);
+}
+
+MetricMatrix::MetricMatrix(Component* root, int srcType, int dstType, int dp_type, int _metric): metric(_metric)
+{
+    for(Component* c : subtree(root) | of_type(srcType))
+    {
+        row_index[c] = row_components.size();
+        row_components.push_back(c);
+    }
+    for(Component* c : subtree(root) | of_type(dstType))
+    {
+        col_index[c] = col_components.size();
+        col_components.push_back(c);
+    }
+    num_rows = row_components.size();
+    num_cols = col_components.size();
+    int floats_per_line = SYS_SAGE_MATRIX_ALIGNMENT / sizeof(float);
+    stride = (num_cols + floats_per_line - 1) / floats_per_line * floats_per_line;
+    size_t bytes = std::max<size_t>((size_t)num_rows * stride * sizeof(float), SYS_SAGE_MATRIX_ALIGNMENT);
+    data = (float*)std::aligned_alloc(SYS_SAGE_MATRIX_ALIGNMENT, bytes);
+    std::fill(data, data + (size_t)num_rows * stride, std::numeric_limits<float>::quiet_NaN());
+
+    for(int i = 0; i < num_rows; i++)
+    {
+        Component* c = row_components[i];
+        float* row = GetRow(i);
+        DataPathList dps = (dp_type == SYS_SAGE_DATAPATH_TYPE_ANY) ? c->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING) : c->GetDataPathsByType(dp_type, SYS_SAGE_DATAPATH_OUTGOING);
+        for(DataPath* dp : dps)
+        {
+            Component* other = dp->GetTarget();
+            if(dp->GetOriented() == SYS_SAGE_DATAPATH_BIDIRECTIONAL && other == c)
+                other = dp->GetSource();
+            auto it = col_index.find(other);
+            if(it == col_index.end())
+                continue;
+            double value = (metric == SYS_SAGE_METRIC_BW) ? dp->GetBw() : dp->GetLatency();
+            if(value < 0)
+                continue;
+            float& element = row[it->second];
+            //NaN compares false, so the first value always lands
+            if(metric == SYS_SAGE_METRIC_BW)
+                element = (element >= (float)value) ? element : (float)value;
+            else
+                element = (element <= (float)value) ? element : (float)value;
+        }
+    }
+}
+
+MetricMatrix::~MetricMatrix()
+{
+    std::free(data);
+}
+
+int MetricMatrix::GetNumRows(){ return num_rows; }
+int MetricMatrix::GetNumCols(){ return num_cols; }
+int MetricMatrix::GetStride(){ return stride; }
+int MetricMatrix::GetMetric(){ return metric; }
+float* MetricMatrix::GetData(){ return data; }
+float* MetricMatrix::GetRow(int row){ return data + (size_t)row * stride; }
+float MetricMatrix::Get(int row, int col){ return data[(size_t)row * stride + col]; }
+
+Component* MetricMatrix::GetRowComponent(int row){ return row_components[row]; }
+Component* MetricMatrix::GetColComponent(int col){ return col_components[col]; }
+int MetricMatrix::GetRowIndex(Component* c)
+{
+    auto it = row_index.find(c);
+    return (it == row_index.end()) ? -1 : it->second;
+}
+int MetricMatrix::GetColIndex(Component* c)
+{
+    auto it = col_index.find(c);
+    return (it == col_index.end()) ? -1 : it->second;
+}
+
+#define SYS_SAGE_MATRIX_LANES 4 //floats per vector of the row reductions (16 bytes, i.e. an SSE/NEON register; a divisor of SYS_SAGE_MATRIX_ALIGNMENT / sizeof(float), so the padded rows consist of whole vectors)
+typedef float RowVector __attribute__((vector_size(SYS_SAGE_MATRIX_LANES * sizeof(float))));
+typedef int RowVectorCols __attribute__((vector_size(SYS_SAGE_MATRIX_LANES * sizeof(int))));
+
+//the reductions keep the best value and its first column per lane, written with vector extensions, so that they are compiled to vector compares and selects over the (padded, aligned) row without -ffast-math; NaN elements never win a comparison
+template <bool largest> static int RowArgBest(const float* row, int stride)
+{
+    const RowVector* vectors = (const RowVector*)__builtin_assume_aligned(row, SYS_SAGE_MATRIX_ALIGNMENT);
+    RowVector best;
+    RowVectorCols best_col, cols;
+    for(int l = 0; l < SYS_SAGE_MATRIX_LANES; l++)
+    {
+        best[l] = largest ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+        best_col[l] = -1;
+        cols[l] = l;
+    }
+    for(int v = 0; v < stride / SYS_SAGE_MATRIX_LANES; v++)
+    {
+        RowVectorCols better = largest ? (vectors[v] > best) : (vectors[v] < best);
+        best = better ? vectors[v] : best;
+        best_col = better ? cols : best_col;
+        cols += SYS_SAGE_MATRIX_LANES;
+    }
+    //the first column with the best value of all lanes
+    int col = -1;
+    for(int l = 0; l < SYS_SAGE_MATRIX_LANES; l++)
+    {
+        if(best_col[l] < 0)
+            continue;
+        if(col < 0 || (largest ? best[l] > row[col] : best[l] < row[col]) || (best[l] == row[col] && best_col[l] < col))
+            col = best_col[l];
+    }
+    return col;
+}
+
+int MetricMatrix::RowArgMax(int row)
+{
+    return RowArgBest<true>(GetRow(row), stride);
+}
+
+int MetricMatrix::RowArgMin(int row)
+{
+    return RowArgBest<false>(GetRow(row), stride);
+}
+
+int MetricMatrix::RowTopK(int row, int k, vector<int>* outCols, bool largest)
+{
+    const float* r = GetRow(row);
+    vector<int> cols;
+    for(int j = 0; j < num_cols; j++)
+    {
+        if(!std::isnan(r[j]))
+            cols.push_back(j);
+    }
+    k = std::max(0, std::min(k, (int)cols.size()));
+    auto better = [r, largest](int a, int b){
+        if(r[a] != r[b])
+            return largest ? r[a] > r[b] : r[a] < r[b];
+        return a < b;
+    };
+    std::partial_sort(cols.begin(), cols.begin() + k, cols.end(), better);
+    outCols->insert(outCols->end(), cols.begin(), cols.begin() + k);
+    return k;
+}
@@ -0,0 +1,120 @@
+#ifndef METRIC_MATRIX
+#define METRIC_MATRIX
+
+#include <vector>
+#include <unordered_map>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+#define SYS_SAGE_METRIC_BW 1 /**< Matrix of DataPath bandwidths (DataPath::GetBw()); of several DataPaths between two components, the highest bandwidth is taken. */
+#define SYS_SAGE_METRIC_LATENCY 2 /**< Matrix of DataPath latencies (DataPath::GetLatency()); of several DataPaths between two components, the lowest latency is taken. */
+
+#define SYS_SAGE_MATRIX_ALIGNMENT 64 /**< Alignment (in bytes) of the data and of each row of a MetricMatrix. */
+
+using namespace std;
+
+/**
+Class MetricMatrix - a dense matrix of one metric (bandwidth or latency) of the DataPaths between two sets of components, e.g. the NUMA x NUMA bandwidth matrix or the core x core latency matrix.
+\n The rows are the components of one type in a subtree (in DFS pre-order), the columns the components of another (or the same) type. Element [i][j] holds the metric of the DataPath(s) leading from row component i to column component j (bidirectional DataPaths count in both directions); elements without a DataPath (or with an unknown, i.e. negative, value) are NaN.
+\n The matrix is a snapshot: later changes of the DataPaths are not reflected. The elements are stored row by row as floats; the data and each row start at a SYS_SAGE_MATRIX_ALIGNMENT-byte boundary (rows are padded with NaN to GetStride() elements), so that the row operations can be vectorized.
+*/
+class MetricMatrix {
+public:
+    /**
+    Builds the matrix.
+    @param root - root of the subtree whose components form the rows and columns
+    @param srcType - component type of the rows (e.g. SYS_SAGE_COMPONENT_NUMA)
+    @param dstType - component type of the columns
+    @param dp_type - only use DataPaths of this type (SYS_SAGE_DATAPATH_TYPE_ANY for all types)
+    @param metric - SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY
+    */
+    MetricMatrix(Component* root, int srcType, int dstType, int dp_type, int metric);
+    ~MetricMatrix();
+    MetricMatrix(const MetricMatrix&) = delete;
+    MetricMatrix& operator=(const MetricMatrix&) = delete;
+
+    /**
+    @returns number of rows (components of type srcType)
+    */
+    int GetNumRows();
+    /**
+    @returns number of columns (components of type dstType)
+    */
+    int GetNumCols();
+    /**
+    @returns distance (in elements) between the starts of two consecutive rows; a multiple of SYS_SAGE_MATRIX_ALIGNMENT/sizeof(float)
+    */
+    int GetStride();
+    /**
+    @returns the metric this matrix holds (SYS_SAGE_METRIC_BW or SYS_SAGE_METRIC_LATENCY)
+    */
+    int GetMetric();
+    /**
+    @returns pointer to the first element of the matrix (row by row, GetStride() elements per row)
+    */
+    float* GetData();
+    /**
+    @returns pointer to the first element of the row
+    */
+    float* GetRow(int row);
+    /**
+    @returns the element [row][col]; NaN if there is no DataPath
+    */
+    float Get(int row, int col);
+
+    /**
+    @returns the component represented by the row
+    */
+    Component* GetRowComponent(int row);
+    /**
+    @returns the component represented by the column
+    */
+    Component* GetColComponent(int col);
+    /**
+    @returns index of the row representing component c; -1 if there is none
+    */
+    int GetRowIndex(Component* c);
+    /**
+    @returns index of the column representing component c; -1 if there is none
+    */
+    int GetColIndex(Component* c);
+
+    /**
+    @returns the column of the smallest element of the row (the first one on ties); -1 if all elements of the row are NaN
+    */
+    int RowArgMin(int row);
+    /**
+    @returns the column of the largest element of the row (the first one on ties); -1 if all elements of the row are NaN
+    */
+    int RowArgMax(int row);
+    /**
+    Retrieves the columns of the k largest (or smallest) elements of the row, ordered from the best one. NaN elements are never returned.
+    @param row - the row
+    @param k - maximal number of columns to retrieve
+    @param outCols - output parameter; the columns are pushed back
+    @param largest - if true, the largest elements are retrieved, otherwise the smallest ones
+    @return number of columns pushed back
+    */
+    int RowTopK(int row, int k, vector<int>* outCols, bool largest = true);
+
+private:
+    int metric;
+    int num_rows { 0 };
+    int num_cols { 0 };
+    int stride { 0 };
+    float* data { nullptr }; /**< SYS_SAGE_MATRIX_ALIGNMENT-aligned elements, num_rows * stride. */
+    vector<Component*> row_components;
+    vector<Component*> col_components;
+    unordered_map<Component*, int> row_index;
+    unordered_map<Component*, int> col_index;
+};
+
+/**
+Builds a MetricMatrix of the DataPaths between the components of type srcType and dstType in the subtree of root.
+@see MetricMatrix::MetricMatrix()
+@return the new matrix (to be deleted by the caller)
+*/
+MetricMatrix* BuildMatrix(Component* root, int srcType, int dstType, int dp_type, int metric);
+
+#endif
@@ -1,6 +1,9 @@
 #include "Topology.hpp"
+#include "Traversal.hpp"
+#include "DataPathMatrix.hpp"
 
 #include <algorithm>
+#include <unordered_set>
 
 void Component::PrintSubtree() { PrintSubtree(0); }
 void Component::PrintSubtree(int level)
@@ -25,20 +28,16 @@ void Component::PrintAllDataPathsInSubtree()
     GetSubtreeNodeList(&subtreeList);
     for(Component * c : subtreeList)
     {   
-        vector<DataPath*>* dp_in = c->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        vector<DataPath*>* dp_out = c->GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
-        if(dp_in->size() > 0 || dp_out->size() > 0 )
+        if(c->dp_incoming.size() > 0 || c->dp_outgoing.size() > 0 || c->dp_bidirectional.size() > 0)
         {
             cout << "DataPaths regarding Component (" << c->GetComponentTypeStr() << ") id " << c->GetId() << endl;
-            for(DataPath * dp : *dp_out)
+            for(vector<DataPath*>* dps : {&c->dp_outgoing, &c->dp_incoming, &c->dp_bidirectional})
             {
-                cout << "    ";
-                dp->Print();
-            }
-            for(DataPath * dp : *dp_in)
-            {
-                cout << "    ";
-                dp->Print();
+                for(DataPath * dp : *dps)
+                {
+                    cout << "    ";
+                    dp->Print();
+                }
             }
         }
     }
@@ -48,12 +47,22 @@ void Component::InsertChild(Component * child)
 {
     child->SetParent(this);
     children.push_back(child);
+    AddToSubtreeAggregates(child);
+    AddToSubcomponentIndexes(child);
 }
 int Component::RemoveChild(Component * child)
 {
     int orig_size = children.size();
     children.erase(std::remove(children.begin(), children.end(), child), children.end());
-    return orig_size - children.size();
+    int removed = orig_size - children.size();
+    if(removed > 0)
+    {
+        NewTreeEpoch();
+        ClearTreeLabels(child);
+        RemoveFromSubtreeAggregates(child->subtree_size, child->subtree_type_count);
+        RemoveFromSubcomponentIndexes(child);
+    }
+    return removed;
     //return std::erase(children, child); -- not supported in some compilers
 }
 Component* Component::GetChild(int _id)
@@ -86,30 +95,60 @@ vector<Component*> Component::GetAllChildrenByType(int _componentType)
     return ret;
 }
 
+//position of a SYS_SAGE_COMPONENT_* bit flag in Component::subtree_type_count; -1 for other component types
+static int ComponentTypeIndex(int _componentType)
+{
+    if(_componentType <= 0 || _componentType > SYS_SAGE_COMPONENT_TOPOLOGY || (_componentType & (_componentType - 1)) != 0)
+        return -1;
+    return __builtin_ctz((unsigned)_componentType);
+}
+
+void Component::AddToSubtreeAggregates(Component* child)
+{
+    int height = child->subtree_height + 1;
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        a->subtree_size += child->subtree_size;
+        for(int t = 0; t < SYS_SAGE_NUM_COMPONENT_TYPES; t++)
+            a->subtree_type_count[t] += child->subtree_type_count[t];
+        if(height > a->subtree_height)
+            a->subtree_height = height;
+        height = a->subtree_height + 1;
+    }
+}
+void Component::RemoveFromSubtreeAggregates(int size, const int* type_count)
+{
+    bool heightChanged = true;
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        a->subtree_size -= size;
+        for(int t = 0; t < SYS_SAGE_NUM_COMPONENT_TYPES; t++)
+            a->subtree_type_count[t] -= type_count[t];
+        //the height can only change along the chain as long as it changed one level below
+        if(heightChanged)
+        {
+            int height = 0;
+            for(Component* c : a->children)
+            {
+                if(c->subtree_height + 1 > height)
+                    height = c->subtree_height + 1;
+            }
+            heightChanged = (height != a->subtree_height);
+            a->subtree_height = height;
+        }
+    }
+}
+
 int Component::GetNumThreads()
 {
     if(componentType == SYS_SAGE_COMPONENT_THREAD)
         return 1;
-    int numPu = 0;
-    for(Component * child: children)
-    {
-        numPu += child->GetNumThreads();
-    }
-    return numPu;
+    return subtree_type_count[ComponentTypeIndex(SYS_SAGE_COMPONENT_THREAD)];
 }
 
 int Component::GetTopoTreeDepth()
 {
-    if(children.empty()) //is leaf
-        return 0;
-    int maxDepth = 0;
-    for(Component* child: children)
-    {
-        int subtreeDepth = child->GetTopoTreeDepth();
-        if(subtreeDepth > maxDepth)
-            maxDepth = subtreeDepth;
-    }
-    return maxDepth + 1;
+    return subtree_height;
 }
 
 void Component::GetComponentsNLevelsDeeper(vector<Component*>* outArray, int depth)
@@ -132,22 +171,14 @@ void Component::GetComponentsNLevelsDeeper(vector<Component*>* outArray, int dep
 
 void Component::GetSubcomponentsByType(vector<Component*>* outArray, int _componentType)
 {
-    if(_componentType == componentType){
-        outArray->push_back(this);
-    }
-    for(Component* child: children)
-    {
-        child->GetSubcomponentsByType(outArray, _componentType);
-    }
+    for(Component* c : subtree(this) | of_type(_componentType))
+        outArray->push_back(c);
 }
 
 void Component::GetSubtreeNodeList(vector<Component*>* outArray)
 {
-    outArray->push_back(this);
-    for(Component * child : children)
-    {
-        child->GetSubtreeNodeList(outArray);
-    }
+    for(Component * c : subtree(this))
+        outArray->push_back(c);
     return;
 }
 
@@ -155,18 +186,98 @@ Component* Component::FindSubcomponentById(int _id, int _componentType)
 {
     return GetSubcomponentById(_id, _componentType);
 }
-Component* Component::GetSubcomponentById(int _id, int _componentType)
+//key of the subcomponent index
+static uint64_t SubcomponentIndexKey(int _componentType, int _id)
 {
-    if(componentType == _componentType && id == _id){
-        return this;
+    return ((uint64_t)(uint32_t)_componentType << 32) | (uint32_t)_id;
+}
+
+void Component::EnableSubcomponentIndex()
+{
+    if(subcomponentIndex != NULL)
+        return;
+    subcomponentIndex = new unordered_map<uint64_t, vector<Component*>>();
+    for(Component* c : subtree(this))
+        (*subcomponentIndex)[SubcomponentIndexKey(c->componentType, c->id)].push_back(c);
+}
+void Component::DisableSubcomponentIndex()
+{
+    delete subcomponentIndex;
+    subcomponentIndex = NULL;
+}
+bool Component::HasSubcomponentIndex(){return subcomponentIndex != NULL;}
+
+void Component::AddToSubcomponentIndexes(Component* subtreeRoot)
+{
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        if(a->subcomponentIndex == NULL)
+            continue;
+        for(Component* c : subtree(subtreeRoot))
+            (*a->subcomponentIndex)[SubcomponentIndexKey(c->componentType, c->id)].push_back(c);
     }
-    for(Component * child : children)
+}
+void Component::RemoveFromSubcomponentIndexes(Component* subtreeRoot)
+{
+    for(Component* a = this; a != NULL; a = a->parent)
+    {
+        if(a->subcomponentIndex == NULL)
+            continue;
+        for(Component* c : subtree(subtreeRoot))
+        {
+            auto it = a->subcomponentIndex->find(SubcomponentIndexKey(c->componentType, c->id));
+            if(it == a->subcomponentIndex->end())
+                continue;
+            vector<Component*>& matches = it->second;
+            matches.erase(std::remove(matches.begin(), matches.end(), c), matches.end());
+            if(matches.empty())
+                a->subcomponentIndex->erase(it);
+        }
+    }
+}
+
+vector<Component*> Component::GetAllSubcomponentsById(int _id, int _componentType)
+{
+    vector<Component*> ret;
+    if(subcomponentIndex != NULL)
+    {
+        auto it = subcomponentIndex->find(SubcomponentIndexKey(_componentType, _id));
+        if(it != subcomponentIndex->end())
+        {
+            ret = it->second;
+            if(ret.size() > 1)
+                std::sort(ret.begin(), ret.end(), [](Component* a, Component* b){ return a->PrecedesInDfs(b); });
+        }
+        return ret;
+    }
+    for(Component* c : subtree(this) | of_type(_componentType))
+    {
+        if(c->id == _id)
+            ret.push_back(c);
+    }
+    return ret;
+}
+
+Component* Component::GetSubcomponentById(int _id, int _componentType)
+{
+    if(subcomponentIndex != NULL)
     {
-        Component* ret = child->GetSubcomponentById(_id, _componentType);
-        if(ret != NULL)
+        auto it = subcomponentIndex->find(SubcomponentIndexKey(_componentType, _id));
+        if(it == subcomponentIndex->end())
+            return NULL;
+        //duplicate IDs -- return the same component as the DFS would
+        Component* first = it->second[0];
+        for(size_t i = 1; i < it->second.size(); i++)
         {
-            return ret;
+            if(it->second[i]->PrecedesInDfs(first))
+                first = it->second[i];
         }
+        return first;
+    }
+    for(Component * c : subtree(this) | of_type(_componentType))
+    {
+        if(c->id == _id)
+            return c;
     }
     return NULL;
 }
@@ -183,41 +294,41 @@ vector<Component*> Component::GetAllSubcomponentsByType(int _componentType)
 }
 void Component::GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType)
 {
-    if(componentType == _componentType){
-        outArray->push_back(this);
-    }
-    for(Component * child : children)
-    {
-        child->GetAllSubcomponentsByType(outArray, _componentType);
-    }
+    for(Component * c : subtree(this) | of_type(_componentType))
+        outArray->push_back(c);
     return;
 }
 
 int Component::CountAllSubcomponents()
 {
-    int cnt = children.size();
-    for(Component * child : children)
-    {
-        cnt += child->CountAllSubcomponents();
-    }
-    return cnt;
+    return subtree_size - 1;
 }
 
 int Component::CountAllSubcomponentsByType(int _componentType)
 {
+    int t = ComponentTypeIndex(_componentType);
+    if(t >= 0)
+        return subtree_type_count[t] - (componentType == _componentType ? 1 : 0);
+
     int cnt = 0;
-    for(Component * child : children)
+    for(Component * c : subtree(this) | of_type(_componentType))
     {
-        if(child->GetComponentType() == _componentType)
+        if(c != this)
             cnt++;
     }
-    for(Component * child : children)
-    {
-        cnt += child->CountAllSubcomponentsByType(_componentType);
-    }
     return cnt;
 }
 
+Arena* Component::FindArena()
+{
+    Component* root = this;
+    while(root->parent != NULL)
+        root = root->parent;
+    if(root->componentType == SYS_SAGE_COMPONENT_TOPOLOGY)
+        return ((Topology*)root)->GetArena();
+    return NULL;
+}
+
 Component* Component::FindParentByType(int _componentType)
 {
     return GetAncestorType(_componentType);
@@ -225,64 +336,380 @@ Component* Component::FindParentByType(int _componentType)
 
 Component* Component::GetAncestorType(int _componentType)
 {
-    if(componentType == _componentType){
-        return this;
-    }
-    if(parent != NULL){
-        return parent->FindParentByType(_componentType);
+    //fresh labels tell cheaply if there is no such ancestor at all (no relabeling here, as this is often called while the tree is being built)
+    if(HasFreshTreeLabels() && _componentType > 0 && (ancestor_types & (uint32_t)_componentType) != (uint32_t)_componentType)
+        return NULL;
+    for(Component* c = this; c != NULL; c = c->parent)
+    {
+        if(c->componentType == _componentType)
+            return c;
     }
     return NULL;
 }
 
-void Component::AddDataPath(DataPath* p, int orientation)
+std::atomic<uint64_t> Component::last_tree_epoch { 0 };
+uint64_t Component::GetTreeEpoch(){return GetTreeRoot()->tree_epoch;}
+
+Component* Component::GetTreeRoot()
 {
-    if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
-        dp_outgoing.push_back(p);
-    else if(orientation == SYS_SAGE_DATAPATH_INCOMING)
-        dp_incoming.push_back(p);
+    Component* root = this;
+    while(root->parent != NULL)
+        root = root->parent;
+    return root;
 }
 
-DataPath* Component::GetDpByType(int dp_type, int orientation)
+void Component::NewTreeEpoch()
+{
+    GetTreeRoot()->tree_epoch = ++last_tree_epoch;
+}
+
+void Component::ClearTreeLabels(Component* subtreeRoot)
+{
+    for(Component* c : subtree(subtreeRoot))
+        c->label_root = NULL;
+}
+
+//label_root is either NULL or the root of the tree of this component at the time of labeling, which is an ancestor (or this component) as long as its epoch is unchanged
+bool Component::HasFreshTreeLabels()
 {
-    if(orientation & SYS_SAGE_DATAPATH_OUTGOING){
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == dp_type)
-                return dp;
+    return label_root != NULL && label_epoch == label_root->tree_epoch;
+}
+
+void Component::UpdateTreeLabels()
+{
+    if(HasFreshTreeLabels())
+        return;
+    Component* root = GetTreeRoot();
+    if(root->tree_epoch == 0)
+        root->tree_epoch = ++last_tree_epoch;
+    uint64_t epoch = root->tree_epoch;
+
+    //iterative DFS (Euler tour); stack entries: component, index of the next child to visit
+    int counter = 0;
+    vector<pair<Component*, size_t>> stack;
+    root->label_root = root;
+    root->label_epoch = epoch;
+    root->dfs_pre = counter++;
+    root->ancestor_types = (uint32_t)root->componentType;
+    stack.push_back({root, 0});
+    while(!stack.empty())
+    {
+        Component* c = stack.back().first;
+        size_t next = stack.back().second;
+        if(next < c->children.size())
+        {
+            stack.back().second++;
+            Component* child = c->children[next];
+            child->label_root = root;
+            child->label_epoch = epoch;
+            child->dfs_pre = counter++;
+            child->ancestor_types = c->ancestor_types | (uint32_t)child->componentType;
+            stack.push_back({child, 0});
         }
-    }
-    if(orientation & SYS_SAGE_DATAPATH_INCOMING){
-        for(DataPath* dp : dp_incoming){
-            if(dp->GetDpType() == dp_type)
-                return dp;
+        else
+        {
+            c->dfs_post = counter++;
+            stack.pop_back();
         }
     }
+}
+
+bool Component::PrecedesInDfs(Component* other)
+{
+    UpdateTreeLabels();
+    other->UpdateTreeLabels();
+    return dfs_pre < other->dfs_pre;
+}
+
+bool Component::IsDescendantOf(Component* ancestor)
+{
+    if(ancestor == NULL || ancestor == this)
+        return false;
+    UpdateTreeLabels();
+    ancestor->UpdateTreeLabels();
+    return label_root == ancestor->label_root && ancestor->dfs_pre < dfs_pre && dfs_post < ancestor->dfs_post;
+}
+
+Component* Component::GetLowestCommonAncestor(Component* other)
+{
+    if(other == NULL)
+        return NULL;
+    UpdateTreeLabels();
+    other->UpdateTreeLabels();
+    if(label_root != other->label_root)
+        return NULL;
+    Component* c = this;
+    while(c != other && !other->IsDescendantOf(c))
+        c = c->parent;
+    return c;
+}
+
+Component* Component::GetLowestCommonAncestor(Component* other, int _componentType)
+{
+    Component* lca = GetLowestCommonAncestor(other);
+    if(lca == NULL)
+        return NULL;
+    return lca->GetAncestorType(_componentType);
+}
+
+//single-bit types have a fixed position in dp_buckets, given by dp_type_mask
+static bool IsSingleBitDpType(int dp_type)
+{
+    return dp_type > 0 && (dp_type & (dp_type - 1)) == 0;
+}
+
+DataPathBucket* Component::FindDpBucket(int dp_type)
+{
+    if(IsSingleBitDpType(dp_type))
+    {
+        if(!(dp_type_mask & dp_type))
+            return NULL;
+        return &dp_buckets[__builtin_popcount(dp_type_mask & (dp_type - 1))];
+    }
+    for(size_t i = __builtin_popcount(dp_type_mask); i < dp_buckets.size(); i++)
+    {
+        if(dp_buckets[i].dp_type == dp_type)
+            return &dp_buckets[i];
+    }
     return NULL;
 }
-void Component::GetAllDpByType(vector<DataPath*>* outDpArr, int dp_type, int orientation)
+
+DataPathBucket* Component::AddDpBucket(int dp_type)
 {
-    if(orientation & SYS_SAGE_DATAPATH_OUTGOING){
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == dp_type)
-                outDpArr->push_back(dp);
-        }
+    DataPathBucket* bucket = FindDpBucket(dp_type);
+    if(bucket != NULL)
+        return bucket;
+    auto pos = dp_buckets.end();
+    if(IsSingleBitDpType(dp_type))
+    {
+        pos = dp_buckets.begin() + __builtin_popcount(dp_type_mask & (dp_type - 1));
+        dp_type_mask |= dp_type;
     }
-    if(orientation & SYS_SAGE_DATAPATH_INCOMING){
-        for(DataPath* dp : dp_incoming){
-            if(dp->GetDpType() == dp_type)
-                outDpArr->push_back(dp);
-        }
+    return &*dp_buckets.insert(pos, DataPathBucket{dp_type, {}, {}, {}, {}, {}});
+}
+
+void Component::ReserveDataPaths(int dp_type, size_t num_outgoing, size_t num_incoming, size_t num_bidirectional)
+{
+    DataPathBucket* bucket = AddDpBucket(dp_type);
+    bucket->outgoing.reserve(bucket->outgoing.size() + num_outgoing);
+    bucket->incoming.reserve(bucket->incoming.size() + num_incoming);
+    bucket->bidirectional.reserve(bucket->bidirectional.size() + num_bidirectional);
+    dp_outgoing.reserve(dp_outgoing.size() + num_outgoing);
+    dp_incoming.reserve(dp_incoming.size() + num_incoming);
+    dp_bidirectional.reserve(dp_bidirectional.size() + num_bidirectional);
+}
+
+void Component::RemoveDpBucket(DataPathBucket* bucket)
+{
+    if(IsSingleBitDpType(bucket->dp_type))
+        dp_type_mask &= ~(uint32_t)bucket->dp_type;
+    dp_buckets.erase(dp_buckets.begin() + (bucket - dp_buckets.data()));
+}
+
+//which endpoint (0 = source, 1 = target) of p is this component, when p is seen in the given orientation from it; -1 if none
+int Component::GetDpEndpoint(DataPath* p, int orientation)
+{
+    int e;
+    if(p->oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        e = (p->source == this) ? 0 : 1;
+    else if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
+        e = 0;
+    else if(orientation == SYS_SAGE_DATAPATH_INCOMING)
+        e = 1;
+    else
+        return -1;
+    if((e == 0 ? p->source : p->target) != this)
+        return -1;
+    return e;
+}
+
+//list of this component (or of the bucket, if not NULL) in which p is stored as the endpoint e
+vector<DataPath*>* Component::GetDpList(DataPath* p, int e, DataPathBucket* bucket)
+{
+    if(p->oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        return (bucket != NULL) ? &bucket->bidirectional : &dp_bidirectional;
+    if(e == 0)
+        return (bucket != NULL) ? &bucket->outgoing : &dp_outgoing;
+    return (bucket != NULL) ? &bucket->incoming : &dp_incoming;
+}
+
+//removes the entry at position i of the list v of this component (which stores its data paths as the endpoint e; k = 0 for the lists of the component, 1 for a bucket) by moving the last entry to its place
+void Component::UnlinkDpSlot(vector<DataPath*>* v, int e, int k, int i)
+{
+    DataPath* last = v->back();
+    v->pop_back();
+    if(i == (int)v->size())
+        return;
+    (*v)[i] = last;
+    if(last->oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL)
+        e = (last->source == this) ? 0 : 1;
+    last->slots[e][k] = i;
+}
+
+void Component::UnlinkDataPath(DataPath* p, int e)
+{
+    dp_stamp = ++DataPath::version;
+    DataPath::structure_version++;
+    UnlinkDpSlot(GetDpList(p, e, NULL), e, 0, p->slots[e][0]);
+    p->slots[e][0] = -1;
+
+    DataPathBucket* bucket = FindDpBucket(p->dp_type);
+    p->Unindex(this, bucket);
+    UnlinkDpSlot(GetDpList(p, e, bucket), e, 1, p->slots[e][1]);
+    p->slots[e][1] = -1;
+    if(bucket->outgoing.empty() && bucket->incoming.empty() && bucket->bidirectional.empty())
+        RemoveDpBucket(bucket);
+}
+
+void Component::AddDataPath(DataPath* p, int orientation)
+{
+    int e = GetDpEndpoint(p, orientation);
+    if(e < 0 || p->slots[e][0] >= 0)
+        return;
+    DataPathBucket* bucket = AddDpBucket(p->dp_type);
+    vector<DataPath*>* v = GetDpList(p, e, NULL);
+    vector<DataPath*>* b = GetDpList(p, e, bucket);
+    p->slots[e][0] = v->size();
+    p->slots[e][1] = b->size();
+    v->push_back(p);
+    b->push_back(p);
+    dp_stamp = ++DataPath::version;
+    DataPath::structure_version++;
+}
+
+void Component::RemoveDataPath(DataPath* p, int orientation)
+{
+    int e = GetDpEndpoint(p, orientation);
+    if(e < 0 || p->slots[e][0] < 0)
+        return;
+    UnlinkDataPath(p, e);
+}
+
+void Component::DeleteDataPathsByType(int dp_type)
+{
+    //each deletion removes the data path from the bucket; the bucket itself is removed once empty
+    DataPathBucket* bucket;
+    while((bucket = FindDpBucket(dp_type)) != NULL)
+    {
+        DataPath* dp;
+        if(!bucket->outgoing.empty())
+            dp = bucket->outgoing.back();
+        else if(!bucket->incoming.empty())
+            dp = bucket->incoming.back();
+        else
+            dp = bucket->bidirectional.back();
+        dp->DeleteDataPath();
     }
+}
+
+//pushes back the data paths of the bucket in the given orientation(s); bidirectional ones only once
+static void GetBucketDataPaths(vector<DataPath*>* outDpArr, DataPathBucket* bucket, int orientation)
+{
+    if(orientation & SYS_SAGE_DATAPATH_OUTGOING)
+        outDpArr->insert(outDpArr->end(), bucket->outgoing.begin(), bucket->outgoing.end());
+    if(orientation & SYS_SAGE_DATAPATH_INCOMING)
+        outDpArr->insert(outDpArr->end(), bucket->incoming.begin(), bucket->incoming.end());
+    if(orientation & (SYS_SAGE_DATAPATH_OUTGOING | SYS_SAGE_DATAPATH_INCOMING))
+        outDpArr->insert(outDpArr->end(), bucket->bidirectional.begin(), bucket->bidirectional.end());
+}
+
+DataPath* Component::GetDpByType(int dp_type, int orientation)
+{
+    DataPathBucket* bucket = FindDpBucket(dp_type);
+    if(bucket == NULL)
+        return NULL;
+    if((orientation & SYS_SAGE_DATAPATH_OUTGOING) && !bucket->outgoing.empty())
+        return bucket->outgoing.front();
+    if((orientation & SYS_SAGE_DATAPATH_INCOMING) && !bucket->incoming.empty())
+        return bucket->incoming.front();
+    if((orientation & (SYS_SAGE_DATAPATH_OUTGOING | SYS_SAGE_DATAPATH_INCOMING)) && !bucket->bidirectional.empty())
+        return bucket->bidirectional.front();
+    return NULL;
+}
+void Component::GetAllDpByType(vector<DataPath*>* outDpArr, int dp_type, int orientation)
+{
+    DataPathBucket* bucket = FindDpBucket(dp_type);
+    if(bucket == NULL)
+        return;
+    GetBucketDataPaths(outDpArr, bucket, orientation);
     return;
 }
 
+DataPathList Component::GetDataPathsByType(int dp_type, int orientation)
+{
+    DataPathBucket* bucket = FindDpBucket(dp_type);
+    if(bucket == NULL)
+        return DataPathList();
+    if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
+        return DataPathList(&bucket->outgoing, &bucket->bidirectional);
+    else if(orientation == SYS_SAGE_DATAPATH_INCOMING)
+        return DataPathList(&bucket->incoming, &bucket->bidirectional);
+    return DataPathList();
+}
+
+void Component::GetAllDpByTypeMask(vector<DataPath*>* outDpArr, int dp_type_mask, int orientation)
+{
+    //only the buckets of single-bit types can match
+    int num_bit_buckets = __builtin_popcount(this->dp_type_mask);
+    for(int i = 0; i < num_bit_buckets; i++)
+    {
+        if(dp_buckets[i].dp_type & dp_type_mask)
+            GetBucketDataPaths(outDpArr, &dp_buckets[i], orientation);
+    }
+}
+
+uint32_t Component::GetDpTypeMask(){ return dp_type_mask; }
+uint64_t Component::GetDataPathStamp(){ return dp_stamp; }
+
+vector<DataPathMatrix*> Component::GetDataPathMatrices()
+{
+    if(dp_matrices == NULL)
+        return {};
+    return *dp_matrices;
+}
+void Component::AddDataPathMatrix(DataPathMatrix* m)
+{
+    if(dp_matrices == NULL)
+        dp_matrices = new vector<DataPathMatrix*>();
+    dp_matrices->push_back(m);
+}
+void Component::RemoveDataPathMatrix(DataPathMatrix* m)
+{
+    if(dp_matrices == NULL)
+        return;
+    dp_matrices->erase(std::remove(dp_matrices->begin(), dp_matrices->end(), m), dp_matrices->end());
+    if(dp_matrices->empty())
+    {
+        delete dp_matrices;
+        dp_matrices = NULL;
+    }
+}
+
 vector<DataPath*>* Component::GetDataPaths(int orientation)
+{
+    if(orientation != SYS_SAGE_DATAPATH_OUTGOING && orientation != SYS_SAGE_DATAPATH_INCOMING)
+        return NULL;
+    int i = (orientation == SYS_SAGE_DATAPATH_INCOMING);
+    vector<DataPath*>*& copy = dp_copies[i];
+    if(copy == NULL)
+        copy = new vector<DataPath*>();
+    else if(dp_copy_stamps[i] == dp_stamp)
+        return copy;
+    //rebuilt only after the DataPaths of this component changed
+    DataPathList dps = GetDataPathList(orientation);
+    copy->assign(dps.begin(), dps.end());
+    dp_copy_stamps[i] = dp_stamp;
+    return copy;
+}
+
+DataPathList Component::GetDataPathList(int orientation)
 {
     if(orientation == SYS_SAGE_DATAPATH_INCOMING)
-        return &dp_incoming;
+        return DataPathList(&dp_incoming, &dp_bidirectional);
     else if(orientation == SYS_SAGE_DATAPATH_OUTGOING)
-        return &dp_outgoing;
+        return DataPathList(&dp_outgoing, &dp_bidirectional);
     else //TODO
-        return NULL;
+        return DataPathList();
 }
 
 string Component::GetComponentTypeStr()
@@ -336,100 +763,162 @@ int Component::GetTopologySize(unsigned * out_component_size, unsigned * out_dat
 }
 int Component::GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize, std::set<DataPath*>* counted_dataPaths)
 {
-    if(counted_dataPaths == NULL)
-        counted_dataPaths = new std::set<DataPath*>();
-
-    int component_size = 0;
-    switch(componentType)
+    int size = 0;
+    for(Component* c : subtree(this))
     {
-        case SYS_SAGE_COMPONENT_NONE:
-        break;
-        case SYS_SAGE_COMPONENT_THREAD:
-            component_size += sizeof(Thread);
-        break;
-        case SYS_SAGE_COMPONENT_CORE:
-            component_size += sizeof(Core);
-        break;
-        case SYS_SAGE_COMPONENT_CACHE:
-            component_size += sizeof(Cache);
-        break;
-        case SYS_SAGE_COMPONENT_SUBDIVISION:
-            component_size += sizeof(Subdivision);
-        break;
-        case SYS_SAGE_COMPONENT_NUMA:
-            component_size += sizeof(Numa);
-        break;
-        case SYS_SAGE_COMPONENT_CHIP:
-            component_size += sizeof(Chip);
-        break;
-        case SYS_SAGE_COMPONENT_MEMORY:
-            component_size += sizeof(Memory);
-        break;
-        case SYS_SAGE_COMPONENT_STORAGE:
-            component_size += sizeof(Storage);
-        break;
-        case SYS_SAGE_COMPONENT_NODE:
-            component_size += sizeof(Node);
-        break;
-        case SYS_SAGE_COMPONENT_TOPOLOGY:
-            component_size += sizeof(Topology);
-        break;
+        int dataPathSize = c->GetDataPathsSize(this, counted_dataPaths);
+        (*out_dataPathSize) += dataPathSize;
+        size += dataPathSize;
+
+        int component_size = 0;
+        switch(c->componentType)
+        {
+            case SYS_SAGE_COMPONENT_NONE:
+            break;
+            case SYS_SAGE_COMPONENT_THREAD:
+                component_size += sizeof(Thread);
+            break;
+            case SYS_SAGE_COMPONENT_CORE:
+                component_size += sizeof(Core);
+            break;
+            case SYS_SAGE_COMPONENT_CACHE:
+                component_size += sizeof(Cache);
+            break;
+            case SYS_SAGE_COMPONENT_SUBDIVISION:
+                component_size += sizeof(Subdivision);
+            break;
+            case SYS_SAGE_COMPONENT_NUMA:
+                component_size += sizeof(Numa);
+            break;
+            case SYS_SAGE_COMPONENT_CHIP:
+                component_size += sizeof(Chip);
+            break;
+            case SYS_SAGE_COMPONENT_MEMORY:
+                component_size += sizeof(Memory);
+            break;
+            case SYS_SAGE_COMPONENT_STORAGE:
+                component_size += sizeof(Storage);
+            break;
+            case SYS_SAGE_COMPONENT_NODE:
+                component_size += sizeof(Node);
+            break;
+            case SYS_SAGE_COMPONENT_TOPOLOGY:
+                component_size += sizeof(Topology);
+            break;
+        }
+        component_size += c->attrib.size()*sizeof(AttributeStore::Entry); //TODO improve (values are not counted)
+        component_size += c->children.size()*sizeof(Component*);
+        (*out_component_size) += component_size;
+        size += component_size;
     }
-    component_size += attrib.size()*(sizeof(string)+sizeof(void*)); //TODO improve
-    component_size += children.size()*sizeof(Component*);
-    (*out_component_size) += component_size;
+    return size;
+}
 
+//size of the data path lists of this component and of the data paths counted at this component: each data path is counted at its source, or at its target if the source is not in the subtree of root (or, if counted_dataPaths is given, only if not in counted_dataPaths)
+int Component::GetDataPathsSize(Component* root, std::set<DataPath*>* counted_dataPaths)
+{
     int dataPathSize = 0;
-    dataPathSize += dp_incoming.size() * sizeof(DataPath*);
-    dataPathSize += dp_outgoing.size() * sizeof(DataPath*);
-    for(auto it = std::begin(dp_incoming); it != std::end(dp_incoming); ++it) {
-        if(!counted_dataPaths->count((DataPath*)(*it))) {
-            //cout << "new datapath " << (DataPath*)(*it) << endl;
-            dataPathSize += sizeof(DataPath);
-            dataPathSize += (*it)->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-            counted_dataPaths->insert((DataPath*)(*it));
+    dataPathSize += (dp_incoming.size() + dp_outgoing.size() + dp_bidirectional.size()) * sizeof(DataPath*);
+    dataPathSize += dp_buckets.size() * sizeof(DataPathBucket) + (dp_incoming.size() + dp_outgoing.size() + dp_bidirectional.size()) * sizeof(DataPath*);
+    for(vector<DataPath*>* dps : {&dp_outgoing, &dp_incoming, &dp_bidirectional})
+    {
+        for(DataPath* dp : *dps)
+        {
+            bool count;
+            if(counted_dataPaths != NULL)
+                count = counted_dataPaths->insert(dp).second;
+            else
+                count = (dp->GetSource() == this && dps != &dp_incoming) || (dp->GetSource() != root && !dp->GetSource()->IsDescendantOf(root));
+            if(count)
+            {
+                dataPathSize += sizeof(DataPath);
+                dataPathSize += dp->attrib.size() * sizeof(AttributeStore::Entry); //TODO improve (values are not counted)
+            }
         }
     }
-    for(auto it = std::begin(dp_outgoing); it != std::end(dp_outgoing); ++it) {
-        if(!counted_dataPaths->count((DataPath*)(*it))){
-            //cout << "new datapath " << (DataPath*)(*it) << endl;
-            dataPathSize += sizeof(DataPath);
-            dataPathSize += (*it)->attrib.size() * (sizeof(string)+sizeof(void*)); //TODO improve
-            counted_dataPaths->insert((DataPath*)(*it));
+    return dataPathSize;
+}
+
+void Component::DeleteDataPathsOf(vector<Component*>& components)
+{
+    unordered_set<Component*> inside(components.begin(), components.end());
+    //each data path is collected once: at its source, or at its target if the source is not in the set
+    vector<DataPath*> dps;
+    for(Component* c : components)
+    {
+        for(DataPath* dp : c->dp_outgoing)
+            dps.push_back(dp);
+        for(DataPath* dp : c->dp_incoming)
+        {
+            if(!inside.count(dp->source))
+                dps.push_back(dp);
+        }
+        for(DataPath* dp : c->dp_bidirectional)
+        {
+            if(dp->source == c || !inside.count(dp->source))
+                dps.push_back(dp);
         }
     }
-    (*out_dataPathSize) += dataPathSize;
-
-    int subtreeSize = 0;
-    for(auto it = std::begin(children); it != std::end(children); ++it) {
-        subtreeSize += (*it)->GetTopologySize(out_component_size, out_dataPathSize, counted_dataPaths);
+    //unlink the data paths from the components outside of the set (in constant time each); the lists of the components in the set are dropped as a whole
+    for(DataPath* dp : dps)
+    {
+        for(int e = 0; e < 2; e++)
+        {
+            Component* c = (e == 0) ? dp->source : dp->target;
+            if(dp->slots[e][0] >= 0 && !inside.count(c))
+                c->UnlinkDataPath(dp, e);
+        }
     }
-
-    if(counted_dataPaths != NULL)
-        delete counted_dataPaths;
-    return component_size + dataPathSize + subtreeSize;
+    for(Component* c : components)
+    {
+        c->dp_outgoing.clear();
+        c->dp_incoming.clear();
+        c->dp_bidirectional.clear();
+        c->dp_buckets.clear();
+        c->dp_type_mask = 0;
+        c->dp_stamp = ++DataPath::version;
+    }
+    DataPath::structure_version++;
+    for(DataPath* dp : dps)
+        delete dp;
 }
 
-
 void Component::DeleteAllDataPaths()
 {
-    while(!dp_outgoing.empty())
+    vector<Component*> self{this};
+    DeleteDataPathsOf(self);
+}
+void Component::DeleteSubtree()
+{
+    if(children.empty())
+        return;
+
+    //detach all children at once
+    vector<Component*> detached;
+    detached.swap(children);
+    NewTreeEpoch();
+    int size = 0;
+    int type_count[SYS_SAGE_NUM_COMPONENT_TYPES] = {};
+    for(Component* child : detached)
     {
-        DataPath * dp = dp_outgoing.back();
-        dp->DeleteDataPath();
+        size += child->subtree_size;
+        for(int t = 0; t < SYS_SAGE_NUM_COMPONENT_TYPES; t++)
+            type_count[t] += child->subtree_type_count[t];
+        RemoveFromSubcomponentIndexes(child);
     }
-    while(!dp_incoming.empty())
+    RemoveFromSubtreeAggregates(size, type_count);
+
+    //free all data paths touching the subtree, then all the components
+    vector<Component*> components;
+    components.reserve(size);
+    for(Component* child : detached)
     {
-        DataPath * dp = dp_incoming.back();
-        dp->DeleteDataPath();
+        for(Component* c : subtree(child))
+            components.push_back(c);
     }
-}
-void Component::DeleteSubtree()
-{
-    while(children.size() > 0)
-    {       
-        children[0]->Delete(true); // Recursively free children
-    }    
+    DeleteDataPathsOf(components);
+    for(Component* c : components)
+        delete c;
     return;
 }
 void Component::Delete(bool withSubtree)
@@ -458,9 +947,10 @@ void Component::Delete(bool withSubtree)
     else //if(GetParent() == NULL && !withSubtree)
     {
         while(children.size() > 0)
-        {       
-            RemoveChild(children[0]); // Recursively free children
-            children[0]->SetParent(NULL);
+        {
+            Component* child = children[0];
+            RemoveChild(child);
+            child->SetParent(NULL);
         }
     }
     // Delete the component itself
@@ -468,11 +958,27 @@ void Component::Delete(bool withSubtree)
 }
 
 Component* Component::GetParent(){return parent;}
-void Component::SetParent(Component* _parent){parent = _parent;}
+void Component::SetParent(Component* _parent)
+{
+    if(parent != NULL)
+    {
+        //the subtree leaves its tree: its labels must not refer to the old root (which may be deleted)
+        parent->NewTreeEpoch();
+        ClearTreeLabels(this);
+    }
+    else
+    {
+        //labels computed while this component was a root become stale
+        tree_epoch = ++last_tree_epoch;
+    }
+    parent = _parent;
+    NewTreeEpoch();
+}
 vector<Component*>* Component::GetChildren(){return &children;}
 int Component::GetComponentType(){return componentType;}
 string Component::GetName(){return name;}
 int Component::GetId(){return id;}
+int Component::GetCount(){return count;}
 
 void Storage::SetSize(long long _size){size = _size;} 
 long long Storage::GetSize(){return size;}
@@ -491,6 +997,7 @@ long long Numa::GetSize(){return size;}
 
 long long Memory::GetSize() {return size;}
 void Memory::SetSize(long long _size) {size = _size;}
+bool Memory::GetIsVolatile() {return is_volatile;}
 
 string Cache::GetCacheName(){return cache_type;}
 
@@ -520,18 +1027,55 @@ int Cache::GetCacheAssociativityWays(){return cache_associativity_ways;}
 Component::Component(int _id, string _name, int _componentType) : id(_id), name(_name), componentType(_componentType)
 {
     count = -1;
+    int t = ComponentTypeIndex(componentType);
+    if(t >= 0)
+        subtree_type_count[t] = 1;
     SetParent(NULL);
 }
 Component::Component(Component * parent, int _id, string _name, int _componentType) : id(_id), name(_name), componentType(_componentType)
 {
     count = -1;
+    int t = ComponentTypeIndex(componentType);
+    if(t >= 0)
+        subtree_type_count[t] = 1;
     SetParent(parent);
     if (parent) {
         parent->InsertChild(this);
     }
 }
+Component::~Component()
+{
+    delete subcomponentIndex;
+    delete dp_copies[0];
+    delete dp_copies[1];
+    if(dp_matrices != NULL)
+    {
+        vector<DataPathMatrix*>* matrices = dp_matrices;
+        dp_matrices = NULL;
+        for(DataPathMatrix* m : *matrices)
+        {
+            m->owner = NULL;
+            delete m;
+        }
+        delete matrices;
+    }
+    //the last destructor body run for any Component; tells operator delete where the memory comes from
+    Arena::SetReleasedObject(this, attrib.GetArena());
+}
 
 Topology::Topology():Component(0, "sys-sage Topology", SYS_SAGE_COMPONENT_TOPOLOGY){}
+Topology::~Topology()
+{
+    if(arena != NULL)
+        delete arena;
+}
+Arena* Topology::EnableArena(size_t chunk_size)
+{
+    if(arena == NULL)
+        arena = new Arena(chunk_size);
+    return arena;
+}
+Arena* Topology::GetArena(){return arena;}
 
 Node::Node(int _id, string _name):Component(_id, _name, SYS_SAGE_COMPONENT_NODE){}
 Node::Node(Component * parent, int _id, string _name):Component(parent, _id, _name, SYS_SAGE_COMPONENT_NODE){}
@@ -5,10 +5,19 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
 
 #include "defines.hpp"
 #include "DataPath.hpp"
+#include "Arena.hpp"
+#include "AttributeStore.hpp"
+#include "AttributeCodec.hpp"
+#include "DataPathList.hpp"
 #include <libxml/parser.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 
 
 #define SYS_SAGE_COMPONENT_NONE 1 /**< class Component (do not use normally)*/
@@ -22,6 +31,7 @@
 #define SYS_SAGE_COMPONENT_STORAGE 256 /**< class Storage */
 #define SYS_SAGE_COMPONENT_NODE 512 /**< class Node */
 #define SYS_SAGE_COMPONENT_TOPOLOGY 1024 /**< class Topology */
+#define SYS_SAGE_NUM_COMPONENT_TYPES 11 /**< Number of the SYS_SAGE_COMPONENT_* types above (bit flags 1 to 1024). */
 
 #define SYS_SAGE_SUBDIVISION_TYPE_NONE 1 /**< Generic Subdivision type. */
 #define SYS_SAGE_SUBDIVISION_TYPE_GPU_SM 2 /**< Subdivision type for GPU SMs */
@@ -34,6 +44,20 @@
 
 using namespace std;
 class DataPath;
+class DataPathMatrix;
+class TopologyView;
+
+/**
+The DataPaths of one type attached to a Component (see Component::GetDataPathsByType()).
+*/
+struct DataPathBucket {
+    int dp_type; /**< Type of all DataPaths in the bucket. */
+    vector<DataPath*> outgoing; /**< DataPaths of dp_outgoing with this type. */
+    vector<DataPath*> incoming; /**< DataPaths of dp_incoming with this type. */
+    vector<DataPath*> bidirectional; /**< DataPaths of dp_bidirectional with this type. */
+    unordered_map<Component*, DataPath*> upserted_outgoing; /**< The oriented DataPaths of outgoing indexed by UpsertDataPath(), by their target. */
+    unordered_map<Component*, DataPath*> upserted_bidirectional; /**< The bidirectional DataPaths of bidirectional indexed by UpsertDataPath(), by their other endpoint. A bidirectional DataPath is indexed by its endpoint with the lower address. */
+};
 
 /**
 Generic class Component - all components inherit from this class, i.e. this class defines attributes and methods common to all components.
@@ -57,9 +81,18 @@ public:
     */
     Component(Component * parent, int _id = 0, string _name = "unknown", int _componentType = SYS_SAGE_COMPONENT_NONE);
     /**
-     * TODO
+    Component destructor. Releases the subcomponent index (if enabled); it does not touch the children or the data paths of the component (use Delete() for that).
     */
-    virtual ~Component() = default;
+    virtual ~Component();
+    /**
+    Allocates memory for a Component (or any class that inherits from Component). If an Arena is active in the current thread, the Component is allocated from it, otherwise from the heap.
+    @see ArenaScope
+    */
+    static void* operator new(size_t size);
+    /**
+    Releases memory of a Component. Components allocated from an Arena only give their memory back when the Arena is destroyed; until then, it is reused for new Components of the same size.
+    */
+    static void operator delete(void* ptr, size_t size);
     /**
     Inserts a Child component to this component (in the Component Tree).
     The child pointer will be inserted at the end of std::vector of children (retrievable through GetChildren(), GetChild(int _id) etc.)
@@ -108,6 +141,12 @@ public:
     */
     int GetId();
     /**
+    Returns the count of the component (number of components with the same properties it represents; -1 by default).
+    @return count
+    @see count
+    */
+    int GetCount();
+    /**
     Returns component type of the component. The component type denotes of which class the instance is (Often the components are stored as Component*, even though they are a member of one of the child classes)
     \n SYS_SAGE_COMPONENT_NONE -> class Component
     \n SYS_SAGE_COMPONENT_THREAD -> class Thread
@@ -179,6 +218,30 @@ public:
     @return Component * matching the criteria. Returns the first match. NULL if no match found
     */
     Component* GetSubcomponentById(int _id, int _componentType);
+    /**
+    Retrieves all components with a matching id and componentType in the subtree (including the calling component), in DFS order. Useful when the IDs are not unique within the subtree.
+    @param _id - the id to look for
+    @param _componentType - the component type where to look for the id
+    @return std::vector of all matching components (empty if no match found)
+    @see GetSubcomponentById()
+    */
+    vector<Component*> GetAllSubcomponentsById(int _id, int _componentType);
+    /**
+    Builds an index of the subtree of this component (including the component itself), keyed by (componentType, id). While the index exists, GetSubcomponentById() and GetAllSubcomponentsById() called on this component are answered by a hash lookup instead of a DFS.
+    \n The index is kept up to date by InsertChild(), RemoveChild() and Delete() anywhere in the subtree. Components whose parent is changed only via SetParent() are not tracked.
+    \n Components with duplicate IDs are supported; the first match in DFS order is returned, as without the index.
+    \n Calling this method on a component which already has an index does nothing.
+    @see DisableSubcomponentIndex()
+    */
+    void EnableSubcomponentIndex();
+    /**
+    Removes the index built by EnableSubcomponentIndex() (if any).
+    */
+    void DisableSubcomponentIndex();
+    /**
+    @return true if this component has an index built by EnableSubcomponentIndex()
+    */
+    bool HasSubcomponentIndex();
     /**
      * TODO
     */
@@ -188,11 +251,11 @@ public:
     */
     vector<Component*> GetAllSubcomponentsByType(int _componentType);
     /**
-     * TODO
+    Counts all components in the subtree (not including the component itself). Answered in O(1) from aggregates maintained by InsertChild() and RemoveChild().
     */
     int CountAllSubcomponents();
     /**
-     * TODO
+    Counts the components of type _componentType in the subtree (not including the component itself). For the SYS_SAGE_COMPONENT_* types, answered in O(1) from aggregates maintained by InsertChild() and RemoveChild(); other component types are counted by a DFS.
     */
     int CountAllSubcomponentsByType(int _componentType);
     /**
@@ -205,19 +268,55 @@ public:
     OBSOLETE. Use GetAncestorType instead. This function will be removed in the future.
     */
     Component* FindParentByType(int _componentType);
+    /**
+    Checks whether this component lies in the subtree of another component.
+    \n Answered in O(1) using DFS interval labels (pre-order and post-order numbers) of the Component Tree. The labels are computed lazily: the first query after the tree has been modified (InsertChild(), RemoveChild(), SetParent(), Delete()) relabels the tree of the queried component once, in O(n); modifications of other trees do not affect them.
+    \n Not thread-safe, although it does not modify the tree: the relabeling writes the labels of the whole tree. Before concurrent queries on a tree, make one query from a single thread after the last modification (as exportToXmlShards() does).
+    @param ancestor - the potential ancestor
+    @return true if ancestor is a (direct or indirect) parent of this component; false otherwise, including when ancestor == this
+    */
+    bool IsDescendantOf(Component* ancestor);
+    /**
+    Retrieves the lowest common ancestor of this component and another component, i.e. the deepest component whose subtree contains both of them. If one of them is an ancestor of the other, it is returned.
+    \n Uses the same DFS interval labels as IsDescendantOf().
+    @param other - the other component
+    @return the lowest common ancestor; NULL if the components are not in the same Component Tree
+    */
+    Component* GetLowestCommonAncestor(Component* other);
+    /**
+    Retrieves the lowest common ancestor of this component and another component which is of the given component type. E.g. for two threads and SYS_SAGE_COMPONENT_CACHE, returns the lowest cache shared by both threads.
+    @param other - the other component
+    @param _componentType - the required component type of the ancestor
+    @return the lowest common ancestor of type _componentType; NULL if there is none
+    @see GetLowestCommonAncestor(Component* other)
+    */
+    Component* GetLowestCommonAncestor(Component* other, int _componentType);
+    /**
+    Retrieves the version (epoch) of the Component Tree this component belongs to, kept at its root. The tree gets a new epoch, unique across all trees, on every modification of the tree (InsertChild(), RemoveChild(), SetParent(), Delete()), including attaching it to another tree; modifications of other trees do not change it. It is used to invalidate data derived from the tree structure (e.g. DataPathGraph).
+    \n Takes O(depth) to find the root.
+    @returns the current epoch of the tree
+    */
+    uint64_t GetTreeEpoch();
 
     /**
     OBSOLETE. Use int CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD) instead.
-    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree.
+    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree. Answered in O(1).
     */
     int GetNumThreads();
     /**
     Retrieves maximal distance to a leaf (i.e. the depth of the subtree).
     \n 0=leaf, 1=children are leaves, 2=at most children's children are leaves .....
+    \n Answered in O(1) from aggregates maintained by InsertChild() and RemoveChild().
     @return maximal distance to a leaf
     */
     int GetTopoTreeDepth();//0=empty, 1=1element,...
     /**
+    Retrieves the Arena of the Topology this component belongs to, i.e. moves up the tree to the root, and if the root is a Topology with an enabled Arena, returns it.
+    @return the Arena, or NULL if the root is not a Topology or the Topology does not use an Arena
+    @see Topology::EnableArena()
+    */
+    Arena* FindArena();
+    /**
     Retrieves a std::vector of Component pointers, which reside 'depth' levels deeper. The tree is traversed in order as the children are stored in std::vector children.
     \n E.g. if depth=1, only children of the current are retrieved; if depth=2, only children of the children are retrieved..
     @param depth - how many levels down the tree should be looked
@@ -247,23 +346,46 @@ public:
 
     /**
     Returns the DataPaths of this component according to their orientation.
+    \n Bidirectional DataPaths are stored only once per component (in dp_bidirectional), but belong to both orientations, i.e. they are returned for SYS_SAGE_DATAPATH_OUTGOING as well as for SYS_SAGE_DATAPATH_INCOMING.
     @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
-    @return Pointer to std::vector<DataPath *> with the result (dp_outgoing on SYS_SAGE_DATAPATH_OUTGOING, or dp_incoming on SYS_SAGE_DATAPATH_INCOMING, otherwise NULL)
+    @return View of the result: dp_outgoing (on SYS_SAGE_DATAPATH_OUTGOING) or dp_incoming (on SYS_SAGE_DATAPATH_INCOMING), followed by dp_bidirectional; empty if the orientation is not valid.
     @see dp_incoming
     @see dp_outgoing
+    @see dp_bidirectional
+    */
+    DataPathList GetDataPathList(int orientation);
+    /**
+    Obsolete; use GetDataPathList() instead, which does not copy anything.
+    \n Returns the DataPaths of this component according to their orientation (including the bidirectional ones, see GetDataPathList()) in a std::vector.
+    @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
+    @return Pointer to std::vector<DataPath *> with a copy of the result, owned by the component; NULL if the orientation is not valid. The vector is cached: it stays the same object, and is only refilled by a call after the DataPaths of the component have changed (so it must not be iterated while DataPaths are added or removed, as before).
     */
     vector<DataPath*>* GetDataPaths(int orientation);
     /**
     !!Normally should not be called; Use NewDataPath() instead!!
-    Stores (pushes back) a DataPath pointer to the list(std::vector) of DataPaths of this component. According to the orientation param, the proper list is chosen.
+    Stores (pushes back) a DataPath pointer to the list(std::vector) of DataPaths of this component. According to the orientation param, the proper list is chosen; bidirectional DataPaths always land in dp_bidirectional (a bidirectional loop is stored only once).
     @param p - the pointer to store
-    @param orientation - orientation of the DataPath. Either SYS_SAGE_DATAPATH_OUTGOING (lands in dp_outgoing) or SYS_SAGE_DATAPATH_INCOMING (lands in dp_incoming)
+    @param orientation - orientation of the DataPath. Either SYS_SAGE_DATAPATH_OUTGOING (this component is the source; lands in dp_outgoing) or SYS_SAGE_DATAPATH_INCOMING (this component is the target; lands in dp_incoming)
     @see NewDataPath()
     */
     void AddDataPath(DataPath* p, int orientation);
     /**
+    !!Normally should not be called; Use DataPath::DeleteDataPath() instead!!
+    Removes a DataPath pointer from the list(std::vector) of DataPaths of this component. According to the orientation param, the proper list is chosen.
+    @param p - the pointer to remove
+    @param orientation - orientation of the DataPath. Either SYS_SAGE_DATAPATH_OUTGOING (this component is the source; removed from dp_outgoing) or SYS_SAGE_DATAPATH_INCOMING (this component is the target; removed from dp_incoming). Bidirectional DataPaths are removed from dp_bidirectional.
+    \n Takes constant time; the last DataPath of the list is moved to the place of the removed one.
+    */
+    void RemoveDataPath(DataPath* p, int orientation);
+    /**
+    Deletes all DataPaths of the given type leading to or from this component (see DataPath::DeleteDataPath()).
+    \n Takes time linear in the number of deleted DataPaths.
+    @param dp_type - DataPath type (dp_type) of the DataPaths to delete
+    */
+    void DeleteDataPathsByType(int dp_type);
+    /**
     Retrieves a DataPath * from the list of this component's data paths with matching type and orientation.
-    \n The first match is returned -- first SYS_SAGE_DATAPATH_OUTGOING are searched, then SYS_SAGE_DATAPATH_INCOMING.
+    \n The first match is returned -- first the oriented SYS_SAGE_DATAPATH_OUTGOING are searched, then the oriented SYS_SAGE_DATAPATH_INCOMING, then the bidirectional ones.
     @param dp_type - DataPath type (dp_type) to search for
     @param orientation - orientation of the DataPath (SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING or a logical or of these)
     @return DataPath pointer to the found data path; NULL if nothing found.
@@ -271,7 +393,7 @@ public:
     DataPath* GetDpByType(int dp_type, int orientation);
     /**
     Retrieves all DataPath * from the list of this component's data paths with matching type and orientation.
-    Results are returned in vector<DataPath*>* outDpArr, where first the matching data paths in dp_outgoing are pushed back, then the ones in dp_incoming.
+    Results are returned in vector<DataPath*>* outDpArr, where first the matching data paths in dp_outgoing are pushed back, then the ones in dp_incoming, then the ones in dp_bidirectional (each only once, even if both orientations are requested).
     @param dp_type - DataPath type (dp_type) to search for.
     @param orientation - orientation of the DataPath (SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING or a logical or of these)
     @param outDpArr - output parameter (vector with results)
@@ -279,6 +401,36 @@ public:
         \n The method pushes back the found data paths -- i.e. the data paths(pointers) can be found in this array after the method returns. (If no found, the vector is not changed.)
     */
     void GetAllDpByType(vector<DataPath*>* outDpArr, int dp_type, int orientation);
+    /**
+    Returns the DataPaths of this component with matching type and orientation, without searching through all DataPaths of the component.
+    @param dp_type - DataPath type (dp_type)
+    @param orientation - either SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING
+    @return View of the result (the oriented DataPaths, followed by the bidirectional ones, see GetDataPathList()); empty if there are none or the orientation is not valid. The view is only valid until DataPaths of this component with a new type are added, or the last DataPath of a type is removed.
+    */
+    DataPathList GetDataPathsByType(int dp_type, int orientation);
+    /**
+    Retrieves all DataPath * from the list of this component's data paths whose type is one of the single-bit types in dp_type_mask, e.g. SYS_SAGE_DATAPATH_TYPE_L3CAT | SYS_SAGE_DATAPATH_TYPE_MIG.
+    \n Results are grouped by type; for each type, first the matching data paths in dp_outgoing are pushed back, then the ones in dp_incoming, then the ones in dp_bidirectional (see GetAllDpByType()).
+    @param dp_type_mask - bitwise OR of the DataPath types to search for (DataPaths of user-defined types that are not a single bit are never matched)
+    @param orientation - orientation of the DataPath (SYS_SAGE_DATAPATH_OUTGOING or SYS_SAGE_DATAPATH_INCOMING or a logical or of these)
+    @param outDpArr - output parameter (vector with results)
+        \n An input is pointer to a std::vector<DataPath *>, in which the data paths will be pushed. It must be allocated before the call (but does not have to be empty).
+    */
+    void GetAllDpByTypeMask(vector<DataPath*>* outDpArr, int dp_type_mask, int orientation);
+    /**
+    @returns bitwise OR of the types of all DataPaths of this component whose type is a single bit (such as all predefined SYS_SAGE_DATAPATH_TYPE_* types)
+    */
+    uint32_t GetDpTypeMask();
+    /**
+    Retrieves the stamp of the last change of this component's DataPaths, i.e. the DataPath::GetVersion() right after a DataPath of this component was last added or removed. Data derived from the DataPaths of a set of components (e.g. DataPathRollup) only has to be recomputed for the components whose stamp is newer than the version it was computed at.
+    @returns the stamp (0 if the DataPaths of this component have never changed)
+    */
+    uint64_t GetDataPathStamp();
+    /**
+    Retrieves the DataPathMatrix objects attached to this component (see DataPathMatrix::GetOwner()).
+    @return the matrices, in the order of their creation
+    */
+    vector<DataPathMatrix*> GetDataPathMatrices();
     /**
      * TODO
     */
@@ -291,8 +443,8 @@ public:
     */
     int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize);
     /**
-    Helper function of int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize); -- normally you would call this one.
-    \n Calculates approximate memory footprint of the subtree of this element (including the relevant data paths). Does not count DataPaths stored in counted_dataPaths.
+    Variant of int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize); -- normally you would call that one.
+    \n Calculates approximate memory footprint of the subtree of this element (including the relevant data paths). Does not count DataPaths stored in counted_dataPaths, and adds the counted ones to it (e.g. to measure several subtrees without counting the DataPaths between them twice). If counted_dataPaths is NULL, each DataPath is counted once without any bookkeeping.
     @param out_component_size - output parameter (contains the footprint of the component tree elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
     @param out_dataPathSize - output parameter (contains the footprint of the data-path graph elements); an already allocated unsigned * is the input, the value is expected to be 0 (the result is accumulated here)
     @param counted_dataPaths - std::set<DataPath*>* of data paths that should not be counted
@@ -302,17 +454,28 @@ public:
     int GetTopologySize(unsigned * out_component_size, unsigned * out_dataPathSize, std::set<DataPath*>* counted_dataPaths);
 
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the element of the component, its attributes (encoded by codecs) and (recursively) its children to the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
+    */
+    void WriteXmlSubtree(xmlTextWriterPtr writer, AttributeCodecRegistry* codecs);
+    /**
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
     */
-    xmlNodePtr CreateXmlSubtree();
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
+    */
+    void LoadXmlProperties(xmlTextReaderPtr reader);
     
     /**
     Deletes all DataPaths of this component.
     */
     void DeleteAllDataPaths();
     /**
-    Deletes the whole subtree (all the children) of the component.
+    Deletes the whole subtree (all the children) of the component, together with all data paths leading to/from any component of the subtree.
+    \n The subtree is detached at once and all components and data paths are freed in a single pass, i.e. in time linear in the size of the subtree and the number of affected data paths.
     */
     void DeleteSubtree();
     /**
@@ -323,9 +486,11 @@ public:
     void Delete(bool withSubtree = true);
 
     /**
-    TODO this part
+    Attributes of the component (key -> value), e.g. attributes filled in by the parsers or custom attributes of the user.
+    \n Use attrib.Set<T>(key, value) and attrib.Get<T>(key) for typed values owned by the component; the std::map<string,void*>-like interface (attrib[key], attrib.insert(), ...) stores raw pointers owned by the caller.
+    @see AttributeStore
     */
-    map<string,void*> attrib;
+    AttributeStore attrib { Arena::TakeObjectOwner(this) };
 protected:
 
     int id; /**< Numeric ID of the component. There is no requirement for uniqueness of the ID, however it is advised to have unique IDs at least in the realm of parent's children. Some tree search functions, which take the id as a search parameter search for first match, so the user is responsible to manage uniqueness in the realm of the search subtree (or should be aware of the consequences of not doing so). Component's ID is set by the constructor, and is retrieved via int GetId(); */
@@ -350,10 +515,56 @@ protected:
     const int componentType;
     vector<Component*> children; /**< Contains the list (std::vector) of pointers to children of the component in the component tree. */
     Component* parent { nullptr }; /**< Contains pointer to the parent component in the component tree. If this component is the root, parent will be NULL.*/
-    vector<DataPath*> dp_incoming; /**< Contains references to data paths that point to this component. @see DataPath */
-    vector<DataPath*> dp_outgoing; /**< Contains references to data paths that point from this component. @see DataPath */
+    vector<DataPath*> dp_incoming; /**< Contains references to oriented data paths that point to this component. @see DataPath */
+    vector<DataPath*> dp_outgoing; /**< Contains references to oriented data paths that point from this component. @see DataPath */
+    vector<DataPath*> dp_bidirectional; /**< Contains references to bidirectional data paths with this component as one of the endpoints (stored once, see GetDataPathList()). @see DataPath */
+    vector<DataPathBucket> dp_buckets; /**< The DataPaths of dp_incoming, dp_outgoing and dp_bidirectional grouped by type. Buckets of single-bit types come first, ordered by the bit (see dp_type_mask), followed by the buckets of the other types. Empty buckets are removed. */
+    uint32_t dp_type_mask { 0 }; /**< Bitwise OR of the single-bit types of the buckets in dp_buckets; the bucket of such a type is found at position popcount(dp_type_mask & (type-1)). */
+    uint64_t dp_stamp { 0 }; /**< DataPath::GetVersion() after the last change of dp_incoming, dp_outgoing or dp_bidirectional. @see GetDataPathStamp() */
 
 private:
+    friend class DataPath;
+    friend class DataPathBatch;
+    friend class DataPathMatrix;
+    friend DataPath* UpsertDataPath(Component* _source, Component* _target, int _oriented, int _type, double _bw, double _latency);
+    void AddDataPathMatrix(DataPathMatrix* m);
+    void RemoveDataPathMatrix(DataPathMatrix* m);
+    void AddToSubcomponentIndexes(Component* subtreeRoot);
+    void RemoveFromSubcomponentIndexes(Component* subtreeRoot);
+    Component* GetTreeRoot();
+    void NewTreeEpoch();
+    static void ClearTreeLabels(Component* subtreeRoot);
+    bool HasFreshTreeLabels();
+    void UpdateTreeLabels();
+    bool PrecedesInDfs(Component* other);
+    void AddToSubtreeAggregates(Component* child);
+    void RemoveFromSubtreeAggregates(int size, const int* type_count);
+    static void DeleteDataPathsOf(vector<Component*>& components);
+    DataPathBucket* FindDpBucket(int dp_type);
+    DataPathBucket* AddDpBucket(int dp_type);
+    void ReserveDataPaths(int dp_type, size_t num_outgoing, size_t num_incoming, size_t num_bidirectional);
+    void RemoveDpBucket(DataPathBucket* bucket);
+    int GetDpEndpoint(DataPath* p, int orientation);
+    vector<DataPath*>* GetDpList(DataPath* p, int e, DataPathBucket* bucket);
+    void UnlinkDataPath(DataPath* p, int e);
+    void UnlinkDpSlot(vector<DataPath*>* v, int e, int k, int i);
+    int GetDataPathsSize(Component* root, std::set<DataPath*>* counted_dataPaths);
+
+    static std::atomic<uint64_t> last_tree_epoch; /**< The last epoch given to a tree. Epochs are unique across all trees, so that a tree which is attached to another one never reuses an epoch; atomic, so that separate trees can be modified concurrently. */
+    uint64_t tree_epoch { 0 }; /**< Epoch of the tree of which this component is the root; replaced by a new epoch on every modification of the tree. Not used by components which are not a root. */
+    uint64_t label_epoch { 0 }; /**< tree_epoch of label_root when dfs_pre, dfs_post and ancestor_types were computed; the labels are stale if it differs. */
+    Component* label_root { nullptr }; /**< Root of the tree this component belonged to when the labels were computed; NULL if there are no labels. Reset in the whole subtree when the component is detached from its tree, so it never refers to a component of another tree. */
+    int dfs_pre { 0 }; /**< Number assigned when the DFS enters this component (Euler tour). */
+    int dfs_post { 0 }; /**< Number assigned when the DFS leaves this component (Euler tour); the subtree occupies the interval [dfs_pre, dfs_post]. */
+    uint32_t ancestor_types { 0 }; /**< Bitwise OR of the component types of this component and all its ancestors. */
+    int subtree_size { 1 }; /**< Number of components in the subtree (including this component). Maintained by InsertChild() and RemoveChild(). */
+    int subtree_height { 0 }; /**< Maximal distance to a leaf (see GetTopoTreeDepth()). Maintained by InsertChild() and RemoveChild(). */
+    int subtree_type_count[SYS_SAGE_NUM_COMPONENT_TYPES] {}; /**< Number of components of each SYS_SAGE_COMPONENT_* type in the subtree (including this component), indexed by the position of the type bit. Maintained by InsertChild() and RemoveChild(). */
+
+    unordered_map<uint64_t, vector<Component*>>* subcomponentIndex { nullptr }; /**< Index of the subtree: (componentType, id) -> matching components. NULL unless EnableSubcomponentIndex() was called. */
+    vector<DataPath*>* dp_copies[2] { nullptr, nullptr }; /**< Copies returned by GetDataPaths() (outgoing, incoming); NULL until it is called. */
+    uint64_t dp_copy_stamps[2] { 0, 0 }; /**< dp_stamp when dp_copies were filled. */
+    vector<DataPathMatrix*>* dp_matrices { nullptr }; /**< DataPathMatrix objects attached to (and owned by) this component; NULL if there are none. */
 };
 
 /**
@@ -370,10 +581,30 @@ public:
     */
     Topology();
     /**
-     * TODO
+    Topology destructor. If the Topology uses an Arena, the Arena is destroyed as well, i.e. all Components and DataPaths allocated from it are freed at once.
     */
-    ~Topology() override = default;
+    ~Topology() override;
+    /**
+    Creates an Arena owned by this Topology (opt-in). Components and DataPaths created by the parsers in this Topology are then allocated from the Arena; other code can allocate from it by opening an ArenaScope.
+    \n When the Topology is destroyed, all objects in the Arena are freed at once, without walking and unlinking them one by one.
+    \n If the Topology already has an Arena, the existing one is returned.
+    @param chunk_size - size (in Bytes) of one memory chunk of the Arena, default SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE
+    @return the Arena of this Topology
+    @see ArenaScope
+    */
+    Arena* EnableArena(size_t chunk_size = SYS_SAGE_ARENA_DEFAULT_CHUNK_SIZE);
+    /**
+    @return the Arena of this Topology, or NULL if EnableArena() was not called.
+    */
+    Arena* GetArena();
+    /**
+    Creates a frozen snapshot of the Component Tree under this Topology, flattened into contiguous arrays. Read-heavy queries (e.g. repeated lookups by id or type) are faster on the snapshot; it has to be re-created after the Component Tree changes.
+    @return TopologyView of this Topology
+    @see TopologyView
+    */
+    TopologyView Freeze();
 private:
+    Arena* arena { nullptr }; /**< Arena owned by this Topology (NULL if not enabled). */
 };
 
 /**
@@ -410,7 +641,7 @@ public:
     /**
     !!! Only if compiled with CAT_AWARE functionality, only for Intel CPUs !!!
     \n Creates/updates (bidirectional) data paths between all cores (class Thread) and their L3 cache segment (class Cache). The data paths of type SYS_SAGE_DATAPATH_TYPE_L3CAT contain the COS id (attrib with key "CATcos", value is of type uint64_t*) and the open L3 cache ways (attrib with key "CATL3mask", value is of type uint64_t*) to contain the current settings.
-    \n Each time the method is called, new DataPath objects get created, so the last one is always the most up-to-date.
+    \n Each time the method is called, the existing L3CAT DataPath between a core and its L3 cache is reused (see UpsertDataPath()) and its attributes are overwritten in place, so there is exactly one such DataPath per core, holding the most up-to-date settings.
     */
     int UpdateL3CATCoreCOS();
 #endif
@@ -452,13 +683,22 @@ public:
     */
     void SetSize(long long _size);
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    @returns true if the memory is volatile
+    */
+    bool GetIsVolatile();
+    /**
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
+    */
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
     */
-    xmlNodePtr CreateXmlSubtree();
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 private:
-    long long size; /**< size/capacity of the memory element*/
-    bool is_volatile; /**< is volatile? */
+    long long size { -1 }; /**< size/capacity of the memory element*/
+    bool is_volatile { false }; /**< is volatile? */
 
 #ifdef NVIDIA_MIG
 public:
@@ -500,10 +740,15 @@ public:
     */
     void SetSize(long long _size);
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
     */
-    xmlNodePtr CreateXmlSubtree();
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
+    */
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 private:
     long long size; /**< size/capacity of the storage device */
 };
@@ -560,10 +805,15 @@ public:
     */
     int GetChipType();
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
     */
-    xmlNodePtr CreateXmlSubtree();
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
+    */
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 private:
     string vendor; /**< TODO  */
     string model; /**< TODO  */
@@ -648,10 +898,15 @@ public:
     */
     void SetCacheLineSize(int _cache_line_size);
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
+    */
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
     */
-    xmlNodePtr CreateXmlSubtree();
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 private:
     string cache_type; /**< cache level or cache type */
     long long cache_size;  /**< size/capacity of the cache */
@@ -698,10 +953,15 @@ public:
     */
     int GetSubdivisionType();
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
+    */
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
     */
-    xmlNodePtr CreateXmlSubtree();
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 protected:
     int type; /**< Type of the subdivision. Each user can have his own numbering, i.e. the type is there to identify different types of subdivisions as the user defines it.*/
 };
@@ -740,10 +1000,15 @@ public:
     long long GetSize();
 
     /**
-    !!Should normally not be used!! Helper function of XML dump generation.
-    @see exportToXml(Component* root, string path = "", std::function<int(string,void*,string*)> custom_search_attrib_key_fcn = NULL);
+    !!Should normally not be used!! Helper function of XML dump generation: writes the properties of the component as attributes of the current element of the writer.
+    @see exportToXml(Component* root, string path, AttributeCodecRegistry* codecs);
+    */
+    void WriteXmlProperties(xmlTextWriterPtr writer);
+    /**
+    !!Should normally not be used!! Helper function of XML import: sets the properties of the component from the attributes of the current element of the reader.
+    @see importFromXml()
     */
-    xmlNodePtr CreateXmlSubtree();
+    void LoadXmlProperties(xmlTextReaderPtr reader);
 private:
     long long size; /**< size of the Numa memory segment.*/
 };
@@ -0,0 +1,129 @@
+#include "TopologyView.hpp"
+
+#include <tuple>
+
+TopologyView::TopologyView(Component* root)
+{
+    if(root == NULL)
+        return;
+
+    //iterative DFS pre-order; stack entries: component, index of its parent, depth
+    vector<tuple<Component*,int,int>> stack;
+    vector<int> lastChild;
+    stack.push_back({root, -1, 0});
+    while(!stack.empty())
+    {
+        auto [c, p, d] = stack.back();
+        stack.pop_back();
+
+        int i = components.size();
+        components.push_back(c);
+        componentType.push_back(c->GetComponentType());
+        id.push_back(c->GetId());
+        parent.push_back(p);
+        firstChild.push_back(-1);
+        nextSibling.push_back(-1);
+        depth.push_back(d);
+        lastChild.push_back(-1);
+        index[c] = i;
+        if(p >= 0)
+        {
+            if(firstChild[p] == -1)
+                firstChild[p] = i;
+            else
+                nextSibling[lastChild[p]] = i;
+            lastChild[p] = i;
+        }
+
+        vector<Component*>* children = c->GetChildren();
+        for(auto it = children->rbegin(); it != children->rend(); ++it)
+            stack.push_back({*it, i, d + 1});
+    }
+
+    int n = components.size();
+    subtreeEnd.resize(n);
+    for(int i = 0; i < n; i++)
+        subtreeEnd[i] = i + 1;
+    //children always follow their parent, so one backward pass propagates the subtree ends
+    for(int i = n - 1; i > 0; i--)
+    {
+        if(subtreeEnd[i] > subtreeEnd[parent[i]])
+            subtreeEnd[parent[i]] = subtreeEnd[i];
+    }
+
+    threadsBefore.resize(n + 1);
+    threadsBefore[0] = 0;
+    for(int i = 0; i < n; i++)
+        threadsBefore[i + 1] = threadsBefore[i] + (componentType[i] == SYS_SAGE_COMPONENT_THREAD ? 1 : 0);
+}
+
+int TopologyView::GetNumComponents(){return components.size();}
+Component* TopologyView::GetComponent(int idx){return components[idx];}
+int TopologyView::GetIndex(Component* c)
+{
+    auto it = index.find(c);
+    if(it == index.end())
+        return -1;
+    return it->second;
+}
+int TopologyView::GetComponentType(int idx){return componentType[idx];}
+int TopologyView::GetId(int idx){return id[idx];}
+int TopologyView::GetParentIndex(int idx){return parent[idx];}
+int TopologyView::GetFirstChildIndex(int idx){return firstChild[idx];}
+int TopologyView::GetNextSiblingIndex(int idx){return nextSibling[idx];}
+int TopologyView::GetSubtreeEnd(int idx){return subtreeEnd[idx];}
+int TopologyView::GetDepth(int idx){return depth[idx];}
+
+Component* TopologyView::GetSubcomponentById(int _id, int _componentType, int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return NULL;
+    int end = subtreeEnd[idx];
+    for(int i = idx; i < end; i++)
+    {
+        if(componentType[i] == _componentType && id[i] == _id)
+            return components[i];
+    }
+    return NULL;
+}
+
+void TopologyView::GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return;
+    int end = subtreeEnd[idx];
+    for(int i = idx; i < end; i++)
+    {
+        if(componentType[i] == _componentType)
+            outArray->push_back(components[i]);
+    }
+}
+vector<Component*> TopologyView::GetAllSubcomponentsByType(int _componentType, int idx)
+{
+    vector<Component*> ret;
+    GetAllSubcomponentsByType(&ret, _componentType, idx);
+    return ret;
+}
+
+int TopologyView::CountAllSubcomponentsByType(int _componentType, int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return 0;
+    int end = subtreeEnd[idx];
+    int cnt = 0;
+    for(int i = idx + 1; i < end; i++)
+        cnt += (componentType[i] == _componentType);
+    return cnt;
+}
+
+int TopologyView::GetNumThreads(int idx)
+{
+    if(idx < 0 || idx >= (int)components.size())
+        return 0;
+    return threadsBefore[subtreeEnd[idx]] - threadsBefore[idx];
+}
+
+TopologyView Topology::Freeze()
+{
+    return TopologyView(this);
+}
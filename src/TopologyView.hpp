@@ -0,0 +1,113 @@
+#ifndef TOPOLOGY_VIEW
+#define TOPOLOGY_VIEW
+
+#include <vector>
+#include <unordered_map>
+
+#include "Topology.hpp"
+
+using namespace std;
+
+/**
+Class TopologyView - a frozen, read-only snapshot of a Component Tree, flattened into contiguous arrays (structure of arrays).
+\n The components of the subtree are stored in DFS pre-order, i.e. the root of the view has index 0 and the subtree of a component with index i occupies the index range [i, GetSubtreeEnd(i)). For each component, its component type, id, parent, first child, next sibling, subtree end and depth are stored in separate arrays, so that the queries below scan contiguous memory instead of following Component pointers.
+\n The view is not updated when the Component Tree changes; create a new view (e.g. with Topology::Freeze()) after modifying the tree.
+\n The query methods mirror the methods of class Component; each of them takes the index of the component to start from (default 0, i.e. the root of the view).
+*/
+class TopologyView {
+public:
+    /**
+    Creates a view of the subtree of root (including root itself).
+    @param root - the root of the view. Any component can be the root.
+    */
+    TopologyView(Component* root);
+    /**
+    Creates an empty view.
+    */
+    TopologyView() = default;
+
+    /**
+    @returns the number of components in the view
+    */
+    int GetNumComponents();
+    /**
+    @returns the Component stored at index idx
+    */
+    Component* GetComponent(int idx);
+    /**
+    Retrieves the index of a component in the view.
+    @return index of c, or -1 if c is not part of the view
+    */
+    int GetIndex(Component* c);
+    /**
+    @returns component type of the component at index idx
+    */
+    int GetComponentType(int idx);
+    /**
+    @returns id of the component at index idx
+    */
+    int GetId(int idx);
+    /**
+    @returns index of the parent of the component at index idx, or -1 for the root of the view
+    */
+    int GetParentIndex(int idx);
+    /**
+    @returns index of the first child of the component at index idx, or -1 if it is a leaf
+    */
+    int GetFirstChildIndex(int idx);
+    /**
+    @returns index of the next sibling of the component at index idx, or -1 if it is the last child of its parent
+    */
+    int GetNextSiblingIndex(int idx);
+    /**
+    @returns the end (exclusive) of the index range occupied by the subtree of the component at index idx
+    */
+    int GetSubtreeEnd(int idx);
+    /**
+    @returns distance of the component at index idx from the root of the view (the root has depth 0)
+    */
+    int GetDepth(int idx);
+
+    /**
+    Searches the subtree of the component at index idx for a component with a matching id and componentType. Returns the first match in DFS order (the same one as Component::GetSubcomponentById()).
+    @param _id - the id to look for
+    @param _componentType - the component type where to look for the id
+    @param idx - index of the component where the search starts, default 0 (root of the view)
+    @return Component * matching the criteria; NULL if no match found
+    */
+    Component* GetSubcomponentById(int _id, int _componentType, int idx = 0);
+    /**
+    Retrieves all components of type _componentType in the subtree of the component at index idx (including itself), in DFS order.
+    @param outArray - output parameter; the found components are pushed back
+    @param _componentType - the component type to look for
+    @param idx - index of the component where the search starts, default 0 (root of the view)
+    */
+    void GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx = 0);
+    /**
+    Retrieves all components of type _componentType in the subtree of the component at index idx (including itself), in DFS order.
+    @see GetAllSubcomponentsByType(vector<Component*>* outArray, int _componentType, int idx = 0)
+    */
+    vector<Component*> GetAllSubcomponentsByType(int _componentType, int idx = 0);
+    /**
+    Counts the components of type _componentType in the subtree of the component at index idx (not including the component itself, as Component::CountAllSubcomponentsByType()).
+    */
+    int CountAllSubcomponentsByType(int _componentType, int idx = 0);
+    /**
+    Returns the number of Components of type SYS_SAGE_COMPONENT_THREAD in the subtree of the component at index idx. Answered in O(1).
+    */
+    int GetNumThreads(int idx = 0);
+
+private:
+    vector<Component*> components; /**< Components in DFS pre-order. */
+    vector<int> componentType; /**< componentType of each component. */
+    vector<int> id; /**< id of each component. */
+    vector<int> parent; /**< index of the parent (-1 for the root). */
+    vector<int> firstChild; /**< index of the first child (-1 for leaves). */
+    vector<int> nextSibling; /**< index of the next sibling (-1 for the last child). */
+    vector<int> subtreeEnd; /**< end (exclusive) of the index range of the subtree. */
+    vector<int> depth; /**< distance from the root of the view. */
+    vector<int> threadsBefore; /**< number of threads at indexes lower than i (prefix sum; one extra element at the end). */
+    unordered_map<Component*, int> index; /**< Component* -> index */
+};
+
+#endif
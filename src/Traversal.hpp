@@ -0,0 +1,273 @@
+#ifndef TRAVERSAL
+#define TRAVERSAL
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <algorithm>
+
+#include "Topology.hpp"
+
+#define SYS_SAGE_TRAVERSAL_STACK_DEPTH 16 /**< Number of tree levels for which a traversal iterator remembers the child positions inline. Deeper levels are still traversed correctly, but finding the next sibling requires a scan of the parent's children. */
+
+using namespace std;
+
+/**
+Maps a Component class to its SYS_SAGE_COMPONENT_* type (used by of_type<T>()).
+*/
+template <class T> struct ComponentTypeOf;
+template <> struct ComponentTypeOf<Thread> { static constexpr int value = SYS_SAGE_COMPONENT_THREAD; };
+template <> struct ComponentTypeOf<Core> { static constexpr int value = SYS_SAGE_COMPONENT_CORE; };
+template <> struct ComponentTypeOf<Cache> { static constexpr int value = SYS_SAGE_COMPONENT_CACHE; };
+template <> struct ComponentTypeOf<Subdivision> { static constexpr int value = SYS_SAGE_COMPONENT_SUBDIVISION; };
+template <> struct ComponentTypeOf<Numa> { static constexpr int value = SYS_SAGE_COMPONENT_NUMA; };
+template <> struct ComponentTypeOf<Chip> { static constexpr int value = SYS_SAGE_COMPONENT_CHIP; };
+template <> struct ComponentTypeOf<Memory> { static constexpr int value = SYS_SAGE_COMPONENT_MEMORY; };
+template <> struct ComponentTypeOf<Storage> { static constexpr int value = SYS_SAGE_COMPONENT_STORAGE; };
+template <> struct ComponentTypeOf<Node> { static constexpr int value = SYS_SAGE_COMPONENT_NODE; };
+template <> struct ComponentTypeOf<Topology> { static constexpr int value = SYS_SAGE_COMPONENT_TOPOLOGY; };
+
+/**
+Class SubtreeIterator - iterates over the subtree of a component (including the component itself) in DFS pre-order (PostOrder = false, the same order as Component::GetSubtreeNodeList()) or post-order (PostOrder = true).
+\n The traversal is iterative and allocates no memory: the positions of the visited components among their siblings are kept in a fixed-size array inside the iterator (see SYS_SAGE_TRAVERSAL_STACK_DEPTH).
+\n The Component Tree must not be modified while it is being traversed.
+\n Usually created through subtree() or subtree_postorder(); the end of the traversal is std::default_sentinel.
+*/
+template <bool PostOrder>
+class SubtreeIterator {
+public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Component*;
+    using difference_type = std::ptrdiff_t;
+    using reference = Component*;
+
+    SubtreeIterator() = default;
+    /**
+    @param _root - root of the traversed subtree
+    */
+    explicit SubtreeIterator(Component* _root) : root(_root), cur(_root)
+    {
+        if(PostOrder && cur != NULL)
+            DescendToFirstLeaf();
+    }
+
+    Component* operator*() const { return cur; }
+    SubtreeIterator& operator++()
+    {
+        if constexpr (PostOrder)
+            NextPostOrder();
+        else
+            NextPreOrder();
+        return *this;
+    }
+    SubtreeIterator operator++(int)
+    {
+        SubtreeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const SubtreeIterator& other) const { return cur == other.cur; }
+    bool operator==(std::default_sentinel_t) const { return cur == NULL; }
+
+    /**
+    @returns distance of the current component from the root of the traversal (the root has depth 0)
+    */
+    int GetDepth() const { return depth; }
+
+private:
+    size_t GetPosition()
+    {
+        if(depth < SYS_SAGE_TRAVERSAL_STACK_DEPTH)
+            return position[depth];
+        vector<Component*>* siblings = cur->GetParent()->GetChildren();
+        return std::find(siblings->begin(), siblings->end(), cur) - siblings->begin();
+    }
+    void SetPosition(size_t pos)
+    {
+        if(depth < SYS_SAGE_TRAVERSAL_STACK_DEPTH)
+            position[depth] = (uint32_t)pos;
+    }
+    void DescendToFirstLeaf()
+    {
+        while(!cur->GetChildren()->empty())
+        {
+            cur = (*cur->GetChildren())[0];
+            depth++;
+            SetPosition(0);
+        }
+    }
+    void NextPreOrder()
+    {
+        vector<Component*>* children = cur->GetChildren();
+        if(!children->empty())
+        {
+            cur = (*children)[0];
+            depth++;
+            SetPosition(0);
+            return;
+        }
+        while(cur != root)
+        {
+            vector<Component*>* siblings = cur->GetParent()->GetChildren();
+            size_t next = GetPosition() + 1;
+            if(next < siblings->size())
+            {
+                cur = (*siblings)[next];
+                SetPosition(next);
+                return;
+            }
+            cur = cur->GetParent();
+            depth--;
+        }
+        cur = NULL;
+    }
+    void NextPostOrder()
+    {
+        if(cur == root)
+        {
+            cur = NULL;
+            return;
+        }
+        vector<Component*>* siblings = cur->GetParent()->GetChildren();
+        size_t next = GetPosition() + 1;
+        if(next < siblings->size())
+        {
+            cur = (*siblings)[next];
+            SetPosition(next);
+            DescendToFirstLeaf();
+        }
+        else
+        {
+            cur = cur->GetParent();
+            depth--;
+        }
+    }
+
+    Component* root { nullptr }; /**< Root of the traversal. */
+    Component* cur { nullptr }; /**< Current component; NULL at the end. */
+    int depth { 0 }; /**< Distance of cur from root. */
+    uint32_t position[SYS_SAGE_TRAVERSAL_STACK_DEPTH] {}; /**< position[d] = index of the current component at depth d among its siblings. */
+};
+
+/**
+Class SubtreeRange - a view of the subtree of a component (including the component itself), see SubtreeIterator. Can be used in range-based for loops and with std::ranges / std::views (e.g. std::views::take), and stopped early without visiting the rest of the subtree.
+\n Usually created through subtree() or subtree_postorder().
+*/
+template <bool PostOrder>
+class SubtreeRange : public std::ranges::view_interface<SubtreeRange<PostOrder>> {
+public:
+    SubtreeRange() = default;
+    /**
+    @param _root - root of the subtree
+    */
+    explicit SubtreeRange(Component* _root) : root(_root) {}
+    SubtreeIterator<PostOrder> begin() const { return SubtreeIterator<PostOrder>(root); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+    /**
+    @returns root of the subtree
+    */
+    Component* GetRoot() const { return root; }
+private:
+    Component* root { nullptr }; /**< Root of the subtree. */
+};
+
+/**
+Filter created by of_type(); combined with a SubtreeRange by operator|.
+*/
+template <class T>
+struct TypeFilter {
+    int componentType; /**< Component type to keep. */
+};
+
+/**
+Class TypedSubtreeIterator - a SubtreeIterator that skips all components except the ones of a given component type, and yields them as T*.
+*/
+template <class T, bool PostOrder>
+class TypedSubtreeIterator {
+public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T*;
+    using difference_type = std::ptrdiff_t;
+    using reference = T*;
+
+    TypedSubtreeIterator() = default;
+    TypedSubtreeIterator(SubtreeIterator<PostOrder> _it, int _componentType) : it(_it), componentType(_componentType)
+    {
+        SkipOtherTypes();
+    }
+
+    T* operator*() const { return static_cast<T*>(*it); }
+    TypedSubtreeIterator& operator++()
+    {
+        ++it;
+        SkipOtherTypes();
+        return *this;
+    }
+    TypedSubtreeIterator operator++(int)
+    {
+        TypedSubtreeIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    bool operator==(const TypedSubtreeIterator& other) const { return it == other.it; }
+    bool operator==(std::default_sentinel_t) const { return it == std::default_sentinel; }
+
+private:
+    void SkipOtherTypes()
+    {
+        while(it != std::default_sentinel && (*it)->GetComponentType() != componentType)
+            ++it;
+    }
+
+    SubtreeIterator<PostOrder> it; /**< Underlying traversal. */
+    int componentType { SYS_SAGE_COMPONENT_NONE }; /**< Component type to keep. */
+};
+
+/**
+Class TypedSubtreeRange - a view of all components of a given type in a subtree, e.g. subtree(node) | of_type<Core>(). Allocates nothing; see SubtreeRange.
+*/
+template <class T, bool PostOrder>
+class TypedSubtreeRange : public std::ranges::view_interface<TypedSubtreeRange<T, PostOrder>> {
+public:
+    TypedSubtreeRange() = default;
+    TypedSubtreeRange(SubtreeRange<PostOrder> _range, int _componentType) : range(_range), componentType(_componentType) {}
+    TypedSubtreeIterator<T, PostOrder> begin() const { return TypedSubtreeIterator<T, PostOrder>(range.begin(), componentType); }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+private:
+    SubtreeRange<PostOrder> range; /**< The unfiltered subtree. */
+    int componentType { SYS_SAGE_COMPONENT_NONE }; /**< Component type to keep. */
+};
+
+/**
+Creates a view of the subtree of root (including root) in DFS pre-order.
+\n Example: for(Component* c : subtree(node)) {...}
+@see SubtreeRange
+*/
+inline SubtreeRange<false> subtree(Component* root) { return SubtreeRange<false>(root); }
+/**
+Creates a view of the subtree of root (including root) in DFS post-order, i.e. each component is visited after all its children.
+@see SubtreeRange
+*/
+inline SubtreeRange<true> subtree_postorder(Component* root) { return SubtreeRange<true>(root); }
+
+/**
+Creates a filter keeping only the components of class T (as determined by ComponentTypeOf<T>); the components are yielded as T*.
+\n Example: for(Core* c : subtree(node) | of_type<Core>()) {...}
+*/
+template <class T> TypeFilter<T> of_type() { return TypeFilter<T>{ComponentTypeOf<T>::value}; }
+/**
+Creates a filter keeping only the components of type _componentType; the components are yielded as Component*.
+\n Example: for(Component* c : subtree(node) | of_type(SYS_SAGE_COMPONENT_CORE)) {...}
+*/
+inline TypeFilter<Component> of_type(int _componentType) { return TypeFilter<Component>{_componentType}; }
+
+template <class T, bool PostOrder>
+TypedSubtreeRange<T, PostOrder> operator|(SubtreeRange<PostOrder> range, TypeFilter<T> filter)
+{
+    return TypedSubtreeRange<T, PostOrder>(range, filter.componentType);
+}
+
+#endif
@@ -16,6 +16,8 @@
 
 #include "Topology.hpp"
 
+static AttributeKey freq_history_key("freq_history");
+
 //retrieve frequency in MHz from /proc/cpuinfo for each thread in vector<Thread*> threads
 //helper function is called by RefreshCpuCoreFrequency/RefreshFreq methods
 int readCpuinfoFreq(std::vector<Thread*> threads, bool keep_history = false)
@@ -76,11 +78,12 @@ int readCpuinfoFreq(std::vector<Thread*> threads, bool keep_history = false)
                     if(keep_history)
                     {
                         //check if freq_history exists; if not, create it -- vector of tuples <timestamp,frequency>
-                        if (c->attrib.find("freq_history") == c->attrib.end()) {
-                            c->attrib["freq_history"] = (void*) new std::vector<std::tuple<long long,double>>();
+                        std::vector<std::tuple<long long,double>>* freq_history = c->attrib.Get<std::vector<std::tuple<long long,double>>>(freq_history_key);
+                        if (freq_history == NULL) {
+                            freq_history = c->attrib.Set<std::vector<std::tuple<long long,double>>>(freq_history_key, {});
                         }
                         long long ts = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-                        ((std::vector<std::tuple<long long,double>>*)c->attrib["freq_history"])->push_back(std::make_tuple(ts,freq));
+                        freq_history->push_back(std::make_tuple(ts,freq));
                     }
                     //cout << "----------------Core " << c->GetId() << " (HW thread " << threads[current_thread_pos]->GetId() << ") frequency: " << freq << endl;
                     threads_processed++;
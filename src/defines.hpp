@@ -0,0 +1,9 @@
+#ifndef DEFINES
+#define DEFINES
+
+//add cmake-style define, so that when headers are included as an external library, the options/defines used during compilation will be reflected also in the headers
+/* #undef CPUINFO */
+/* #undef CAT_AWARE */
+/* #undef NVIDIA_MIG */
+
+#endif
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <string>
 #include <array>
+#include <unordered_map>
 
 #include <nvml.h>
 
@@ -45,24 +46,26 @@ int Chip::UpdateMIGSettings(string uuid)
 
     //cout << "...........multiprocessorCount " << attributes.multiprocessorCount << " gpuInstanceSliceCount=" << attributes.gpuInstanceSliceCount << "  computeInstanceSliceCount=" << attributes.computeInstanceSliceCount << "    memorySizeMB=" << attributes.memorySizeMB << endl;
     
+    //MIG data paths of this MIG instance from a previous update (target -> data path); they are updated instead of adding new ones
+    std::unordered_map<Component*, DataPath*> existing;
+    for(DataPath* dp : GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING)){
+        string* dp_uuid = dp->attrib.Get<string>("mig_uuid");
+        if(dp_uuid != NULL && *dp_uuid == uuid)
+            existing[dp->GetTarget()] = dp;
+    }
+    auto upsert = [this, &existing](Component* target){
+        auto it = existing.find(target);
+        return (it != existing.end()) ? it->second : new DataPath(this, target, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
+    };
+
     //main memory, expects the memory as a child of
     Memory* m = (Memory*)GetChildByType(SYS_SAGE_COMPONENT_MEMORY);
-    long long* mig_size;
+    long long mig_size = 0;
     if(m != NULL){
-        DataPath * d = NULL;
-        //iterate over dp_outgoing to check if DP already exists
-        for(DataPath* dp : dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
-                d = dp;
-                break;
-            }
-        }
-
-        d = new DataPath(this, m, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-        string* mig_uuid = new string(uuid);
-        mig_size = new long long(attributes.memorySizeMB*1000000);
-        d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-        d->attrib.insert({"mig_size",(void*)mig_size});
+        DataPath * d = upsert(m);
+        mig_size = attributes.memorySizeMB*1000000;
+        d->attrib.Set<string>("mig_uuid", uuid);
+        d->attrib.Set<long long>("mig_size", mig_size);
     } else {
         std::cerr << "Chip::UpdateMIGSettings: Component Type Memory not found as a child of this Chip. Memory info will not be updated." << std::endl;
         ret = 1;
@@ -70,8 +73,8 @@ int Chip::UpdateMIGSettings(string uuid)
 
     //L2 cache(s)
     unsigned int L2_fraction = 1; //which fraction of L2 is in MIG partition (the same fraction as the fraction of main memory)
-    if(m->GetSize() > *mig_size){
-        L2_fraction = (m->GetSize() + (*mig_size/2)) / *mig_size; //divide and round up or down
+    if(m != NULL && mig_size > 0 && m->GetSize() > mig_size){
+        L2_fraction = (m->GetSize() + (mig_size/2)) / mig_size; //divide and round up or down
     }
     vector<Component*> caches;
     FindAllSubcomponentsByType(&caches, SYS_SAGE_COMPONENT_CACHE);
@@ -85,14 +88,12 @@ int Chip::UpdateMIGSettings(string uuid)
     if(num_caches > 0){
         int cache_id = 0;
         for(Cache* c : L2_caches){
-            DataPath * d = new DataPath(this, c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-            string* mig_uuid = new string(uuid);
-            mig_size = new long long();
-            *mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
-            if(*mig_size <0)
-                *mig_size=0;
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
-            d->attrib.insert({"mig_size",(void*)mig_size});
+            DataPath * d = upsert(c);
+            long long cache_mig_size = c->GetCacheSize() * ( (float)num_caches/(float)L2_fraction-(float)cache_id/(float)num_caches);
+            if(cache_mig_size <0)
+                cache_mig_size=0;
+            d->attrib.Set<string>("mig_uuid", uuid);
+            d->attrib.Set<long long>("mig_size", cache_mig_size);
             cache_id++;
         }
     } else {
@@ -110,9 +111,8 @@ int Chip::UpdateMIGSettings(string uuid)
     }
     for(Subdivision* sm: sms){
         if(sm->GetId() < (int)attributes.multiprocessorCount){
-            DataPath * d = new DataPath(this, sm, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
-            string* mig_uuid = new string(uuid);
-            d->attrib.insert({"mig_uuid",(void*)mig_uuid});
+            DataPath * d = upsert(sm);
+            d->attrib.Set<string>("mig_uuid", uuid);
         }
     }
 
@@ -142,8 +142,8 @@ int Chip::GetMIGNumSMs(string uuid)
     } 
     else
     {
-        for(DataPath* dp: dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+        for(DataPath* dp: GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING)){
+            if(*(string*)dp->attrib["mig_uuid"] == uuid){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == SYS_SAGE_COMPONENT_SUBDIVISION && ((Subdivision*)target)->GetSubdivisionType() == SYS_SAGE_SUBDIVISION_TYPE_GPU_SM ){
                     num_sm++;
@@ -177,8 +177,8 @@ int Chip::GetMIGNumCores(string uuid)
     }
     else
     {
-        for(DataPath* dp: dp_outgoing){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+        for(DataPath* dp: GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING)){
+            if(*(string*)dp->attrib["mig_uuid"] == uuid){
                 Component* target = dp->GetTarget();
                 if(target->GetComponentType() == SYS_SAGE_COMPONENT_SUBDIVISION && ((Subdivision*)target)->GetSubdivisionType() == SYS_SAGE_SUBDIVISION_TYPE_GPU_SM ){
                     sms.push_back((Subdivision*)target);
@@ -209,8 +209,8 @@ long long Memory::GetMIGSize(string uuid)
         return size;
     } 
 
-    for(DataPath* dp: dp_incoming){
-        if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+    for(DataPath* dp: GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_INCOMING)){
+        if(*(string*)dp->attrib["mig_uuid"] == uuid){
             if (dp->attrib.count("mig_size")){
                 long long r = *(long long*)dp->attrib["mig_size"];
                 return r;
@@ -236,8 +236,8 @@ long long Cache::GetMIGSize(string uuid)
     }
 
     if(GetCacheLevel() == 2){
-        for(DataPath* dp: dp_incoming){
-            if(dp->GetDpType() == SYS_SAGE_DATAPATH_TYPE_MIG && *(string*)dp->attrib["mig_uuid"] == uuid){
+        for(DataPath* dp: GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_INCOMING)){
+            if(*(string*)dp->attrib["mig_uuid"] == uuid){
                 if (dp->attrib.count("mig_size")){
                     long long r = *(long long*)dp->attrib["mig_size"];
                     return r;
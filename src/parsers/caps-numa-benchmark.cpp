@@ -1,13 +1,16 @@
 
 #include "caps-numa-benchmark.hpp"
+#include "DataPathBatch.hpp"
+#include "DataPathHistory.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <chrono>
 
 using namespace std;
 
-int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim)
+int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim, size_t historySize)
 {
     CSVReader reader(benchmarkPath, delim);
     vector<vector<string> > benchmarkData;
@@ -47,8 +50,16 @@ int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, strin
         return 1;
     }
 
+    ArenaScope arenaScope(rootComponent->FindArena());
+    //two lookups per row -- use a (temporary) subcomponent index instead of a DFS each time
+    bool tmpIndex = !rootComponent->HasSubcomponentIndex();
+    if(tmpIndex)
+        rootComponent->EnableSubcomponentIndex();
     //cout << "caps-numa-benchmark parser: num entries: " << benchmarkData.size()-1 << endl;
-    //parse each line as one DataPath, skip header
+    //parse each line as one DataPath, skip header; the DataPaths are created at once at the end
+    DataPathBatch batch;
+    batch.Reserve(benchmarkData.size() - 1);
+    double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
     for(unsigned int i=1; i<benchmarkData.size(); i++)
     {
         int src_cpu_id, src_numa_id, target_numa_id;
@@ -70,10 +81,20 @@ int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, strin
             bw = stoul(benchmarkData[i][bw_idx]);
             ldlat = stoul(benchmarkData[i][ldlat_idx]);
 
-            new DataPath(src, target, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, (double)bw, (double)ldlat);
+            if(historySize > 0)
+            {
+                //the upsert sets the new values directly; the history only records the sample
+                DataPath* dp = UpsertDataPath(src, target, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, (double)bw, (double)ldlat);
+                dp->EnableHistory(historySize)->Add(timestamp, (double)bw, (double)ldlat);
+            }
+            else
+                batch.Add(src, target, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, (double)bw, (double)ldlat);
 
         }
     }
+    batch.Commit();
+    if(tmpIndex)
+        rootComponent->DisableSubcomponentIndex();
     return 0;
 }
 
@@ -4,7 +4,15 @@
 #include "Topology.hpp"
 #include "DataPath.hpp"
 
-int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim = ";");
+/**
+Parses the output of caps-numa-benchmark and creates a SYS_SAGE_DATAPATH_TYPE_DATATRANSFER DataPath from each measured CPU (or NUMA node) to each target NUMA node.
+@param rootComponent - subtree containing the measured components
+@param benchmarkPath - path to the output (csv) of the benchmark
+@param delim - delimiter of the csv
+@param historySize - if 0, new DataPaths are created for each measurement. Otherwise, the DataPaths of a previous run are updated instead (see UpsertDataPath()) and each measurement is added to their history (see DataPath::AddSample()), which keeps the last historySize measurements; the timestamp is the time of parsing in seconds since the epoch.
+@return 0 on success; 1 if the file could not be parsed
+*/
+int parseCapsNumaBenchmark(Component* rootComponent, string benchmarkPath, string delim = ";", size_t historySize = 0);
 
 class CSVReader
 {
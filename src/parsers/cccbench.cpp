@@ -9,6 +9,8 @@
 //#include <bits/stdc++.h>
 #include <sstream>
 #include "cccbench.hpp"
+#include "DataPathBatch.hpp"
+#include "DataPathMatrix.hpp"
 
 using namespace std;
 
@@ -84,12 +86,45 @@ CccbenchParser::CccbenchParser(const char *csv_path)
     }
 }
 
-void CccbenchParser::applyDataPaths(Component *root)
+void CccbenchParser::applyDataPaths(Component *root, bool asMatrix)
 {
     auto corev = new vector<Component *>();
     root->FindAllSubcomponentsByType(corev, SYS_SAGE_COMPONENT_CORE);
     //auto corev = root->GetAllChildrenByType(SYS_SAGE_COMPONENT_CORE);
+    if(asMatrix)
+    {
+        //dense storage instead of N*(N-1) DataPath objects
+        DataPathMatrix* m = new DataPathMatrix(root, *corev, SYS_SAGE_DATAPATH_TYPE_C2C);
+        int latency_min = m->AddMetric("latency_min");
+        int latency_max = m->AddMetric("latency_max");
+        for(size_t x = 0; x < corev->size(); x++)
+        {
+            for(size_t y = 0; y < corev->size(); y++)
+            {
+                auto xci = (*corev)[x]->GetId();
+                auto yci = (*corev)[y]->GetId();
+                if(xci == yci)
+                    continue;
+                auto& xtoylatv = (*this->c2cDatapoints)[xci][yci];
+                auto sum = accumulate(xtoylatv.begin(), xtoylatv.end(), 0.0);
+                float mean = sum / xtoylatv.size();
+                m->Set(x, y, 0, mean);
+                m->SetMetric(latency_min, x, y, *min_element(xtoylatv.begin(), xtoylatv.end()));
+                m->SetMetric(latency_max, x, y, *max_element(xtoylatv.begin(), xtoylatv.end()));
+            }
+        }
+        delete corev;
+        return;
+    }
+
+    AttributeKey latency_key("latency"), latency_min_key("latency_min"), latency_max_key("latency_max");
 
+    //all N*(N-1) data paths are created at once
+    DataPathBatch batch;
+    batch.Reserve(corev->size() * corev->size());
+    vector<float>* latency_max = batch.AddAttributeColumn<float>(latency_max_key);
+    vector<float>* latency_min = batch.AddAttributeColumn<float>(latency_min_key);
+    vector<float>* latency = batch.AddAttributeColumn<float>(latency_key);
     for(auto xcore : *corev)
     {
         for(auto ycore : *corev)
@@ -102,23 +137,25 @@ void CccbenchParser::applyDataPaths(Component *root)
             }
             auto xtoylatv = (*this->c2cDatapoints)[xci][yci];
             auto sum = accumulate(xtoylatv.begin(), xtoylatv.end(), 0.0);
-            auto mean = new float(sum / xtoylatv.size());
-            auto max = new float(*max_element(xtoylatv.begin(), xtoylatv.end()));
-            auto min = new float(*min_element(xtoylatv.begin(), xtoylatv.end()));
-            auto dtp = new DataPath(xcore, ycore, SYS_SAGE_DATAPATH_ORIENTED,
-                                   SYS_SAGE_DATAPATH_TYPE_C2C, 0, *mean);
-            dtp->attrib.insert(std::pair<string, void *>("latency_max", (void *)max));
-            dtp->attrib.insert(std::pair<string, void *>("latency_min", (void *)min));
-            dtp->attrib.insert(std::pair<string, void *>("latency", (void *)mean));
+            float mean = sum / xtoylatv.size();
+            float max = *max_element(xtoylatv.begin(), xtoylatv.end());
+            float min = *min_element(xtoylatv.begin(), xtoylatv.end());
+            batch.Add(xcore, ycore, SYS_SAGE_DATAPATH_TYPE_C2C, 0, mean);
+            latency_max->push_back(max);
+            latency_min->push_back(min);
+            latency->push_back(mean);
         }
     }
+    batch.Commit();
+    delete corev;
 }
 
-int parseCccbenchOutput(Node* n, std::string cccPath)
+int parseCccbenchOutput(Node* n, std::string cccPath, bool asMatrix)
 {
+    ArenaScope arenaScope(n->FindArena());
     const char *cstr_path = cccPath.c_str();
     auto cccparser = new CccbenchParser(cstr_path);
-    cccparser->applyDataPaths(n);
+    cccparser->applyDataPaths(n, asMatrix);
     delete cccparser;
     return 0;
 }
@@ -5,7 +5,11 @@
 #include "Topology.hpp"
 #include "DataPath.hpp"
 
-int parseCccbenchOutput(Node* , std::string );
+/**
+Parses the output of cccbench (core-to-core latencies) and adds it to the cores of the Node as DataPaths of type SYS_SAGE_DATAPATH_TYPE_C2C (latency = mean latency, attributes "latency", "latency_min" and "latency_max").
+@param asMatrix - if true, the N*(N-1) DataPaths are not created as DataPath objects, but stored in one DataPathMatrix attached to the Node (latency = mean latency, additional metrics "latency_min" and "latency_max")
+*/
+int parseCccbenchOutput(Node* , std::string , bool asMatrix = false);
 
 template <typename T>class Vec2DArray
 {
@@ -14,6 +18,7 @@ template <typename T>class Vec2DArray
     unsigned int size, xdim, ydim;
 public:
     Vec2DArray(unsigned xdim, unsigned ydim);
+    ~Vec2DArray(){delete [] array;}
     std::vector<T> *operator [](unsigned int xindex);
 };
 
@@ -40,11 +45,11 @@ class CccbenchParser{
     Vec2DArray<float> *c2cDatapoints;
     CccbenchParser():c2cDatapoints((Vec2DArray<float> *)0){}
 public:
-    virtual ~CccbenchParser(){if(this->c2cDatapoints) {delete [] c2cDatapoints;}}
+    virtual ~CccbenchParser(){if(this->c2cDatapoints) {delete c2cDatapoints;}}
     unsigned int xtoi(unsigned int _x){return _x - this->firstCore;}
     unsigned int ytoi(unsigned int _y){return _y - this->firstCore;}
     CccbenchParser(const char *csv_path);
-    void applyDataPaths(Component *root);
+    void applyDataPaths(Component *root, bool asMatrix = false);
 };
 
 #endif
@@ -16,6 +16,7 @@ int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string del
         std::cerr << "parseGpuTopo: parent is null" << std::endl;
         return 1;
     }
+    ArenaScope arenaScope(parent->FindArena());
     Chip * gpu = new Chip(parent, gpuId, "GPU", SYS_SAGE_CHIP_TYPE_GPU);
 
     return parseGpuTopo(gpu, dataSourcePath, delim);
@@ -23,6 +24,7 @@ int parseGpuTopo(Component* parent, string dataSourcePath, int gpuId, string del
 
 int parseGpuTopo(Chip* gpu, string dataSourcePath, string delim)
 {
+    ArenaScope arenaScope(gpu->FindArena());
     GpuTopo gpuT(gpu, dataSourcePath, delim);
     int ret = gpuT.ParseBenchmarkData();
     return ret;
@@ -228,8 +230,7 @@ int GpuTopo::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            string * val = new string(data[i+1]);
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set<string>(data[i], data[i+1]);
             i++;
         }
         else if(data[i]== "Number_of_streaming_multiprocessors" ||
@@ -240,19 +241,24 @@ int GpuTopo::parseCOMPUTE_RESOURCE_INFORMATION()
                 cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 1 additional value." << endl;
                 return 1;
             }
-            int * val = new int(std::stoi(data[i+1]));
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set<int>(data[i], std::stoi(data[i+1]));
 
             i++;
         }
     }
 
-    for(int i = 0; i < (*(int*)root->attrib["Number_of_streaming_multiprocessors"]); i++)
+    int* num_sm = root->attrib.Get<int>("Number_of_streaming_multiprocessors");
+    int* num_cores_per_sm = root->attrib.Get<int>("Number_of_cores_per_SM");
+    if(num_sm == NULL || num_cores_per_sm == NULL){
+        cerr << "parseCOMPUTE_RESOURCE_INFORMATION: \"Number_of_streaming_multiprocessors\" or \"Number_of_cores_per_SM\" missing." << endl;
+        return 1;
+    }
+    for(int i = 0; i < *num_sm; i++)
     {
         //cout << "adding SM " << i << std::endl;
         Subdivision * sm = new Subdivision(root, i, "SM (Streaming Multiprocessor)");
         sm->SetSubdivisionType(SYS_SAGE_SUBDIVISION_TYPE_GPU_SM);
-        for(int j = 0; j<(*(int*)root->attrib["Number_of_cores_per_SM"]); j++)
+        for(int j = 0; j < *num_cores_per_sm; j++)
         {
             new Thread(sm, j, "GPU Core");
         }
@@ -310,8 +316,7 @@ int GpuTopo::parseADDITIONAL_INFORMATION()
                 cerr << "parseREGISTER_INFORMATION: \"" << data[i] << "\" is supposed to be followed by 2 additional values." << endl;
                 return 1;
             }
-            std::tuple<double, std::string>* val = new std::tuple<double, std::string>(stod(data[i+1]), data[i+2]);
-            root->attrib.insert({data[i], (void*)val});
+            root->attrib.Set<std::tuple<double, std::string>>(data[i], {stod(data[i+1]), data[i+2]});
             i+=2;
         }
     }
@@ -381,12 +386,10 @@ int GpuTopo::parseMAIN_MEMORY()
             mem->SetSize((long long)size);
 
         if(Memory_Clock_Frequency > -1){
-            double * mfreq = new double(Memory_Clock_Frequency);
-            mem->attrib.insert({"Clock_Frequency", (void*)mfreq});
+            mem->attrib.Set<double>("Clock_Frequency", Memory_Clock_Frequency);
         }
         if(Memory_Bus_Width > -1){
-            int * busW = new int(Memory_Bus_Width);
-            mem->attrib.insert({"Bus_Width_bit", (void*)busW});
+            mem->attrib.Set<int>("Bus_Width_bit", Memory_Bus_Width);
         }
 
         //make SMs as memory's children and inserd DP with latency
@@ -651,7 +654,7 @@ int GpuTopo::parseCaches(string header_name, string cache_type)
                 if(cache_line_size != -1)
                     cache->SetCacheLineSize(cache_line_size);
 
-                int cores_per_cache = (*(int*)root->attrib["Number_of_cores_per_SM"])/caches_per_sm;
+                int cores_per_cache = (*root->attrib.Get<int>("Number_of_cores_per_SM"))/caches_per_sm;
 
                 //insert DP with latency
                 vector<Component*> children_copy;
@@ -163,8 +163,7 @@ int xmlProcessChildren(Component* c, xmlNode* parent, int level)
                                     if(sibling->GetComponentType() == SYS_SAGE_COMPONENT_CACHE) {
                                         c->RemoveChild(sibling);
                                         c->InsertChild(childC);
-                                        childC->InsertChild(childC);
-                                        sibling->InsertChild(sibling);
+                                        childC->InsertChild(sibling);
                                         inserted_as_sibling = true;
                                         break;
                                     }
@@ -232,6 +231,7 @@ int parseHwlocOutput(Node* n, string topoPath)
         return 1;
     }
 
+    ArenaScope arenaScope(n->FindArena());
     xmlNode *root= xmlDocGetRootElement(document);
     int err = xmlProcessChildren(n, root, 0);
     if(err != 0){
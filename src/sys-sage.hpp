@@ -4,7 +4,20 @@
 //includes all other headers
 #include "Topology.hpp"
 #include "DataPath.hpp"
+#include "DataPathGraph.hpp"
+#include "DataPathRollup.hpp"
+#include "DataPathBatch.hpp"
+#include "DataPathMatrix.hpp"
+#include "DataPathHistory.hpp"
+#include "MetricMatrix.hpp"
+#include "Arena.hpp"
+#include "AttributeStore.hpp"
+#include "AttributeCodec.hpp"
+#include "TopologyView.hpp"
+#include "BinarySnapshot.hpp"
+#include "Traversal.hpp"
 #include "xml_dump.hpp"
+#include "xml_load.hpp"
 #include "parsers/hwloc.hpp"
 #include "parsers/caps-numa-benchmark.hpp"
 #include "parsers/gpu-topo.hpp"
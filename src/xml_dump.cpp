@@ -1,286 +1,508 @@
-#include <sstream>
 #include <cstdint>
+#include <cmath>
+#include <charconv>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 
 #include "xml_dump.hpp"
+#include "DataPathMatrix.hpp"
+#include "Traversal.hpp"
 #include <libxml/parser.h>
+#include <libxml/xmlwriter.h>
 
-std::function<int(string,void*,string*)> search_custom_attrib_key_fcn = NULL;
-std::function<int(string,void*,xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL;
-
-//methods for printing out default attributes, i.e. those 
+//the attributes used by sys-sage, i.e. the codecs of AttributeCodecRegistry::GetDefault()
 //for a specific key, return the value as a string to be printed in the xml
 int search_default_attrib_key(string key, void* value, string* ret_value_str)
 {
-    //value: uint64_t 
-    if(!key.compare("CATcos") || 
-    !key.compare("CATL3mask") )
-    {
-        *ret_value_str=std::to_string(*(uint64_t*)value);
-        return 1;
-    }
-    //value: long long
-    else if(!key.compare("mig_size") )
-    {
-        *ret_value_str=std::to_string(*(long long*)value);
-        return 1;
-    }
-    //value: int
-    else if(!key.compare("Number_of_streaming_multiprocessors") || 
-    !key.compare("Number_of_cores_in_GPU") || 
-    !key.compare("Number_of_cores_per_SM")  || 
-    !key.compare("Bus_Width_bit") )
-    {
-        *ret_value_str=std::to_string(*(int*)value);
-        return 1;
-    }
-    //value: double
-    else if(!key.compare("Clock_Frequency") )
-    {
-        *ret_value_str=std::to_string(*(double*)value);
-        return 1;
-    }
-    //value: float
-    else if(!key.compare("latency") ||
-    !key.compare("latency_min") ||
-    !key.compare("latency_max") )
-    {
-        *ret_value_str=std::to_string(*(float*)value);
-        return 1;
-    }   
-    //value: string
-    else if(!key.compare("CUDA_compute_capability") || 
-    !key.compare("mig_uuid") )
-    {
-        *ret_value_str=*(string*)value;
-        return 1;
-    }
-
-    return 0;
+    AttributeStore::Entry entry { &AttributeKey(key).GetName(), value, NULL, NULL };
+    return AttributeCodecRegistry::GetDefault()->Encode(entry, ret_value_str) ? 1 : 0;
 }
 
 int search_default_complex_attrib_key(string key, void* value, xmlNodePtr n)
 {
-    //value: std::vector<std::tuple<long long,double>>*
-    if(!key.compare("freq_history"))
-    {
-        std::vector<std::tuple<long long,double>>* val = (std::vector<std::tuple<long long,double>>*)value;
+    AttributeStore::Entry entry { &AttributeKey(key).GetName(), value, NULL, NULL };
+    return AttributeCodecRegistry::GetDefault()->EncodeXml(entry, n) ? 1 : 0;
+}
 
-        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-        xmlAddChild(n, attrib_node);
-        for(auto [ ts,freq ] : *val)
-        {
-            xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-            xmlNewProp(attrib, (const unsigned char *)"timestamp", (const unsigned char *)std::to_string(ts).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-            xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)"MHz");
-            xmlAddChild(attrib_node, attrib);
-        }
-        return 1;
-    }
-    //value: std::tuple<double, std::string>
-    else if(!key.compare("GPU_Clock_Rate"))
+//buffer for a number formatted by FormatXmlNumber() or FormatXmlAddr(); large enough for any double in fixed notation
+struct XmlNumberBuffer {
+    char str[352];
+};
+
+//formats a number with std::to_chars in the same way as std::to_string (i.e. floating point numbers with 6 decimal places)
+template <typename T> static const xmlChar* FormatXmlNumber(XmlNumberBuffer& buf, T value)
+{
+    std::to_chars_result res;
+    if constexpr (std::is_floating_point_v<T>)
+        res = std::to_chars(buf.str, buf.str + sizeof(buf.str) - 1, value, std::chars_format::fixed, 6);
+    else
+        res = std::to_chars(buf.str, buf.str + sizeof(buf.str) - 1, value);
+    *res.ptr = '\0';
+    return BAD_CAST buf.str;
+}
+
+//formats an address as an ostream does ("0x" followed by hex digits; "0" for NULL)
+static const xmlChar* FormatXmlAddr(XmlNumberBuffer& buf, const void* addr)
+{
+    if(addr == NULL)
+        return FormatXmlNumber(buf, 0);
+    buf.str[0] = '0';
+    buf.str[1] = 'x';
+    std::to_chars_result res = std::to_chars(buf.str + 2, buf.str + sizeof(buf.str) - 1, (uintptr_t)addr, 16);
+    *res.ptr = '\0';
+    return BAD_CAST buf.str;
+}
+
+template <typename T> static void WriteXmlNumberProp(xmlTextWriterPtr writer, const char* name, T value)
+{
+    XmlNumberBuffer buf;
+    xmlTextWriterWriteAttribute(writer, BAD_CAST name, FormatXmlNumber(buf, value));
+}
+
+static void WriteXmlAddrProp(xmlTextWriterPtr writer, const char* name, const void* addr)
+{
+    XmlNumberBuffer buf;
+    xmlTextWriterWriteAttribute(writer, BAD_CAST name, FormatXmlAddr(buf, addr));
+}
+
+//writes a DOM subtree (as created by the complex attribute search functions) to the writer
+static void WriteXmlNode(xmlTextWriterPtr writer, xmlNodePtr n)
+{
+    if(n->type == XML_TEXT_NODE)
     {
-        xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-        xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-        xmlAddChild(n, attrib_node);
-
-        auto [ freq, unit ] = *(std::tuple<double, std::string>*)value;
-        xmlNodePtr attrib = xmlNewNode(NULL, (const unsigned char *)key.c_str());
-        xmlNewProp(attrib, (const unsigned char *)"frequency", (const unsigned char *)std::to_string(freq).c_str());
-        xmlNewProp(attrib, (const unsigned char *)"unit", (const unsigned char *)unit.c_str());
-        xmlAddChild(attrib_node, attrib);
-        return 1;
+        xmlTextWriterWriteString(writer, n->content);
+        return;
     }
+    if(n->type != XML_ELEMENT_NODE)
+        return;
 
-    return 0;
+    xmlTextWriterStartElement(writer, n->name);
+    for(xmlAttrPtr a = n->properties; a != NULL; a = a->next)
+    {
+        xmlChar* value = xmlNodeListGetString(n->doc, a->children, 1);
+        xmlTextWriterWriteAttribute(writer, a->name, value != NULL ? value : BAD_CAST "");
+        xmlFree(value);
+    }
+    for(xmlNodePtr child = n->children; child != NULL; child = child->next)
+        WriteXmlNode(writer, child);
+    xmlTextWriterEndElement(writer);
 }
 
-int print_attrib(map<string,void*> attrib, xmlNodePtr n)
+int print_attrib(AttributeStore& attrib, xmlTextWriterPtr writer, AttributeCodecRegistry* codecs)
 {
+    if(codecs == NULL)
+        codecs = AttributeCodecRegistry::GetDefault();
     string attrib_value;
-    for (auto const& [key, val] : attrib){
-        int ret = 0;
-        if(search_custom_attrib_key_fcn != NULL)
-            ret=search_custom_attrib_key_fcn(key,val,&attrib_value);
-        if(ret==0)
-            ret = search_default_attrib_key(key,val,&attrib_value);
-
-        if(ret==1)//attrib found
+    for(auto it = attrib.begin(); it != attrib.end(); ++it)
+    {
+        AttributeStore::Entry& e = it.GetEntry();
+        if(codecs->Encode(e, &attrib_value))
         {
-            xmlNodePtr attrib_node = xmlNewNode(NULL, (const unsigned char *)"Attribute");
-            xmlNewProp(attrib_node, (const unsigned char *)"name", (const unsigned char *)key.c_str());
-            xmlNewProp(attrib_node, (const unsigned char *)"value", (const unsigned char *)attrib_value.c_str());
-            xmlAddChild(n, attrib_node);
+            xmlTextWriterStartElement(writer, BAD_CAST "Attribute");
+            xmlTextWriterWriteAttribute(writer, BAD_CAST "name", BAD_CAST e.key->c_str());
+            xmlTextWriterWriteAttribute(writer, BAD_CAST "value", BAD_CAST attrib_value.c_str());
+            xmlTextWriterEndElement(writer);
             continue;
         }
 
-        if(ret == 0 && search_custom_complex_attrib_key_fcn != NULL) //try looking in search_custom_complex_attrib_key
-            ret=search_custom_complex_attrib_key_fcn(key,val,n);
-        if(ret==0)
-            ret = search_default_complex_attrib_key(key,val,n);
+        //the XML encoders build a DOM subtree, which is written and freed right away
+        xmlNodePtr n = xmlNewNode(NULL, BAD_CAST "attributes");
+        if(codecs->EncodeXml(e, n))
+        {
+            for(xmlNodePtr child = n->children; child != NULL; child = child->next)
+                WriteXmlNode(writer, child);
+        }
+        xmlFreeNode(n);
     }
 
     return 1;
 }
 
-xmlNodePtr Memory::CreateXmlSubtree()
+void Memory::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
+    Component::WriteXmlProperties(writer);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    xmlNewProp(n, (const unsigned char *)"is_volatile", (const unsigned char *)(std::to_string(is_volatile?1:0)).c_str());
-    return n;
+        WriteXmlNumberProp(writer, "size", size);
+    WriteXmlNumberProp(writer, "is_volatile", is_volatile?1:0);
 }
-xmlNodePtr Storage::CreateXmlSubtree()
+void Storage::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
+    Component::WriteXmlProperties(writer);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    return n;
+        WriteXmlNumberProp(writer, "size", size);
 }
-xmlNodePtr Chip::CreateXmlSubtree()
+void Chip::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
+    Component::WriteXmlProperties(writer);
     if(!vendor.empty())
-        xmlNewProp(n, (const unsigned char *)"vendor", (const unsigned char *)(vendor.c_str()));
+        xmlTextWriterWriteAttribute(writer, BAD_CAST "vendor", BAD_CAST vendor.c_str());
     if(!model.empty())
-        xmlNewProp(n, (const unsigned char *)"model", (const unsigned char *)(model.c_str()));
-    return n;
+        xmlTextWriterWriteAttribute(writer, BAD_CAST "model", BAD_CAST model.c_str());
 }
-xmlNodePtr Cache::CreateXmlSubtree()
+void Cache::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"cache_level", (const unsigned char *)cache_type.c_str());
+    Component::WriteXmlProperties(writer);
+    xmlTextWriterWriteAttribute(writer, BAD_CAST "cache_level", BAD_CAST cache_type.c_str());
     if(cache_size >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_size", (const unsigned char *)(std::to_string(cache_size)).c_str());
+        WriteXmlNumberProp(writer, "cache_size", cache_size);
     if(cache_associativity_ways >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_associativity_ways", (const unsigned char *)(std::to_string(cache_associativity_ways)).c_str());
+        WriteXmlNumberProp(writer, "cache_associativity_ways", cache_associativity_ways);
     if(cache_line_size >= 0)
-        xmlNewProp(n, (const unsigned char *)"cache_line_size", (const unsigned char *)(std::to_string(cache_line_size)).c_str());
-    return n;
+        WriteXmlNumberProp(writer, "cache_line_size", cache_line_size);
 }
-xmlNodePtr Subdivision::CreateXmlSubtree()
+void Subdivision::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
-    xmlNewProp(n, (const unsigned char *)"subdivision_type", (const unsigned char *)(std::to_string(type)).c_str());
-    return n;
+    Component::WriteXmlProperties(writer);
+    WriteXmlNumberProp(writer, "subdivision_type", type);
 }
-xmlNodePtr Numa::CreateXmlSubtree()
+void Numa::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = Component::CreateXmlSubtree();
+    Component::WriteXmlProperties(writer);
     if(size > 0)
-        xmlNewProp(n, (const unsigned char *)"size", (const unsigned char *)(std::to_string(size)).c_str());
-    return n;
+        WriteXmlNumberProp(writer, "size", size);
 }
-xmlNodePtr Component::CreateXmlSubtree()
+void Component::WriteXmlProperties(xmlTextWriterPtr writer)
 {
-    xmlNodePtr n = xmlNewNode(NULL, (const unsigned char *)GetComponentTypeStr().c_str());
-    xmlNewProp(n, (const unsigned char *)"id", (const unsigned char *)(std::to_string(id)).c_str());
-    xmlNewProp(n, (const unsigned char *)"name", (const unsigned char *)name.c_str());
+    WriteXmlNumberProp(writer, "id", id);
+    xmlTextWriterWriteAttribute(writer, BAD_CAST "name", BAD_CAST name.c_str());
     if(count > 0)
-        xmlNewProp(n, (const unsigned char *)"count", (const unsigned char *)(std::to_string(count)).c_str());
-    std::ostringstream addr;
-    addr << this;
-    xmlNewProp(n, (const unsigned char *)"addr", (const unsigned char *)(addr.str().c_str()));
+        WriteXmlNumberProp(writer, "count", count);
+    WriteXmlAddrProp(writer, "addr", this);
+}
+//starts the element of a component and writes its properties
+static void WriteXmlComponentStart(xmlTextWriterPtr writer, Component* c)
+{
+    xmlTextWriterStartElement(writer, BAD_CAST c->GetComponentTypeStr().c_str());
+    switch (c->GetComponentType()) {
+        case SYS_SAGE_COMPONENT_CACHE:
+            ((Cache*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_SUBDIVISION:
+            ((Subdivision*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_NUMA:
+            ((Numa*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_CHIP:
+            ((Chip*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_MEMORY:
+            ((Memory*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_STORAGE:
+            ((Storage*)c)->WriteXmlProperties(writer);
+            break;
+        case SYS_SAGE_COMPONENT_NONE:
+        case SYS_SAGE_COMPONENT_THREAD:
+        case SYS_SAGE_COMPONENT_CORE:
+        case SYS_SAGE_COMPONENT_NODE:
+        case SYS_SAGE_COMPONENT_TOPOLOGY:
+        default:
+            c->WriteXmlProperties(writer);
+            break;
+    };
+}
+
+void Component::WriteXmlSubtree(xmlTextWriterPtr writer, AttributeCodecRegistry* codecs)
+{
+    WriteXmlComponentStart(writer, this);
 
-    print_attrib(attrib, n);
+    print_attrib(attrib, writer, codecs);
 
     for(Component * c : children)
+        c->WriteXmlSubtree(writer, codecs);
+
+    xmlTextWriterEndElement(writer);
+}
+
+//writes a list of doubles as an xs:list attribute; missing entries are NaN
+template <typename T> static void WriteMatrixValues(xmlTextWriterPtr writer, const char* name, vector<T>& values, vector<uint8_t>& exists)
+{
+    XmlNumberBuffer buf;
+    xmlTextWriterStartAttribute(writer, BAD_CAST name);
+    for(size_t i = 0; i < values.size(); i++)
     {
-        xmlNodePtr child;
-        switch (c->GetComponentType()) {
-            case SYS_SAGE_COMPONENT_CACHE:
-                child = ((Cache*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_SUBDIVISION:
-                child = ((Subdivision*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_NUMA:
-                child = ((Numa*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_CHIP:
-                child = ((Chip*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_MEMORY:
-                child = ((Memory*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_STORAGE:
-                child = ((Storage*)c)->CreateXmlSubtree();
-                break;
-            case SYS_SAGE_COMPONENT_NONE:
-            case SYS_SAGE_COMPONENT_THREAD:
-            case SYS_SAGE_COMPONENT_CORE:
-            case SYS_SAGE_COMPONENT_NODE:
-            case SYS_SAGE_COMPONENT_TOPOLOGY:
-            default:
-                child = c->CreateXmlSubtree();
-                break;
-        };
-
-        xmlAddChild(n, child);
+        if(i > 0)
+            xmlTextWriterWriteString(writer, BAD_CAST " ");
+        xmlTextWriterWriteString(writer, (exists[i] && !std::isnan(values[i])) ? FormatXmlNumber(buf, values[i]) : BAD_CAST "NaN");
     }
+    xmlTextWriterEndAttribute(writer);
+}
+
+template <typename T> static void WriteMatrixMetric(xmlTextWriterPtr writer, const string& name, vector<T>& values, vector<uint8_t>& exists)
+{
+    xmlTextWriterStartElement(writer, BAD_CAST "metric");
+    xmlTextWriterWriteAttribute(writer, BAD_CAST "name", BAD_CAST name.c_str());
+    WriteMatrixValues(writer, "values", values, exists);
+    xmlTextWriterEndElement(writer);
+}
 
+void DataPathMatrix::WriteXml(xmlTextWriterPtr writer)
+{
+    XmlNumberBuffer buf;
+    xmlTextWriterStartElement(writer, BAD_CAST "datapath-matrix");
+    WriteXmlAddrProp(writer, "owner", owner);
+    WriteXmlNumberProp(writer, "dp_type", dp_type);
+    WriteXmlNumberProp(writer, "oriented", oriented);
+    WriteXmlNumberProp(writer, "size", components.size());
+    xmlTextWriterStartAttribute(writer, BAD_CAST "endpoints");
+    for(size_t i = 0; i < components.size(); i++)
+    {
+        if(i > 0)
+            xmlTextWriterWriteString(writer, BAD_CAST " ");
+        xmlTextWriterWriteString(writer, FormatXmlAddr(buf, components[i]));
+    }
+    xmlTextWriterEndAttribute(writer);
 
-    return n;
+    WriteMatrixMetric(writer, "bw", bw, exists);
+    WriteMatrixMetric(writer, "latency", latency, exists);
+    for(size_t m = 0; m < metrics.size(); m++)
+        WriteMatrixMetric(writer, metric_names[m], metrics[m], exists);
+    xmlTextWriterEndElement(writer);
 }
 
-int exportToXml(Component* root, string path, std::function<int(string,void*,string*)> _search_custom_attrib_key_fcn, std::function<int(string,void*,xmlNodePtr)> _search_custom_complex_attrib_key_fcn)
+static void WriteXmlDataPath(xmlTextWriterPtr writer, DataPath* dpPtr, AttributeCodecRegistry* codecs)
 {
-    search_custom_attrib_key_fcn=_search_custom_attrib_key_fcn;
-    search_custom_complex_attrib_key_fcn=_search_custom_complex_attrib_key_fcn;
+    xmlTextWriterStartElement(writer, BAD_CAST "datapath");
+    WriteXmlAddrProp(writer, "source", dpPtr->GetSource());
+    WriteXmlAddrProp(writer, "target", dpPtr->GetTarget());
+    WriteXmlNumberProp(writer, "oriented", dpPtr->GetOriented());
+    WriteXmlNumberProp(writer, "dp_type", dpPtr->GetDpType());
+    WriteXmlNumberProp(writer, "bw", dpPtr->GetBw());
+    WriteXmlNumberProp(writer, "latency", dpPtr->GetLatency());
+    print_attrib(dpPtr->attrib, writer, codecs);
+    xmlTextWriterEndElement(writer);
+}
 
-    xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
+static bool IsInSubtree(Component* c, Component* root)
+{
+    return c == root || c->IsDescendantOf(root);
+}
 
-    xmlNodePtr sys_sage_root = xmlNewNode(NULL, BAD_CAST "sys-sage");
-    xmlDocSetRootElement(doc, sys_sage_root);
-    xmlNodePtr components_root = xmlNewNode(NULL, BAD_CAST "components");
-    xmlAddChild(sys_sage_root, components_root);
-    xmlNodePtr data_paths_root = xmlNewNode(NULL, BAD_CAST "data-paths");
-    xmlAddChild(sys_sage_root, data_paths_root);
+//an oriented DataPath is listed at its target; a bidirectional one at its source, or at its target if the source is not exported
+static bool IsListedAt(DataPath* dpPtr, Component* c, Component* root)
+{
+    if(dpPtr->GetOriented() != SYS_SAGE_DATAPATH_BIDIRECTIONAL || c == dpPtr->GetSource())
+        return true;
+    return !IsInSubtree(dpPtr->GetSource(), root);
+}
 
-    //build a tree for Components
-    xmlNodePtr n = root->CreateXmlSubtree();
-    xmlAddChild(components_root, n);
+//true if all endpoints are in the subtree of shard (false if shard is NULL)
+static bool IsInShard(DataPath* dpPtr, Component* shard)
+{
+    return shard != NULL && IsInSubtree(dpPtr->GetSource(), shard) && IsInSubtree(dpPtr->GetTarget(), shard);
+}
+static bool IsInShard(DataPathMatrix* m, Component* shard)
+{
+    if(shard == NULL)
+        return false;
+    for(Component* c : *m->GetComponents())
+    {
+        if(!IsInSubtree(c, shard))
+            return false;
+    }
+    return true;
+}
 
-    //scan all Components for their DataPaths
-    vector<Component*> components;
-    root->GetSubtreeNodeList(&components);
-    std::cout << "Number of components to export: " << components.size() << std::endl;
-    for(Component* cPtr : components)
+static xmlTextWriterPtr OpenXmlWriter(string path, const char* caller)
+{
+    xmlTextWriterPtr writer = xmlNewTextWriterFilename(path=="" ? "-" : path.c_str(), 0);
+    if(writer == NULL)
     {
-        vector<DataPath*>* dpList = cPtr->GetDataPaths(SYS_SAGE_DATAPATH_INCOMING);
-        vector<DataPath*> printed_dp;
+        cerr << caller << ": could not open " << path << " for writing" << endl;
+        return NULL;
+    }
+    xmlTextWriterSetIndent(writer, 1);
+    xmlTextWriterSetIndentString(writer, BAD_CAST "  ");
+    xmlTextWriterStartDocument(writer, NULL, "UTF-8", NULL);
+    return writer;
+}
+
+static int CloseXmlWriter(xmlTextWriterPtr writer)
+{
+    int ret = xmlTextWriterEndDocument(writer) < 0 ? 1 : 0;
+    xmlFreeTextWriter(writer);
+    return ret;
+}
+
+//writes the sys-sage document of the subtree of root; shard: only DataPaths between components of the subtree are written
+static int WriteXmlDocument(Component* root, string path, bool shard, AttributeCodecRegistry* codecs, const char* caller)
+{
+    //the document is streamed to the file while walking the topology; no DOM is built
+    xmlTextWriterPtr writer = OpenXmlWriter(path, caller);
+    if(writer == NULL)
+        return 1;
+    xmlTextWriterStartElement(writer, BAD_CAST "sys-sage");
 
-        for(DataPath* dpPtr : *dpList)
+    //write the tree of Components
+    xmlTextWriterStartElement(writer, BAD_CAST "components");
+    root->WriteXmlSubtree(writer, codecs);
+    xmlTextWriterEndElement(writer);
+
+    //scan all Components for their DataPaths; each DataPath is listed once, in the DFS order of the components
+    xmlTextWriterStartElement(writer, BAD_CAST "data-paths");
+    xmlTextWriterWriteAttribute(writer, BAD_CAST "unique", BAD_CAST "1");
+    for(Component* cPtr : subtree(root))
+    {
+        for(DataPath* dpPtr : cPtr->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING))
+        {
+            if(IsListedAt(dpPtr, cPtr, root) && (!shard || IsInShard(dpPtr, root)))
+                WriteXmlDataPath(writer, dpPtr, codecs);
+        }
+        for(DataPathMatrix* m : cPtr->GetDataPathMatrices())
         {
-            //check if previously processed
-            if (std::find(printed_dp.begin(), printed_dp.end(), dpPtr) == printed_dp.end())
-            {
-                xmlNodePtr dp_n = xmlNewNode(NULL, BAD_CAST "datapath");
-                std::ostringstream src_addr;
-                src_addr << dpPtr->GetSource();
-                std::ostringstream target_addr;
-                target_addr << dpPtr->GetTarget();
-                xmlNewProp(dp_n, (const unsigned char *)"source", (const unsigned char *)(src_addr.str().c_str()));
-                xmlNewProp(dp_n, (const unsigned char *)"target", (const unsigned char *)(target_addr.str().c_str()));
-                xmlNewProp(dp_n, (const unsigned char *)"oriented", (const unsigned char *)(std::to_string(dpPtr->GetOriented())).c_str());
-                xmlNewProp(dp_n, (const unsigned char *)"dp_type", (const unsigned char *)(std::to_string(dpPtr->GetDpType())).c_str());
-                xmlNewProp(dp_n, (const unsigned char *)"bw", (const unsigned char *)(std::to_string(dpPtr->GetBw())).c_str());
-                xmlNewProp(dp_n, (const unsigned char *)"latency", (const unsigned char *)(std::to_string(dpPtr->GetLatency())).c_str());
-                xmlAddChild(data_paths_root, dp_n);
-
-                print_attrib(dpPtr->attrib, dp_n);
-
-                printed_dp.push_back(dpPtr);
-            }
+            if(!shard || IsInShard(m, root))
+                m->WriteXml(writer);
         }
     }
+    xmlTextWriterEndElement(writer);
+
+    xmlTextWriterEndElement(writer);
+    return CloseXmlWriter(writer);
+}
+
+int exportToXml(Component* root, string path, std::function<int(string,void*,string*)> search_custom_attrib_key_fcn, std::function<int(string,void*,xmlNodePtr)> search_custom_complex_attrib_key_fcn)
+{
+    AttributeCodecRegistry codecs;
+    codecs.SetFallbackEncoders(search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn);
+    return exportToXml(root, path, &codecs);
+}
+
+int exportToXml(Component* root, string path, AttributeCodecRegistry* codecs)
+{
+    if(codecs == NULL)
+        codecs = AttributeCodecRegistry::GetDefault();
+
+    std::cout << "Number of components to export: " << root->CountAllSubcomponents() + 1 << std::endl;
+    int ret = WriteXmlDocument(root, path, false, codecs, "exportToXml");
+    xmlCleanupParser();
+
+    return ret;
+}
+
+//finds the Nodes of the subtree which are not in the subtree of another Node
+static void FindShardNodes(Component* c, vector<Component*>* nodes)
+{
+    if(c->GetComponentType() == SYS_SAGE_COMPONENT_NODE)
+    {
+        nodes->push_back(c);
+        return;
+    }
+    for(Component* child : *c->GetChildren())
+        FindShardNodes(child, nodes);
+}
+
+//writes the components outside of the shards; a shard Node is written without its attributes and children, naming the file of its shard
+static void WriteXmlManifestComponents(xmlTextWriterPtr writer, Component* c, unordered_map<Component*, string>& shard_files, AttributeCodecRegistry* codecs)
+{
+    WriteXmlComponentStart(writer, c);
+    auto shard = shard_files.find(c);
+    if(shard != shard_files.end())
+        xmlTextWriterWriteAttribute(writer, BAD_CAST "shard", BAD_CAST shard->second.c_str());
+    else
+    {
+        print_attrib(c->attrib, writer, codecs);
+        for(Component* child : *c->GetChildren())
+            WriteXmlManifestComponents(writer, child, shard_files, codecs);
+    }
+    xmlTextWriterEndElement(writer);
+}
+
+//writes the DataPaths and DataPath matrices listed at the components of the subtree of c which are not written to a shard
+static void WriteXmlManifestDataPaths(xmlTextWriterPtr writer, Component* c, Component* root, Component* shard, unordered_map<Component*, string>& shard_files, AttributeCodecRegistry* codecs)
+{
+    if(shard == NULL && shard_files.count(c) > 0)
+        shard = c;
+    for(DataPath* dpPtr : c->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING))
+    {
+        if(IsListedAt(dpPtr, c, root) && !IsInShard(dpPtr, shard))
+            WriteXmlDataPath(writer, dpPtr, codecs);
+    }
+    for(DataPathMatrix* m : c->GetDataPathMatrices())
+    {
+        if(!IsInShard(m, shard))
+            m->WriteXml(writer);
+    }
+    for(Component* child : *c->GetChildren())
+        WriteXmlManifestDataPaths(writer, child, root, shard, shard_files, codecs);
+}
+
+int exportToXmlShards(Component* root, string path, int num_threads, std::function<int(string,void*,string*)> search_custom_attrib_key_fcn, std::function<int(string,void*,xmlNodePtr)> search_custom_complex_attrib_key_fcn)
+{
+    AttributeCodecRegistry codecs;
+    codecs.SetFallbackEncoders(search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn);
+    return exportToXmlShards(root, path, num_threads, &codecs);
+}
+
+int exportToXmlShards(Component* root, string path, int num_threads, AttributeCodecRegistry* codecs)
+{
+    if(codecs == NULL)
+        codecs = AttributeCodecRegistry::GetDefault();
+
+    vector<Component*> nodes;
+    FindShardNodes(root, &nodes);
+
+    //shard files are named after the manifest: dir/name.ext -> dir/name.shard<N>.ext
+    size_t name_begin = path.find_last_of('/') + 1; //0 if there is no directory
+    size_t ext_begin = path.find_last_of('.');
+    if(ext_begin == string::npos || ext_begin < name_begin)
+        ext_begin = path.size();
+    unordered_map<Component*, string> shard_files; //file names relative to the directory of the manifest
+    vector<string> shard_paths(nodes.size());
+    for(size_t k = 0; k < nodes.size(); k++)
+    {
+        string file = path.substr(name_begin, ext_begin - name_begin) + ".shard" + std::to_string(k) + path.substr(ext_begin);
+        shard_files[nodes[k]] = file;
+        shard_paths[k] = path.substr(0, name_begin) + file;
+    }
+
+    xmlInitParser();
+    //the DFS labels used by IsDescendantOf() are computed lazily; compute them here, so that the workers only read them
+    //(the manifest pass queries the endpoints of all DataPaths the workers query)
+    root->GetLowestCommonAncestor(root);
 
-    xmlSaveFormatFileEnc(path=="" ? "-" : path.c_str(), doc, "UTF-8", 1);
+    //manifest
+    xmlTextWriterPtr writer = OpenXmlWriter(path, "exportToXmlShards");
+    if(writer == NULL)
+        return 1;
+    xmlTextWriterStartElement(writer, BAD_CAST "sys-sage-manifest");
+    xmlTextWriterStartElement(writer, BAD_CAST "components");
+    WriteXmlManifestComponents(writer, root, shard_files, codecs);
+    xmlTextWriterEndElement(writer);
+    xmlTextWriterStartElement(writer, BAD_CAST "data-paths");
+    xmlTextWriterWriteAttribute(writer, BAD_CAST "unique", BAD_CAST "1");
+    WriteXmlManifestDataPaths(writer, root, root, NULL, shard_files, codecs);
+    xmlTextWriterEndElement(writer);
+    xmlTextWriterEndElement(writer);
+    int ret = CloseXmlWriter(writer);
 
-    xmlFreeDoc(doc);
+    //shards; each worker only reads the topology and writes its own files
+    std::atomic<size_t> next_shard { 0 };
+    std::atomic<int> failed { 0 };
+    auto write_shards = [&]()
+    {
+        for(size_t k = next_shard++; k < nodes.size(); k = next_shard++)
+        {
+            if(WriteXmlDocument(nodes[k], shard_paths[k], true, codecs, "exportToXmlShards") != 0)
+                failed = 1;
+        }
+    };
+    size_t workers_num = (num_threads > 0) ? num_threads : std::thread::hardware_concurrency();
+    workers_num = std::max<size_t>(1, std::min<size_t>(workers_num, nodes.size()));
+    if(workers_num == 1)
+        write_shards();
+    else
+    {
+        vector<std::thread> workers;
+        for(size_t t = 0; t < workers_num; t++)
+            workers.emplace_back(write_shards);
+        for(std::thread& w : workers)
+            w.join();
+    }
     xmlCleanupParser();
 
-    return 0;
+    return (ret != 0 || failed != 0) ? 1 : 0;
 }
@@ -7,7 +7,40 @@
 #include "DataPath.hpp"
 
 int exportToXml(Component *root, string path = "", std::function<int(string, void *, string *)> search_custom_attrib_key_fcn = NULL, std::function<int(string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL);
+/**
+Exports the subtree of root to XML, with the attributes encoded by the codecs of the given registry (see AttributeCodecRegistry). Attributes without a codec are not written.
+\n The search_custom_*_fcn variant of exportToXml() is equivalent to passing a registry with these functions as fallback encoders (see AttributeCodecRegistry::SetFallbackEncoders()).
+@param root - the root of the export
+@param path - path of the file to write; "" for stdout
+@param codecs - the registry; NULL for AttributeCodecRegistry::GetDefault()
+@return 0 on success; 1 if the file could not be written
+*/
+int exportToXml(Component *root, string path, AttributeCodecRegistry *codecs);
+/**
+Exports the subtree of root as shards, e.g. for cluster-scale topologies: each Node in the subtree (the topmost ones, if Nodes are nested) is written to its own file, in parallel worker threads, and a small manifest lists the shards and contains everything else.
+\n The shard of a Node is a regular sys-sage XML file of the Node subtree (see exportToXml()) with the DataPaths and DataPath matrices between its components; it can be read with importFromXml() or importXmlShard().
+\n The manifest has the root element "sys-sage-manifest" and the same structure: its components are those outside of the shards, where each shard Node is an element without children, whose "shard" attribute names the file of the shard (relative to the directory of the manifest); its data-paths are all other DataPaths, e.g. those between components of different Nodes.
+@param root - the root of the export
+@param path - path of the manifest; the shards are written next to it, numbered in DFS order: e.g. topo.xml -> topo.shard0.xml, topo.shard1.xml, ...
+@param num_threads - the number of worker threads; 0 (the default) for std::thread::hardware_concurrency()
+@param search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn - (optional) as for exportToXml(); called from the worker threads
+@return 0 on success; 1 if a file could not be written
+*/
+int exportToXmlShards(Component *root, string path, int num_threads = 0, std::function<int(string, void *, string *)> search_custom_attrib_key_fcn = NULL, std::function<int(string, void *, xmlNodePtr)> search_custom_complex_attrib_key_fcn = NULL);
+/**
+@see exportToXmlShards(); the attributes are encoded by the codecs of the given registry (NULL for AttributeCodecRegistry::GetDefault()), which is shared by the worker threads.
+*/
+int exportToXmlShards(Component *root, string path, int num_threads, AttributeCodecRegistry *codecs);
+/**
+Encodes an attribute used by sys-sage as a string (by the codecs of AttributeCodecRegistry::GetDefault()).
+@return 1 if the attribute was encoded, 0 otherwise
+*/
 int search_default_attrib_key(string key, void *value, string *ret_value_str);
+/**
+Encodes an attribute used by sys-sage as an <Attribute> element added to n (by the codecs of AttributeCodecRegistry::GetDefault()).
+@return 1 if the attribute was encoded, 0 otherwise
+*/
+int search_default_complex_attrib_key(string key, void *value, xmlNodePtr n);
 
-int print_attrib(map<string, void *> attrib, xmlNodePtr n);
+int print_attrib(AttributeStore& attrib, xmlTextWriterPtr writer, AttributeCodecRegistry* codecs = NULL);
 #endif
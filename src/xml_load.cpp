@@ -0,0 +1,504 @@
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <tuple>
+#include <unordered_map>
+
+#include "xml_load.hpp"
+#include "DataPathMatrix.hpp"
+#include <libxml/xmlreader.h>
+
+//value of an attribute of the current element of the reader; false if the element does not have it
+static bool GetXmlProp(xmlTextReaderPtr reader, const char* name, string* out)
+{
+    xmlChar* value = xmlTextReaderGetAttribute(reader, BAD_CAST name);
+    if(value == NULL)
+        return false;
+    *out = (const char*)value;
+    xmlFree(value);
+    return true;
+}
+static bool GetXmlProp(xmlNodePtr n, const char* name, string* out)
+{
+    xmlChar* value = xmlGetProp(n, BAD_CAST name);
+    if(value == NULL)
+        return false;
+    *out = (const char*)value;
+    xmlFree(value);
+    return true;
+}
+
+//the attributes used by sys-sage, i.e. the codecs of AttributeCodecRegistry::GetDefault()
+//for a specific key, parse the value from the string in the xml and store it in attrib
+int load_default_attrib_key(string key, string value, AttributeStore* attrib)
+{
+    return AttributeCodecRegistry::GetDefault()->Decode(AttributeKey(key), value, attrib) ? 1 : 0;
+}
+
+int load_default_complex_attrib_key(string key, xmlNodePtr n, AttributeStore* attrib)
+{
+    return AttributeCodecRegistry::GetDefault()->DecodeXml(AttributeKey(key), n, attrib) ? 1 : 0;
+}
+
+void Component::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    string value;
+    if(GetXmlProp(reader, "id", &value))
+        id = (int)strtol(value.c_str(), NULL, 10);
+    if(GetXmlProp(reader, "name", &value))
+        name = value;
+    if(GetXmlProp(reader, "count", &value))
+        count = (int)strtol(value.c_str(), NULL, 10);
+}
+void Memory::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    string value;
+    size = GetXmlProp(reader, "size", &value) ? strtoll(value.c_str(), NULL, 10) : -1;
+    is_volatile = GetXmlProp(reader, "is_volatile", &value) && value == "1";
+}
+void Storage::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    string value;
+    size = GetXmlProp(reader, "size", &value) ? strtoll(value.c_str(), NULL, 10) : -1;
+}
+void Chip::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    GetXmlProp(reader, "vendor", &vendor);
+    GetXmlProp(reader, "model", &model);
+}
+void Cache::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    string value;
+    GetXmlProp(reader, "cache_level", &cache_type);
+    if(GetXmlProp(reader, "cache_size", &value))
+        cache_size = strtoll(value.c_str(), NULL, 10);
+    if(GetXmlProp(reader, "cache_associativity_ways", &value))
+        cache_associativity_ways = (int)strtol(value.c_str(), NULL, 10);
+    if(GetXmlProp(reader, "cache_line_size", &value))
+        cache_line_size = (int)strtol(value.c_str(), NULL, 10);
+}
+void Subdivision::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    string value;
+    if(GetXmlProp(reader, "subdivision_type", &value))
+        type = (int)strtol(value.c_str(), NULL, 10);
+}
+void Numa::LoadXmlProperties(xmlTextReaderPtr reader)
+{
+    Component::LoadXmlProperties(reader);
+    string value;
+    if(GetXmlProp(reader, "size", &value))
+        size = strtoll(value.c_str(), NULL, 10);
+}
+
+//creates a component from its element (named by Component::GetComponentTypeStr()); NULL if the name is not a component type
+static Component* LoadComponent(const string& name, xmlTextReaderPtr reader)
+{
+    Component* c;
+    if(name == "HW_thread")
+        c = new Thread();
+    else if(name == "Core")
+        c = new Core();
+    else if(name == "Cache")
+        c = new Cache();
+    else if(name == "Subdivision")
+        c = new Subdivision();
+    else if(name == "NUMA")
+        c = new Numa();
+    else if(name == "Chip")
+        c = new Chip();
+    else if(name == "Memory")
+        c = new Memory();
+    else if(name == "Storage")
+        c = new Storage();
+    else if(name == "Node")
+        c = new Node();
+    else if(name == "Topology")
+        c = new Topology();
+    else if(name == "None")
+        c = new Component();
+    else
+        return NULL;
+
+    switch (c->GetComponentType()) {
+        case SYS_SAGE_COMPONENT_CACHE:
+            ((Cache*)c)->LoadXmlProperties(reader);
+            break;
+        case SYS_SAGE_COMPONENT_SUBDIVISION:
+            ((Subdivision*)c)->LoadXmlProperties(reader);
+            break;
+        case SYS_SAGE_COMPONENT_NUMA:
+            ((Numa*)c)->LoadXmlProperties(reader);
+            break;
+        case SYS_SAGE_COMPONENT_CHIP:
+            ((Chip*)c)->LoadXmlProperties(reader);
+            break;
+        case SYS_SAGE_COMPONENT_MEMORY:
+            ((Memory*)c)->LoadXmlProperties(reader);
+            break;
+        case SYS_SAGE_COMPONENT_STORAGE:
+            ((Storage*)c)->LoadXmlProperties(reader);
+            break;
+        default:
+            c->LoadXmlProperties(reader);
+            break;
+    };
+    return c;
+}
+
+static void LoadAttribute(xmlTextReaderPtr reader, AttributeStore* attrib, AttributeCodecRegistry* codecs)
+{
+    string name, value;
+    if(!GetXmlProp(reader, "name", &name))
+        return;
+    AttributeKey key(name);
+    if(GetXmlProp(reader, "value", &value))
+    {
+        if(!codecs->Decode(key, value, attrib))
+            attrib->Set<string>(key, value);
+        return;
+    }
+
+    xmlNodePtr n = xmlTextReaderExpand(reader);
+    if(n != NULL)
+        codecs->DecodeXml(key, n, attrib);
+}
+
+//creates the DataPath of a datapath element; NULL if it is not created
+static DataPath* LoadDataPath(xmlTextReaderPtr reader, unordered_map<string, Component*>& components, unordered_map<string, int>* bidirectional)
+{
+    string source, target, value;
+    GetXmlProp(reader, "source", &source);
+    GetXmlProp(reader, "target", &target);
+    auto src = components.find(source);
+    auto tgt = components.find(target);
+    if(src == components.end() || tgt == components.end())
+    {
+        cerr << "importFromXml: skipping DataPath with an unknown endpoint (" << source << " -> " << target << ")" << endl;
+        return NULL;
+    }
+    int oriented = GetXmlProp(reader, "oriented", &value) ? (int)strtol(value.c_str(), NULL, 10) : SYS_SAGE_DATAPATH_ORIENTED;
+    int dp_type = GetXmlProp(reader, "dp_type", &value) ? (int)strtol(value.c_str(), NULL, 10) : SYS_SAGE_DATAPATH_TYPE_NONE;
+    string bw = "-1", latency = "-1";
+    GetXmlProp(reader, "bw", &bw);
+    GetXmlProp(reader, "latency", &latency);
+
+    //in older exports (bidirectional != NULL), a bidirectional DataPath is listed at both of its endpoints; every second equal listing is not a new DataPath
+    if(bidirectional != NULL && oriented == SYS_SAGE_DATAPATH_BIDIRECTIONAL && src->second != tgt->second)
+    {
+        string key = source + ' ' + target + ' ' + std::to_string(dp_type) + ' ' + bw + ' ' + latency;
+        if((*bidirectional)[key]++ % 2 == 1)
+            return NULL;
+    }
+    return new DataPath(src->second, tgt->second, oriented, dp_type, strtod(bw.c_str(), NULL), strtod(latency.c_str(), NULL));
+}
+
+//parses an xs:list of doubles (NaN for missing entries)
+static vector<double> ParseMatrixValues(const string& values)
+{
+    vector<double> ret;
+    std::istringstream in(values);
+    string token;
+    while(in >> token)
+        ret.push_back(strtod(token.c_str(), NULL));
+    return ret;
+}
+
+//creates the DataPathMatrix of an (expanded) datapath-matrix element
+static void LoadDataPathMatrix(xmlNodePtr n, unordered_map<string, Component*>& components)
+{
+    string owner_addr, endpoints, value;
+    GetXmlProp(n, "owner", &owner_addr);
+    GetXmlProp(n, "endpoints", &endpoints);
+    auto owner = components.find(owner_addr);
+    if(owner == components.end())
+    {
+        cerr << "importFromXml: skipping DataPath matrix with an unknown owner " << owner_addr << endl;
+        return;
+    }
+    vector<Component*> endpoint_components;
+    std::istringstream in(endpoints);
+    string addr;
+    while(in >> addr)
+    {
+        auto c = components.find(addr);
+        if(c == components.end())
+        {
+            cerr << "importFromXml: skipping DataPath matrix with an unknown endpoint " << addr << endl;
+            return;
+        }
+        endpoint_components.push_back(c->second);
+    }
+    int dp_type = GetXmlProp(n, "dp_type", &value) ? (int)strtol(value.c_str(), NULL, 10) : SYS_SAGE_DATAPATH_TYPE_NONE;
+    int oriented = GetXmlProp(n, "oriented", &value) ? (int)strtol(value.c_str(), NULL, 10) : SYS_SAGE_DATAPATH_ORIENTED;
+    DataPathMatrix* m = new DataPathMatrix(owner->second, endpoint_components, dp_type, oriented);
+
+    size_t num_entries = endpoint_components.size() * endpoint_components.size();
+    vector<double> bw, latency;
+    vector<pair<string, vector<double>>> metrics;
+    for(xmlNodePtr c = n->children; c != NULL; c = c->next)
+    {
+        string name;
+        if(c->type != XML_ELEMENT_NODE || !GetXmlProp(c, "name", &name) || !GetXmlProp(c, "values", &value))
+            continue;
+        vector<double> values = ParseMatrixValues(value);
+        values.resize(num_entries, std::nan(""));
+        if(name == "bw")
+            bw = std::move(values);
+        else if(name == "latency")
+            latency = std::move(values);
+        else
+            metrics.emplace_back(name, std::move(values));
+    }
+    bw.resize(num_entries, std::nan(""));
+    latency.resize(num_entries, std::nan(""));
+
+    //an entry exists if its bandwidth or latency is known (missing entries are exported as NaN)
+    int size = m->GetSize();
+    for(int src = 0; src < size; src++)
+    {
+        for(int dst = 0; dst < size; dst++)
+        {
+            size_t p = (size_t)src * size + dst;
+            if(!std::isnan(bw[p]) || !std::isnan(latency[p]))
+                m->Set(src, dst, std::isnan(bw[p]) ? -1 : bw[p], std::isnan(latency[p]) ? -1 : latency[p]);
+        }
+    }
+    for(auto& [name, values] : metrics)
+    {
+        int metric = m->AddMetric(name);
+        for(int src = 0; src < size; src++)
+            for(int dst = 0; dst < size; dst++)
+                if(m->Has(src, dst) && !std::isnan(values[(size_t)src * size + dst]))
+                    m->SetMetric(metric, src, dst, (float)values[(size_t)src * size + dst]);
+    }
+}
+
+Component* importFromXml(string path, std::function<int(string,string,AttributeStore*)> search_custom_attrib_key_fcn, std::function<int(string,xmlNodePtr,AttributeStore*)> search_custom_complex_attrib_key_fcn)
+{
+    AttributeCodecRegistry codecs;
+    codecs.SetFallbackDecoders(search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn);
+    return importFromXml(path, &codecs);
+}
+
+Component* importFromXml(string path, AttributeCodecRegistry* codecs)
+{
+    if(codecs == NULL)
+        codecs = AttributeCodecRegistry::GetDefault();
+    xmlTextReaderPtr reader = xmlReaderForFile(path.c_str(), NULL, 0);
+    if(reader == NULL)
+    {
+        cerr << "importFromXml: could not open " << path << endl;
+        return NULL;
+    }
+
+    Component* root = NULL;
+    bool error = false;
+    bool in_sys_sage = false, in_components = false, in_data_paths = false;
+    vector<Component*> open_components; //components whose element has not been closed yet
+    unordered_map<string, Component*> components; //exported address -> imported component
+    DataPath* dp = NULL; //DataPath of the open datapath element (receives its attributes)
+    unordered_map<string, int> bidirectional; //listings of bidirectional DataPaths, see LoadDataPath()
+    bool unique_data_paths = false; //each DataPath is listed once (data-paths element with unique="1")
+
+    int ret = xmlTextReaderRead(reader);
+    while(ret == 1)
+    {
+        int type = xmlTextReaderNodeType(reader);
+        const xmlChar* n = xmlTextReaderConstName(reader);
+        string name = (n == NULL) ? "" : (const char*)n;
+        bool skip = false; //continue after the subtree of the current element
+
+        if(type == XML_READER_TYPE_ELEMENT)
+        {
+            bool empty = xmlTextReaderIsEmptyElement(reader);
+            if(!in_sys_sage)
+            {
+                if(name != "sys-sage")
+                {
+                    cerr << "importFromXml: " << path << " is not a sys-sage export (root element " << name << ")" << endl;
+                    error = true;
+                    break;
+                }
+                in_sys_sage = true;
+            }
+            else if(in_components)
+            {
+                if(name == "Attribute")
+                {
+                    if(!open_components.empty())
+                        LoadAttribute(reader, &open_components.back()->attrib, codecs);
+                    skip = true;
+                }
+                else
+                {
+                    Component* c = LoadComponent(name, reader);
+                    if(c == NULL)
+                    {
+                        cerr << "importFromXml: unknown component type " << name << endl;
+                        error = true;
+                        break;
+                    }
+                    if(!open_components.empty())
+                        open_components.back()->InsertChild(c);
+                    else if(root == NULL)
+                        root = c;
+                    else
+                    {
+                        cerr << "importFromXml: more than one root component" << endl;
+                        delete c;
+                        error = true;
+                        break;
+                    }
+                    string addr;
+                    if(GetXmlProp(reader, "addr", &addr))
+                        components[addr] = c;
+                    if(!empty)
+                        open_components.push_back(c);
+                }
+            }
+            else if(in_data_paths)
+            {
+                if(name == "datapath")
+                {
+                    dp = LoadDataPath(reader, components, unique_data_paths ? NULL : &bidirectional);
+                    if(dp == NULL)
+                        skip = true;
+                    else if(empty)
+                        dp = NULL;
+                }
+                else if(name == "Attribute")
+                {
+                    if(dp != NULL)
+                        LoadAttribute(reader, &dp->attrib, codecs);
+                    skip = true;
+                }
+                else if(name == "datapath-matrix")
+                {
+                    xmlNodePtr matrix = xmlTextReaderExpand(reader);
+                    if(matrix != NULL)
+                        LoadDataPathMatrix(matrix, components);
+                    skip = true;
+                }
+                else
+                    skip = true;
+            }
+            else if(name == "components")
+                in_components = !empty;
+            else if(name == "data-paths")
+            {
+                string unique;
+                unique_data_paths = GetXmlProp(reader, "unique", &unique) && unique == "1";
+                in_data_paths = !empty;
+            }
+            else
+                skip = true;
+        }
+        else if(type == XML_READER_TYPE_END_ELEMENT)
+        {
+            if(in_components)
+            {
+                if(open_components.empty())
+                    in_components = false;
+                else
+                    open_components.pop_back();
+            }
+            else if(in_data_paths)
+            {
+                if(name == "datapath")
+                    dp = NULL;
+                else
+                    in_data_paths = false;
+            }
+        }
+
+        ret = skip ? xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+    }
+    if(ret < 0)
+    {
+        cerr << "importFromXml: could not parse " << path << endl;
+        error = true;
+    }
+    xmlFreeTextReader(reader);
+
+    if(!error && root == NULL)
+    {
+        cerr << "importFromXml: no components found in " << path << endl;
+        error = true;
+    }
+    if(error && root != NULL)
+    {
+        root->Delete(true);
+        root = NULL;
+    }
+    return root;
+}
+
+Component* importXmlShard(string manifest_path, int node_id, std::function<int(string,string,AttributeStore*)> search_custom_attrib_key_fcn, std::function<int(string,xmlNodePtr,AttributeStore*)> search_custom_complex_attrib_key_fcn)
+{
+    AttributeCodecRegistry codecs;
+    codecs.SetFallbackDecoders(search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn);
+    return importXmlShard(manifest_path, node_id, &codecs);
+}
+
+Component* importXmlShard(string manifest_path, int node_id, AttributeCodecRegistry* codecs)
+{
+    xmlTextReaderPtr reader = xmlReaderForFile(manifest_path.c_str(), NULL, 0);
+    if(reader == NULL)
+    {
+        cerr << "importXmlShard: could not open " << manifest_path << endl;
+        return NULL;
+    }
+
+    //only the components of the manifest are scanned; the shard Nodes are the elements with a shard attribute
+    string shard_file;
+    bool error = false, in_components = false;
+    int ret = xmlTextReaderRead(reader);
+    while(ret == 1 && shard_file.empty())
+    {
+        bool skip = false;
+        if(xmlTextReaderNodeType(reader) == XML_READER_TYPE_ELEMENT)
+        {
+            string name = (const char*)xmlTextReaderConstName(reader);
+            string file, id;
+            if(xmlTextReaderDepth(reader) == 0 && name != "sys-sage-manifest")
+            {
+                cerr << "importXmlShard: " << manifest_path << " is not a sys-sage manifest (root element " << name << ")" << endl;
+                error = true;
+                break;
+            }
+            else if(xmlTextReaderDepth(reader) == 1)
+            {
+                in_components = (name == "components");
+                skip = !in_components;
+            }
+            else if(in_components && name == "Node" && GetXmlProp(reader, "shard", &file) && GetXmlProp(reader, "id", &id) && atoi(id.c_str()) == node_id)
+                shard_file = file;
+        }
+        ret = skip ? xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+    }
+    if(ret < 0)
+    {
+        cerr << "importXmlShard: could not parse " << manifest_path << endl;
+        error = true;
+    }
+    xmlFreeTextReader(reader);
+    if(error)
+        return NULL;
+    if(shard_file.empty())
+    {
+        cerr << "importXmlShard: " << manifest_path << " has no shard of Node " << node_id << endl;
+        return NULL;
+    }
+
+    //the shard file is relative to the directory of the manifest
+    if(shard_file[0] != '/')
+        shard_file = manifest_path.substr(0, manifest_path.find_last_of('/') + 1) + shard_file;
+    return importFromXml(shard_file, codecs);
+}
@@ -0,0 +1,51 @@
+#ifndef XML_LOAD
+#define XML_LOAD
+
+#include <functional>
+
+#include "Topology.hpp"
+#include "DataPath.hpp"
+
+/**
+Imports a topology exported by exportToXml() -- the Component Tree, the DataPaths and the DataPath matrices -- e.g. to load a saved snapshot instead of running hwloc and the benchmark parsers again.
+\n The file is read in a streaming manner (libxml2 xmlTextReader), so the whole document is never held in memory. Components are created by their element name (e.g. Cache, NUMA, HW_thread) with their properties; the endpoints of the DataPaths are resolved through the exported "addr" attributes.
+\n Attributes (<Attribute> elements) are restored by decoders: first the custom one (if given), then load_default_attrib_key() (or load_default_complex_attrib_key() for attributes with child elements), which know the types of the attributes used by sys-sage. Simple attributes not known to any decoder are stored as string. (This is equivalent to passing a registry with the custom decoders as fallback decoders to importFromXml(string path, AttributeCodecRegistry* codecs).)
+\n exportToXml() lists each DataPath once. Exports of older versions, which list bidirectional DataPaths at both of their endpoints, are also supported: such DataPaths are created once.
+@param path - path to the XML file
+@param search_custom_attrib_key_fcn - (optional) decoder of simple attributes: called with the attribute name, its value and the AttributeStore to store it in; returns 1 if it has stored the attribute, 0 otherwise
+@param search_custom_complex_attrib_key_fcn - (optional) decoder of attributes with child elements: called with the attribute name, the <Attribute> element and the AttributeStore to store it in; returns 1 if it has stored the attribute, 0 otherwise
+@return the root of the imported Component Tree (the caller owns it); NULL if the file could not be read or is not a sys-sage export
+@see exportToXml()
+*/
+Component* importFromXml(string path, std::function<int(string, string, AttributeStore*)> search_custom_attrib_key_fcn = NULL, std::function<int(string, xmlNodePtr, AttributeStore*)> search_custom_complex_attrib_key_fcn = NULL);
+/**
+Imports a topology exported by exportToXml(), with the attributes decoded by the codecs of the given registry (see AttributeCodecRegistry). Simple attributes without a codec are stored as string; other attributes without a codec are left out.
+@param path - path to the XML file
+@param codecs - the registry; NULL for AttributeCodecRegistry::GetDefault()
+@return the root of the imported Component Tree (the caller owns it); NULL if the file could not be read or is not a sys-sage export
+*/
+Component* importFromXml(string path, AttributeCodecRegistry* codecs);
+/**
+Imports the shard of one Node of a sharded export written by exportToXmlShards(); the shard is found through the manifest and read by importFromXml().
+@param manifest_path - path to the manifest
+@param node_id - id of the Node whose shard to import
+@param search_custom_attrib_key_fcn, search_custom_complex_attrib_key_fcn - (optional) as for importFromXml()
+@return the imported Node subtree (the caller owns it); NULL if the manifest could not be read, does not list a shard of such a Node, or the shard could not be read
+*/
+Component* importXmlShard(string manifest_path, int node_id, std::function<int(string, string, AttributeStore*)> search_custom_attrib_key_fcn = NULL, std::function<int(string, xmlNodePtr, AttributeStore*)> search_custom_complex_attrib_key_fcn = NULL);
+/**
+@see importXmlShard(); the attributes are decoded by the codecs of the given registry (NULL for AttributeCodecRegistry::GetDefault()).
+*/
+Component* importXmlShard(string manifest_path, int node_id, AttributeCodecRegistry* codecs);
+/**
+Decodes an attribute used by sys-sage from its string representation and stores it in attrib (by the codecs of AttributeCodecRegistry::GetDefault()).
+@return 1 if the attribute was stored, 0 otherwise
+*/
+int load_default_attrib_key(string key, string value, AttributeStore* attrib);
+/**
+Decodes an attribute used by sys-sage from its <Attribute> element n and stores it in attrib (by the codecs of AttributeCodecRegistry::GetDefault()).
+@return 1 if the attribute was stored, 0 otherwise
+*/
+int load_default_complex_attrib_key(string key, xmlNodePtr n, AttributeStore* attrib);
+
+#endif
@@ -0,0 +1,132 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"arena"> _ = []
+{
+    "Components and data paths are allocated from the active arena"_test = []
+    {
+        Topology topo;
+        Arena *arena = topo.EnableArena(4096);
+        expect(that % arena == topo.GetArena());
+        expect(that % arena == topo.EnableArena());
+
+        Node *node;
+        {
+            ArenaScope scope{arena};
+            expect(that % arena == Arena::GetActive());
+            node = new Node{&topo, 1};
+            auto core = new Core{node, 0};
+            new Thread{core, 0};
+            DataPath *dp = new DataPath{node, core, SYS_SAGE_DATAPATH_ORIENTED};
+            expect(that % 4_u == arena->GetNumLiveObjects());
+            expect(that % arena == dp->attrib.GetArena());
+            // objects on the stack are not owned by the active arena
+            Node local;
+            expect(that % nullptr == local.attrib.GetArena());
+        }
+        expect(that % arena == node->FindArena());
+        expect(that % arena == node->attrib.GetArena());
+        expect(that % nullptr == topo.attrib.GetArena());
+        expect(that % nullptr == Arena::GetActive());
+        expect(that % 1 == node->GetNumThreads());
+
+        node->GetChild(0)->Delete(true);
+        expect(that % 1_u == arena->GetNumLiveObjects());
+        expect(that % node->GetChildren()->empty());
+        expect(that % node->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).empty());
+    };
+
+    "Slots of deleted objects are reused"_test = []
+    {
+        Topology topo;
+        Arena *arena = topo.EnableArena(4096);
+        Node *node = new Node{&topo, 0};
+        ArenaScope scope{arena};
+        Core *core = new Core{&topo, 1};
+        DataPath *dp = new DataPath{core, core, SYS_SAGE_DATAPATH_ORIENTED};
+        size_t allocated = arena->GetAllocatedBytes();
+
+        dp->DeleteDataPath();
+        core->Delete(true);
+        expect(that % 0_u == arena->GetNumLiveObjects());
+        Core *reused_core = new Core{&topo, 2};
+        DataPath *reused_dp = new DataPath{reused_core, node, SYS_SAGE_DATAPATH_ORIENTED};
+        expect(that % (void*)core == (void*)reused_core);
+        expect(that % (void*)dp == (void*)reused_dp);
+        expect(that % allocated == arena->GetAllocatedBytes());
+        expect(that % 2_u == arena->GetNumLiveObjects());
+
+        // the node lives on the heap, as no arena was active when it was created
+        reused_dp->DeleteDataPath();
+        node->Delete(true);
+        expect(that % 1_u == arena->GetNumLiveObjects());
+    };
+
+    "Attribute values are allocated from the arena of their owner"_test = []
+    {
+        Node heap_node;
+        Topology *topo = new Topology;
+        Arena *arena = topo->EnableArena(4096);
+        Node *node;
+        {
+            ArenaScope scope{arena};
+            node = new Node{topo, 0};
+            // the value outlives the arena, so it does not go to the active one
+            size_t allocated = arena->GetAllocatedBytes();
+            heap_node.attrib.Set<std::string>("name", "outside of the arena");
+            expect(that % allocated == arena->GetAllocatedBytes());
+        }
+        size_t allocated = arena->GetAllocatedBytes();
+        node->attrib.Set<std::string>("name", "in the arena");
+        expect(that % arena->GetAllocatedBytes() > allocated);
+        expect(that % arena == Arena::FindOwner(node->attrib.Get<std::string>("name")));
+        expect(that % nullptr == Arena::FindOwner(&heap_node));
+
+        delete topo;
+        expect(that % std::string("outside of the arena") == *heap_node.attrib.Get<std::string>("name"));
+    };
+
+    "Overwriting attributes does not grow the arena"_test = []
+    {
+        Topology *topo = new Topology;
+        Arena *arena = topo->EnableArena(4096);
+        Node *node;
+        {
+            ArenaScope scope{arena};
+            node = new Node{topo, 0};
+        }
+        uint64_t *cos = node->attrib.Set<uint64_t>("CATcos", 1);
+        size_t allocated = arena->GetAllocatedBytes();
+        for (uint64_t i = 2; i < 100; i++)
+            expect(that % cos == node->attrib.Set<uint64_t>("CATcos", i));
+        expect(that % allocated == arena->GetAllocatedBytes());
+        expect(that % uint64_t(99) == *node->attrib.Get<uint64_t>("CATcos"));
+        // a value of another type replaces the old one
+        node->attrib.Set<int>("CATcos", 7);
+        expect(that % nullptr == node->attrib.Get<uint64_t>("CATcos"));
+        expect(that % 7 == *node->attrib.Get<int>("CATcos"));
+        delete topo;
+    };
+
+    "Parsers allocate from the arena of the topology"_test = []
+    {
+        auto topo = new Topology;
+        Arena *arena = topo->EnableArena();
+        Node *node;
+        {
+            ArenaScope scope{arena};
+            node = new Node{topo, 0};
+        }
+        expect(that % (0 == parseHwlocOutput(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % (0 == parseCapsNumaBenchmark(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv")) >> fatal);
+        expect(that % nullptr == Arena::GetActive());
+        expect(that % arena->GetNumLiveObjects() > 100_u);
+        expect(that % 24 == topo->GetNumThreads());
+
+        // everything in the arena is freed at once together with the topology
+        delete topo;
+    };
+};
@@ -0,0 +1,136 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <cstdio>
+#include <string>
+
+using namespace boost::ut;
+
+static suite<"attributes"> _ = []
+{
+    "Typed attributes"_test = []
+    {
+        Node node;
+        node.attrib.Set<int>("rack_no", 42);
+        node.attrib.Set("codename", "marsupial");
+
+        expect(that % 42 == *node.attrib.Get<int>("rack_no"));
+        expect(that % "marsupial"sv == *node.attrib.Get<string>("codename"));
+        expect(that % nullptr == node.attrib.Get<double>("rack_no"));
+        expect(that % nullptr == node.attrib.Get<int>("missing"));
+
+        AttributeKey key("rack_no");
+        expect(that % key == AttributeKey("rack_no"));
+        expect(that % "rack_no"sv == key.GetName());
+        node.attrib.Set<int>(key, 43);
+        expect(that % 43 == *node.attrib.Get<int>(key));
+        expect(that % 2_u == node.attrib.size());
+
+        string formatted;
+        expect(that % AttributeStore::FormatValue(node.attrib.find("rack_no").GetEntry(), &formatted));
+        expect(that % "43"sv == formatted);
+    };
+
+    "Owned values are destroyed"_test = []
+    {
+        static int alive = 0;
+        struct Counted
+        {
+            Counted() { alive++; }
+            Counted(const Counted &) { alive++; }
+            ~Counted() { alive--; }
+        };
+        {
+            Node node;
+            node.attrib.Set("a", Counted{});
+            expect(that % 1 == alive);
+            node.attrib.Set("a", Counted{});
+            expect(that % 1 == alive);
+            node.attrib.Set("b", Counted{});
+            expect(that % 2 == alive);
+            node.attrib.erase("b");
+            expect(that % 1 == alive);
+        }
+        expect(that % 0 == alive);
+    };
+
+    "std::map-like interface"_test = []
+    {
+        Node node;
+        int rack = 7;
+        double temp = 38.5;
+        node.attrib["rack"] = (void *)&rack;
+        expect(that % node.attrib.insert({"temperature", (void *)&temp}).second);
+        expect(that % !node.attrib.insert({"temperature", (void *)&rack}).second);
+        node.attrib.Set<int>("id", 1);
+
+        expect(that % &rack == (int *)node.attrib["rack"]);
+        expect(that % &temp == (double *)node.attrib.find("temperature")->second);
+        expect(that % 1_u == node.attrib.count("rack"));
+        expect(that % 0_u == node.attrib.count("missing"));
+        expect(that % node.attrib.find("missing") == node.attrib.end());
+        // values of unknown type are returned as requested
+        expect(that % &rack == node.attrib.Get<int>("rack"));
+
+        // iteration is ordered by name
+        std::vector<std::string> keys;
+        for (const auto &[key, value] : node.attrib)
+            keys.push_back(key);
+        expect(that % keys == std::vector<std::string>{"id", "rack", "temperature"});
+        for (auto &kv : node.attrib)
+            if (kv.first == "temperature")
+                node.attrib[kv.first] = (void *)&rack;
+        expect(that % &rack == (int *)node.attrib["temperature"]);
+        auto it = node.attrib.begin();
+        it = node.attrib.find("rack");
+        expect(that % std::string("rack") == it->first);
+
+        // assigning a raw pointer replaces an owned value
+        node.attrib["id"] = (void *)&rack;
+        expect(that % &rack == (int *)node.attrib["id"]);
+        expect(that % 1_u == node.attrib.erase("id"));
+        node.attrib.clear();
+        expect(that % node.attrib.empty());
+    };
+
+    "Attribute codec registry"_test = []
+    {
+        AttributeCodecRegistry codecs;
+        codecs.Register<int>(AttributeKey("rack_no"), [](const int &v) { return "rack " + std::to_string(v); },
+                             [](const std::string &s, int *v) { return sscanf(s.c_str(), "rack %d", v) == 1; });
+        codecs.Register<long long>(AttributeKey("mig_size"), [](const long long &v) { return std::to_string(v) + " slices"; }, NULL);
+
+        Node node;
+        node.attrib.Set<int>("rack_no", 42);
+        node.attrib.Set<double>("weight", 1.5);
+        node.attrib.Set<long long>("mig_size", 3);
+        node.attrib.Set<uint64_t>("CATcos", 7);
+        std::string out;
+        expect(that % codecs.Encode(node.attrib.find("rack_no").GetEntry(), &out));
+        expect(that % std::string{"rack 42"} == out);
+        expect(that % !codecs.Encode(node.attrib.find("weight").GetEntry(), &out));
+        //the codec hides the one of the parent (GetDefault()); the parent is asked for other names
+        expect(that % codecs.Encode(node.attrib.find("mig_size").GetEntry(), &out));
+        expect(that % std::string{"3 slices"} == out);
+        expect(that % codecs.Encode(node.attrib.find("CATcos").GetEntry(), &out));
+        expect(that % std::string{"7"} == out);
+
+        //a value of another type than the codec's is not encoded by it
+        node.attrib.Set<double>("rack_no", 42.5);
+        expect(that % !codecs.Encode(node.attrib.find("rack_no").GetEntry(), &out));
+
+        Node other;
+        expect(that % codecs.Decode(AttributeKey("rack_no"), "rack 17", &other.attrib));
+        expect(that % (other.attrib.Get<int>("rack_no") != nullptr) >> fatal);
+        expect(that % 17 == *other.attrib.Get<int>("rack_no"));
+        expect(that % !codecs.Decode(AttributeKey("rack_no"), "17", &other.attrib));
+        expect(that % !codecs.Decode(AttributeKey("mig_size"), "3", &other.attrib));
+        expect(that % codecs.Decode(AttributeKey("CATcos"), "9", &other.attrib));
+        expect(that % 9u == *other.attrib.Get<uint64_t>("CATcos"));
+
+        codecs.Remove(AttributeKey("mig_size"));
+        expect(that % codecs.Decode(AttributeKey("mig_size"), "3", &other.attrib));
+        expect(that % 3 == *other.attrib.Get<long long>("mig_size"));
+    };
+};
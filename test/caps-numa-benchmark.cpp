@@ -96,4 +96,31 @@ static suite<"caps-numa-benchmark"> _ = []
         expect(that % 211 == dp(2, 3)->GetLatency());
         expect(that % 246 == dp(3, 3)->GetLatency());
     };
+
+    "History of repeated runs"_test = []
+    {
+        Topology topo;
+        Node node{&topo};
+        expect(that % (0 == parseHwlocOutput(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        for (int run = 0; run < 3; ++run)
+            expect(that % (0 == parseCapsNumaBenchmark(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv", ";", 2)) >> fatal);
+
+        std::vector<Component *> numas;
+        node.GetSubcomponentsByType(&numas, SYS_SAGE_COMPONENT_NUMA);
+        expect(that % (4 == numas.size()) >> fatal);
+        expect(that % (4 == numas[0]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size()) >> fatal);
+        DataPath *dp = numas[0]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING)[0];
+        expect(that % (dp->GetHistory() != nullptr) >> fatal);
+        expect(that % 2 == dp->GetHistory()->Size());
+        expect(that % 3 == dp->GetHistory()->GetNumAdded());
+        expect(that % 8621 == dp->GetHistory()->GetEwma(SYS_SAGE_METRIC_BW));
+
+        // unchanged measurements leave the DataPaths untouched
+        uint64_t version = DataPath::GetVersion();
+        expect(that % (0 == parseCapsNumaBenchmark(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv", ";", 2)) >> fatal);
+        expect(that % version == DataPath::GetVersion());
+        expect(that % 4 == dp->GetHistory()->GetNumAdded());
+        expect(that % 8621 == dp->GetBw());
+        node.DeleteSubtree();
+    };
 };
@@ -1,4 +1,6 @@
 #include <boost/ut.hpp>
+#include <cmath>
+#include <fstream>
 
 #include "sys-sage.hpp"
 
@@ -73,6 +75,27 @@ static suite<"data-path"> _ = []
         expect(that % (std::vector{&dp}) == *b.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
     };
 
+    "Data paths as a vector"_test = []
+    {
+        Component a, b;
+        DataPath ab{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+        DataPath bidirectional{&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+
+        expect(that % (std::vector{&ab, &bidirectional}) == *a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % (std::vector{&bidirectional}) == *a.GetDataPaths(SYS_SAGE_DATAPATH_INCOMING));
+        expect(that % 2 == b.GetDataPaths(SYS_SAGE_DATAPATH_INCOMING)->size());
+        expect(that % a.GetDataPaths(0) == nullptr);
+
+        // the cached vector is only refilled after a change
+        std::vector<DataPath*> *outgoing = a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING);
+        expect(that % outgoing == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
+        DataPath *ba = new DataPath{&b, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_LOGICAL};
+        expect(that % outgoing == a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % (std::vector{&ab, &bidirectional, ba}) == *outgoing);
+        ba->DeleteDataPath();
+        expect(that % (std::vector{&ab, &bidirectional}) == *a.GetDataPaths(SYS_SAGE_DATAPATH_OUTGOING));
+    };
+
     "Get data path by type"_test = []
     {
         Component a, b;
@@ -133,4 +156,532 @@ static suite<"data-path"> _ = []
             expect(that % std::vector{&dp2, &dp3, &dp4} == v);
         };
     };
+
+    "CSR graph"_test = []
+    {
+        Node root;
+        Core a{&root, 0};
+        Core b{&root, 1};
+        Core c{&root, 2};
+        Node outside;
+        DataPath ab{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 1.0, 10.0};
+        DataPath bc{&b, &c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 2.0, 20.0};
+        DataPath ao{&a, &outside, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C};
+
+        DataPathGraph graph{&root};
+        expect(that % graph.IsStale());
+        expect(that % 4 == graph.GetNumVertices());
+        expect(that % !graph.IsStale());
+        int ia = graph.GetIndex(&a), ib = graph.GetIndex(&b), ic = graph.GetIndex(&c);
+        expect(that % -1 == graph.GetIndex(&outside));
+        expect(that % graph.GetDpTypes() == std::vector<int>{SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_TYPE_C2C});
+
+        DataPathCsr *all = graph.GetCsr();
+        expect(that % 3 == all->GetNumEdges());
+        expect(that % 1 == all->End(ia) - all->Begin(ia));
+        expect(that % ib == all->neighbors[all->Begin(ia)]);
+        expect(that % 10.0 == all->latency[all->Begin(ia)]);
+
+        DataPathCsr *phys = graph.GetCsr(SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+        expect(that % 2 == phys->GetNumEdges());
+        expect(that % ic == phys->neighbors[phys->Begin(ib)]);
+        expect(that % ib == phys->neighbors[phys->Begin(ic)]);
+        expect(that % &bc == phys->dps[phys->Begin(ic)]);
+        expect(that % 2.0 == phys->bw[phys->Begin(ic)]);
+        expect(that % 0 == graph.GetCsr(SYS_SAGE_DATAPATH_TYPE_MIG)->GetNumEdges());
+
+        // only the metrics are reloaded after a new sample
+        uint64_t structure_version = DataPath::GetStructureVersion();
+        bc.AddSample(1.0, 4.0, 15.0);
+        expect(that % structure_version == DataPath::GetStructureVersion());
+        expect(that % graph.IsStale());
+        expect(that % phys == graph.GetCsr(SYS_SAGE_DATAPATH_TYPE_PHYSICAL));
+        expect(that % 4.0 == phys->bw[phys->Begin(ic)]);
+        expect(that % 15.0 == all->latency[all->Begin(ib)]);
+        expect(that % !graph.IsStale());
+
+        // rebuilt after a change
+        DataPath ca{&c, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C};
+        expect(that % graph.IsStale());
+        expect(that % 2 == graph.GetCsr(SYS_SAGE_DATAPATH_TYPE_C2C)->GetNumEdges());
+    };
+
+    "DataPaths grouped by type"_test = []
+    {
+        Node a, b;
+        DataPath *l3 = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        DataPath *mig = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
+        DataPath *c2c1 = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C);
+        DataPath *c2c2 = new DataPath(&b, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C);
+        DataPath *custom = new DataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, 3000);
+
+        expect(that % (SYS_SAGE_DATAPATH_TYPE_L3CAT | SYS_SAGE_DATAPATH_TYPE_MIG | SYS_SAGE_DATAPATH_TYPE_C2C) == a.GetDpTypeMask());
+        expect(that % a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_OUTGOING) == std::vector<DataPath*>{c2c1, c2c2});
+        expect(that % a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_INCOMING) == std::vector<DataPath*>{c2c2});
+        expect(that % b.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_INCOMING) == std::vector<DataPath*>{mig});
+        expect(that % a.GetDataPathsByType(3000, SYS_SAGE_DATAPATH_OUTGOING) == std::vector<DataPath*>{custom});
+        expect(that % a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_OUTGOING).empty());
+
+        std::vector<DataPath*> v;
+        a.GetAllDpByTypeMask(&v, SYS_SAGE_DATAPATH_TYPE_L3CAT | SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING);
+        expect(that % v == std::vector<DataPath*>{l3, mig});
+
+        mig->DeleteDataPath();
+        expect(that % (SYS_SAGE_DATAPATH_TYPE_L3CAT | SYS_SAGE_DATAPATH_TYPE_C2C) == a.GetDpTypeMask());
+        expect(that % a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_MIG, SYS_SAGE_DATAPATH_OUTGOING).empty());
+        expect(that % l3 == a.GetDpByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % c2c1 == a.GetDpByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % custom == a.GetDpByType(3000, SYS_SAGE_DATAPATH_OUTGOING));
+
+        a.DeleteAllDataPaths();
+        expect(that % 0u == a.GetDpTypeMask());
+        expect(that % 0u == b.GetDpTypeMask());
+        expect(that % b.GetDataPathsByType(3000, SYS_SAGE_DATAPATH_INCOMING).empty());
+    };
+
+    "Constant-time DataPath removal"_test = []
+    {
+        Node a, b, c;
+        std::vector<DataPath*> c2c;
+        for(int i = 0; i < 6; i++)
+            c2c.push_back(new DataPath(&a, (i % 2) ? &b : &c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C));
+        DataPath *loop = new DataPath(&a, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C);
+        DataPath *phys = new DataPath(&b, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+
+        c2c[0]->DeleteDataPath();
+        c2c[3]->DeleteDataPath();
+        loop->DeleteDataPath();
+        std::vector<DataPath*> rest{c2c[1], c2c[2], c2c[4], c2c[5], phys};
+        expect(that % 5 == a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        for(DataPath *dp : rest)
+            expect(that % 1 == std::count(a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).begin(), a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).end(), dp));
+        expect(that % 1 == a.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % 4 == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_INCOMING).empty());
+        expect(that % 3 == b.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+
+        a.DeleteDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % std::vector<DataPath*>{phys} == a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % 0 == c.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % std::vector<DataPath*>{phys} == b.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING));
+        expect(that % SYS_SAGE_DATAPATH_TYPE_PHYSICAL == b.GetDpTypeMask());
+
+        a.DeleteDataPathsByType(SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+        expect(that % 0 == b.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 0 == a.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+    };
+
+    "Bidirectional DataPaths stored once"_test = []
+    {
+        Node root;
+        Core a{&root, 0};
+        Core b{&root, 1};
+        Node outside;
+        DataPath ab{&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+        DataPath loop{&a, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+        DataPath in{&outside, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+        DataPath out{&b, &outside, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_LOGICAL};
+
+        expect(that % a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING) == std::vector<DataPath*>{&ab, &loop});
+        expect(that % a.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING) == std::vector<DataPath*>{&in, &ab, &loop});
+        expect(that % b.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING) == std::vector<DataPath*>{&ab, &out});
+
+        std::vector<DataPath*> v;
+        a.GetAllDpByType(&v, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_OUTGOING | SYS_SAGE_DATAPATH_INCOMING);
+        expect(that % v == std::vector<DataPath*>{&in, &ab, &loop});
+
+        unsigned component_size = 0, dp_size = 0;
+        root.GetTopologySize(&component_size, &dp_size);
+        unsigned component_size_set = 0, dp_size_set = 0;
+        std::set<DataPath*> counted;
+        root.GetTopologySize(&component_size_set, &dp_size_set, &counted);
+        expect(that % 4 == counted.size());
+        expect(that % dp_size == dp_size_set);
+        expect(that % component_size == component_size_set);
+    };
+
+    "Routing over the CSR graph"_test = []
+    {
+        Node root;
+        Core a{&root, 0};
+        Core b{&root, 1};
+        Core c{&root, 2};
+        Core d{&root, 3};
+        DataPath ab{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 10.0, 1.0};
+        DataPath bd{&b, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 1.0, 1.0};
+        DataPath ac{&a, &c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 5.0, 2.0};
+        DataPath cd{&c, &d, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 5.0, 2.0};
+        DataPath ad{&a, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 2.0, 10.0};
+        DataPath unknown{&a, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C};
+        DataPathGraph graph{&root};
+
+        std::vector<DataPath*> path;
+        expect(that % 2.0 == graph.GetLowestLatencyPath(&a, &d, &path));
+        expect(that % path == std::vector<DataPath*>{&ab, &bd});
+        path.clear();
+        expect(that % 5.0 == graph.GetWidestPath(&a, &d, &path));
+        expect(that % path == std::vector<DataPath*>{&ac, &cd});
+        path.clear();
+        expect(that % -1.0 == graph.GetLowestLatencyPath(&d, &a, &path, SYS_SAGE_DATAPATH_TYPE_C2C));
+        expect(that % path.empty());
+        expect(that % 0.0 == graph.GetLowestLatencyPath(&a, &a, &path));
+        expect(that % path.empty());
+
+        std::vector<std::vector<DataPath*>> paths;
+        std::vector<double> latencies;
+        expect(that % 3 == graph.GetKLowestLatencyPaths(&a, &d, 5, &paths, &latencies));
+        expect(that % latencies == std::vector<double>{2.0, 4.0, 10.0});
+        expect(that % paths[1] == std::vector<DataPath*>{&ac, &cd});
+        expect(that % paths[2] == std::vector<DataPath*>{&ad});
+        paths.clear();
+        expect(that % 2 == graph.GetKLowestLatencyPaths(&a, &d, 5, &paths, NULL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL));
+        paths.clear();
+        expect(that % 1 == graph.GetKLowestLatencyPaths(&a, &d, 1, &paths));
+        expect(that % paths[0] == std::vector<DataPath*>{&ab, &bd});
+
+        // the cached results are dropped when a DataPath is added
+        DataPath shortcut{&a, &d, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 1.0, 0.5};
+        path.clear();
+        expect(that % 0.5 == graph.GetLowestLatencyPath(&a, &d, &path));
+        expect(that % path == std::vector<DataPath*>{&shortcut});
+    };
+
+    "Roll-up of DataPaths to ancestors"_test = []
+    {
+        Node root;
+        Chip *chips[2];
+        Cache *l3[4];
+        Core *cores[8];
+        for(int s = 0; s < 2; s++)
+            chips[s] = new Chip(&root, s);
+        for(int l = 0; l < 4; l++)
+            l3[l] = new Cache(chips[l / 2], l, 3);
+        for(int i = 0; i < 8; i++)
+            cores[i] = new Core(l3[i / 2], i);
+        for(int i = 0; i < 8; i++)
+            for(int j = 0; j < 8; j++)
+                if(i != j)
+                    new DataPath(cores[i], cores[j], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, -1, (i / 2 == j / 2) ? 10.0 : (i / 4 == j / 4) ? 20.0 : 50.0 + (i % 2));
+
+        DataPathRollup sockets{&root, SYS_SAGE_COMPONENT_CHIP, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % *sockets.GetGroups() == std::vector<Component*>{chips[0], chips[1]});
+        DataPathStats *remote = sockets.GetStats(chips[0], chips[1]);
+        expect(that % 16 == remote->count);
+        expect(that % 50.0 == remote->min);
+        expect(that % 51.0 == remote->max);
+        expect(that % 50.5 == remote->GetMean());
+        DataPathStats *local = sockets.GetStats(chips[1], chips[1]);
+        expect(that % 12 == local->count);
+        expect(that % 200.0 == local->sum);
+        expect(that % 14 == sockets.GetNumRescanned());
+        expect(that % sockets.GetStats(chips[0], l3[2]) == nullptr);
+
+        DataPathRollup caches{&root, std::vector<Component*>{l3[0], l3[1], l3[2], l3[3]}, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % 2 == caches.GetStats(l3[3], l3[3])->count);
+        expect(that % 10.0 == caches.GetStats(l3[3], l3[3])->max);
+        expect(that % 20.0 == caches.GetStats(l3[0], l3[1])->min);
+
+        DataPath *shortcut = new DataPath(cores[0], cores[7], SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C, -1, 5.0);
+        expect(that % sockets.IsStale());
+        expect(that % 17 == sockets.GetStats(chips[1], chips[0])->count);
+        expect(that % 5.0 == sockets.GetStats(chips[0], chips[1])->min);
+        expect(that % 2 == sockets.GetNumRescanned());
+        shortcut->DeleteDataPath();
+        expect(that % 16 == sockets.GetStats(chips[1], chips[0])->count);
+        expect(that % 50.0 == sockets.GetStats(chips[0], chips[1])->min);
+        expect(that % not sockets.IsStale());
+
+        expect(that % 4 == sockets.CreateDataPaths(4096, SYS_SAGE_ROLLUP_MEAN));
+        DataPathList aggregated = chips[0]->GetDataPathsByType(4096, SYS_SAGE_DATAPATH_OUTGOING);
+        expect(that % 2 == aggregated.size());
+        DataPath *to_remote = (aggregated[0]->GetTarget() == chips[1]) ? aggregated[0] : aggregated[1];
+        expect(that % 50.5 == to_remote->GetLatency());
+        expect(that % 16 == *to_remote->attrib.Get<int>("count"));
+        expect(that % 16 == sockets.GetStats(chips[0], chips[1])->count);
+        expect(that % -1 == sockets.CreateDataPaths(4096, 0));
+        expect(that % 4 == sockets.CreateDataPaths(4096, SYS_SAGE_ROLLUP_MAX));
+        expect(that % 2 == chips[0]->GetDataPathsByType(4096, SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 51.0 == to_remote->GetLatency());
+
+        root.DeleteSubtree();
+        expect(that % sockets.GetGroups()->empty());
+    };
+
+    "Roll-up after deleting all DataPaths of a component"_test = []
+    {
+        Node root;
+        Chip *a = new Chip(&root, 0);
+        Chip *b = new Chip(&root, 1);
+        Core *a0 = new Core(a, 0);
+        Core *b0 = new Core(b, 1);
+        new DataPath(a0, b0, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, -1, 30.0);
+
+        DataPathRollup sockets{&root, SYS_SAGE_COMPONENT_CHIP, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % 1 == sockets.GetStats(a, b)->count);
+        a0->DeleteAllDataPaths();
+        expect(that % sockets.IsStale());
+        sockets.Refresh();
+        expect(that % sockets.GetStats(a, b) == nullptr);
+        DataPathRollup fresh{&root, SYS_SAGE_COMPONENT_CHIP, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % fresh.GetStats(a, b) == nullptr);
+    };
+
+    "Parallel roll-up"_test = []
+    {
+        Node root;
+        std::vector<Core*> cores;
+        for(int s = 0; s < 2; s++)
+        {
+            Chip *chip = new Chip(&root, s);
+            for(int i = 0; i < 300; i++)
+                cores.push_back(new Core(chip, cores.size()));
+        }
+        double expected_sum[2][2] = {};
+        int expected_count[2][2] = {};
+        for(int i = 0; i < (int)cores.size(); i++)
+            for(int k = 1; k <= 10; k++)
+            {
+                int j = (i * 7 + k * 31) % cores.size();
+                double bw = (i + j) % 13;
+                new DataPath(cores[i], cores[j], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, bw, -1);
+                expected_sum[i / 300][j / 300] += bw;
+                expected_count[i / 300][j / 300]++;
+            }
+
+        DataPathRollup rollup{&root, SYS_SAGE_COMPONENT_CHIP, SYS_SAGE_DATAPATH_TYPE_ANY, SYS_SAGE_METRIC_BW};
+        rollup.SetNumThreads(4);
+        for(int s = 0; s < 2; s++)
+            for(int t = 0; t < 2; t++)
+            {
+                DataPathStats *stats = rollup.GetStats((*rollup.GetGroups())[s], (*rollup.GetGroups())[t]);
+                expect(that % expected_count[s][t] == stats->count);
+                expect(that % expected_sum[s][t] == stats->sum);
+                expect(that % 0.0 == stats->min);
+                expect(that % 12.0 == stats->max);
+            }
+        expect(that % 602 == rollup.GetNumRescanned());
+        root.DeleteSubtree();
+    };
+
+    "Upsert DataPaths"_test = []
+    {
+        Node a, b;
+        DataPath *legacy = new DataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        expect(that % legacy == UpsertDataPath(&b, &a, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT, 5.0, 1.0));
+        expect(that % 5.0 == legacy->GetBw());
+
+        uint64_t version = DataPath::GetVersion();
+        for(int i = 0; i < 10; i++)
+        {
+            DataPath *dp = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT, 5.0, 2.0 + i);
+            dp->attrib.Set<uint64_t>("CATcos", i);
+        }
+        expect(that % 1 == a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 11.0 == legacy->GetLatency());
+        expect(that % 9u == *legacy->attrib.Get<uint64_t>("CATcos"));
+        expect(that % DataPath::GetVersion() > version);
+        expect(that % a.GetDataPathStamp() == b.GetDataPathStamp());
+
+        DataPath *oriented = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        DataPath *reverse = UpsertDataPath(&b, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT);
+        DataPath *other_type = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_MIG);
+        expect(that % oriented != legacy);
+        expect(that % reverse != oriented);
+        expect(that % other_type != oriented);
+        expect(that % oriented == UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT));
+        expect(that % 3 == a.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % UpsertDataPath(&a, &b, 0, SYS_SAGE_DATAPATH_TYPE_L3CAT) == nullptr);
+
+        legacy->DeleteDataPath();
+        DataPath *recreated = UpsertDataPath(&a, &b, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT, 1.0, 1.0);
+        expect(that % 1.0 == recreated->GetBw());
+        expect(that % 2 == a.GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_INCOMING).size());
+        a.DeleteAllDataPaths();
+        expect(that % 0 == b.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        DataPath *fresh = UpsertDataPath(&b, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT, 3.0, 3.0);
+        expect(that % fresh == UpsertDataPath(&b, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_L3CAT, 4.0, 3.0));
+        expect(that % 1 == b.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 4.0 == fresh->GetBw());
+        b.DeleteAllDataPaths();
+    };
+
+    "Batch DataPath creation"_test = []
+    {
+        Topology topo;
+        Arena *arena = topo.EnableArena(4096);
+        std::vector<Component*> cores;
+        std::vector<DataPath*> created;
+        {
+            ArenaScope scope{arena};
+            for(int i = 0; i < 40; i++)
+                cores.push_back(new Core(&topo, i));
+            //a free slot of a deleted DataPath is not used by the batch
+            (new DataPath(cores[0], cores[1], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL))->DeleteDataPath();
+            DataPathBatch batch;
+            std::vector<float> *latency = batch.AddAttributeColumn<float>(AttributeKey("latency"));
+            for(Component *x : cores)
+                for(Component *y : cores)
+                    if(x != y)
+                    {
+                        batch.Add(x, y, SYS_SAGE_DATAPATH_TYPE_C2C, 0, x->GetId() + y->GetId());
+                        latency->push_back(x->GetId() * 100 + y->GetId());
+                    }
+            expect(that % 1560 == batch.Size());
+            expect(that % 1560 == batch.Commit(&created));
+            expect(that % 0 == batch.Size());
+        }
+        expect(that % 1560 == created.size());
+        expect(that % 39 == cores[3]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 39 == cores[3]->GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_INCOMING).size());
+        DataPath *dp = created[41];
+        expect(that % cores[1] == dp->GetSource());
+        expect(that % cores[3] == dp->GetTarget());
+        expect(that % 4.0 == dp->GetLatency());
+        expect(that % 103.0f == *dp->attrib.Get<float>("latency"));
+        //one contiguous block of the Arena
+        std::ptrdiff_t slot = (sizeof(DataPath) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1) / __STDCPP_DEFAULT_NEW_ALIGNMENT__ * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        bool contiguous = true;
+        for(size_t i = 1; i < created.size(); i++)
+            contiguous &= ((char*)created[i] - (char*)created[i-1]) == slot;
+        expect(that % contiguous);
+
+        dp->DeleteDataPath();
+        expect(that % 38 == cores[1]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+
+        Node a, b;
+        DataPathBatch bidirectional{SYS_SAGE_DATAPATH_BIDIRECTIONAL};
+        bidirectional.Add(&a, &b, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 1, 1);
+        bidirectional.Add(&a, &a, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 1, 1);
+        expect(that % 2 == bidirectional.Commit());
+        expect(that % 2 == a.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % 1 == b.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        a.DeleteAllDataPaths();
+        DataPathBatch invalid{0};
+        invalid.Add(&a, &b, SYS_SAGE_DATAPATH_TYPE_PHYSICAL);
+        expect(that % -1 == invalid.Commit());
+        expect(that % 0 == b.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+    };
+
+    "DataPath matrix"_test = []
+    {
+        Node node;
+        Core c0{&node, 0}, c1{&node, 1}, c2{&node, 2};
+        Core outside{nullptr, 3};
+        DataPathMatrix *m = new DataPathMatrix(&node, {&c0, &c1, &c2}, SYS_SAGE_DATAPATH_TYPE_C2C);
+        expect(that % node.GetDataPathMatrices() == std::vector<DataPathMatrix*>{m});
+        int latency_max = m->AddMetric("latency_max");
+        expect(that % latency_max == m->AddMetric("latency_max"));
+        expect(that % 0 == m->Set(&c0, &c1, 2.0, 10.0));
+        expect(that % 1 == m->Set(&c0, &outside, 2.0, 10.0));
+        m->Set(0, 2, 3.0, 20.0);
+        m->Set(1, 0, 4.0, 30.0);
+        m->SetMetric(latency_max, 0, 2, 25.0f);
+        expect(that % 3 == m->GetNumDataPaths());
+        expect(that % 0 == node.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+
+        DataPathMatrixEntry e = m->GetDataPath(&c0, &c2);
+        expect(that % e.IsValid());
+        expect(that % &c0 == e.GetSource());
+        expect(that % &c2 == e.GetTarget());
+        expect(that % 3.0 == e.GetBw());
+        expect(that % 20.0 == e.GetLatency());
+        expect(that % SYS_SAGE_DATAPATH_TYPE_C2C == e.GetDpType());
+        expect(that % 25.0f == e.GetMetric("latency_max"));
+        expect(that % std::isnan(e.GetMetric("latency_min")));
+        expect(that % not m->GetDataPath(&c2, &c0).IsValid());
+        expect(that % not m->GetDataPath(&c2, &outside).IsValid());
+        DataPathMatrixEntry missing = m->GetDataPath(&outside, &c0);
+        expect(that % not missing.IsValid());
+        expect(that % nullptr == missing.GetSource());
+        expect(that % nullptr == missing.GetTarget());
+        expect(that % -1.0 == missing.GetBw());
+        expect(that % -1.0 == missing.GetLatency());
+        expect(that % -1.0f == missing.GetMetric("latency_max"));
+        expect(that % -1 == DataPathMatrixEntry().GetDpType());
+
+        std::vector<Component*> targets;
+        for(DataPathMatrixEntry out : m->GetDataPaths(&c0, SYS_SAGE_DATAPATH_OUTGOING))
+            targets.push_back(out.GetTarget());
+        expect(that % targets == std::vector<Component*>{&c1, &c2});
+        expect(that % 1 == m->GetDataPaths(&c0, SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % m->GetDataPaths(&c2, SYS_SAGE_DATAPATH_OUTGOING).empty());
+        expect(that % m->GetDataPaths(&outside, SYS_SAGE_DATAPATH_OUTGOING).empty());
+        m->Remove(0, 1);
+        expect(that % 2 == m->GetNumDataPaths());
+        expect(that % 1 == m->GetDataPaths(&c0, SYS_SAGE_DATAPATH_OUTGOING).size());
+
+        DataPathMatrix *sym = new DataPathMatrix(&node, {&c0, &c1}, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, SYS_SAGE_DATAPATH_BIDIRECTIONAL);
+        sym->Set(0, 1, 1.0, 1.0);
+        expect(that % sym->Has(1, 0));
+        expect(that % 2 == sym->GetNumDataPaths());
+        delete m;
+        expect(that % node.GetDataPathMatrices() == std::vector<DataPathMatrix*>{sym});
+    };
+
+    "cccbench output as a DataPath matrix"_test = []
+    {
+        {
+            std::ofstream csv("test_cccbench.csv");
+            csv << "xcore,ycore,xylat" << std::endl;
+            for(int x = 0; x < 3; x++)
+                for(int y = 0; y < 3; y++)
+                    if(x != y)
+                        csv << x << "," << y << "," << (10 * x + y) << std::endl << x << "," << y << "," << (10 * x + y + 2) << std::endl;
+        }
+        Node node;
+        Core c0{&node, 0}, c1{&node, 1}, c2{&node, 2};
+        expect(that % 0 == parseCccbenchOutput(&node, "test_cccbench.csv", true));
+        expect(that % 0 == c0.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 1 == node.GetDataPathMatrices().size());
+        DataPathMatrix *m = node.GetDataPathMatrices()[0];
+        expect(that % 6 == m->GetNumDataPaths());
+        DataPathMatrixEntry e = m->GetDataPath(&c2, &c1);
+        expect(that % 22.0 == e.GetLatency());
+        expect(that % 21.0f == e.GetMetric("latency_min"));
+        expect(that % 23.0f == e.GetMetric("latency_max"));
+    };
+
+    "DataPath history"_test = []
+    {
+        Component a, b;
+        DataPath *dp = new DataPath{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 10, 100};
+        expect(that % dp->GetHistory() == nullptr);
+        dp->AddSample(0, 20, 200);
+        expect(that % 20 == dp->GetBw());
+
+        DataPathHistory *h = dp->EnableHistory(3, 0.5);
+        expect(that % h == dp->EnableHistory(5));
+        expect(that % h->GetLatest() == nullptr);
+        expect(that % -1 == h->GetEwma(SYS_SAGE_METRIC_BW));
+        dp->AddSample(1, 8, 100);
+        dp->AddSample(2, 4, -1);
+        dp->AddSample(3, 12, 300);
+        dp->AddSample(4, 16, 200);
+        expect(that % 16 == dp->GetBw());
+        expect(that % 200 == dp->GetLatency());
+        expect(that % 3 == h->Size());
+        expect(that % 4 == h->GetNumAdded());
+        expect(that % 2 == h->Get(0)->timestamp);
+        expect(that % 4 == h->GetLatest()->timestamp);
+        expect(that % h->Get(3) == nullptr);
+
+        expect(that % 4 == h->GetMin(SYS_SAGE_METRIC_BW));
+        expect(that % 16 == h->GetMax(SYS_SAGE_METRIC_BW));
+        expect(that % 12.5 == h->GetEwma(SYS_SAGE_METRIC_BW));
+        expect(that % 100 == h->GetMin(SYS_SAGE_METRIC_LATENCY));
+        expect(that % 200 == h->GetEwma(SYS_SAGE_METRIC_LATENCY));
+
+        DataPathStats window = h->GetWindowStats(SYS_SAGE_METRIC_LATENCY, 2, 3);
+        expect(that % 1 == window.count);
+        expect(that % 300 == window.max);
+        DataPathStats latest = h->GetLatestStats(SYS_SAGE_METRIC_BW, 2);
+        expect(that % 2 == latest.count);
+        expect(that % 14 == latest.GetMean());
+        expect(that % 3 == h->GetLatestStats(SYS_SAGE_METRIC_BW, 10).count);
+
+        dp->DisableHistory();
+        expect(that % dp->GetHistory() == nullptr);
+        dp->EnableHistory(2);
+        a.DeleteAllDataPaths();
+    };
 };
@@ -10,6 +10,8 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
+#include <vector>
 
 using XmlStringView = std::basic_string_view<const xmlChar>;
 
@@ -263,4 +265,172 @@ static suite<"export"> _ = []
             }
         }
     };
+
+    "DataPath matrix"_test = []
+    {
+        {
+            auto topo = new Topology;
+            auto node = new Node{topo, 0};
+            auto c0 = new Core{node, 0};
+            auto c1 = new Core{node, 1};
+            auto m = new DataPathMatrix{node, {c0, c1}, SYS_SAGE_DATAPATH_TYPE_C2C};
+            m->Set(0, 1, 0, 42);
+            m->SetMetric(m->AddMetric("latency_max"), 0, 1, 50);
+            exportToXml(topo, "test.xml");
+            topo->DeleteSubtree();
+            delete topo;
+        }
+
+        {
+            validate("test.xml");
+
+            auto doc = raii<xmlDoc>{xmlParseFile("test.xml"), xmlFreeDoc};
+            expect(that % (doc != nullptr) >> fatal);
+
+            auto pathContext = raii<xmlXPathContext>{xmlXPathNewContext(doc.get()), xmlXPathFreeContext};
+            expect(that % (pathContext != nullptr) >> fatal);
+
+            xmlNode *matrix = getSingleNodeByPath(BAD_CAST("/sys-sage/data-paths/datapath-matrix"), pathContext.get());
+
+            for (const auto &[xpath, value] : std::vector{
+                     std::tuple{"string(@size)", "2"},
+                     std::tuple{"string(@dp_type)", "2048"},
+                     std::tuple{"string(metric[2]/@name)", "latency"},
+                     std::tuple{"string(metric[2]/@values)", "NaN 42.000000 NaN NaN"},
+                     std::tuple{"string(metric[3]/@name)", "latency_max"},
+                     std::tuple{"string(metric[3]/@values)", "NaN 50.000000 NaN NaN"},
+                 })
+            {
+                auto result = raii<xmlXPathObject>{xmlXPathNodeEval(matrix, BAD_CAST(xpath), pathContext.get()), xmlXPathFreeObject};
+                expect((result != nullptr) and that % XmlStringView{BAD_CAST(value)} == XmlStringView{result->stringval});
+            }
+        }
+    };
+
+    "DataPaths and complex attributes"_test = []
+    {
+        {
+            auto topo = new Topology;
+            auto node = new Node{topo, 0};
+            auto t0 = new Thread{node, 0};
+            auto t1 = new Thread{node, 1};
+            new DataPath{t0, t1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 8621, 0.25};
+            node->attrib.Set<std::tuple<double, std::string>>("GPU_Clock_Rate", {1.5, "GHz"});
+            node->attrib.Set<std::vector<std::tuple<long long, double>>>("freq_history", {{10, 2100}, {20, 2400.5}});
+            expect(that % 0 == exportToXml(topo, "test.xml"));
+            topo->DeleteSubtree();
+            topo->DeleteAllDataPaths();
+            delete topo;
+        }
+
+        {
+            validate("test.xml");
+
+            auto doc = raii<xmlDoc>{xmlParseFile("test.xml"), xmlFreeDoc};
+            expect(that % (doc != nullptr) >> fatal);
+
+            auto pathContext = raii<xmlXPathContext>{xmlXPathNewContext(doc.get()), xmlXPathFreeContext};
+            expect(that % (pathContext != nullptr) >> fatal);
+
+            xmlNode *node = getSingleNodeByPath(BAD_CAST("/sys-sage/components/Topology/Node"), pathContext.get());
+            xmlNode *dp = getSingleNodeByPath(BAD_CAST("/sys-sage/data-paths/datapath"), pathContext.get());
+
+            for (const auto &[node, xpath, value] : std::vector{
+                     std::tuple{node, "string(Attribute[@name='GPU_Clock_Rate']/GPU_Clock_Rate/@frequency)", "1.500000"},
+                     std::tuple{node, "string(Attribute[@name='GPU_Clock_Rate']/GPU_Clock_Rate/@unit)", "GHz"},
+                     std::tuple{node, "string(count(Attribute[@name='freq_history']/freq_history))", "2"},
+                     std::tuple{node, "string(Attribute[@name='freq_history']/freq_history[2]/@frequency)", "2400.500000"},
+                     std::tuple{dp, "string(@oriented)", "16"},
+                     std::tuple{dp, "string(@bw)", "8621.000000"},
+                     std::tuple{dp, "string(@latency)", "0.250000"},
+                     std::tuple{dp, "string(@source = /sys-sage/components/Topology/Node/HW_thread[@id='0']/@addr)", "true"},
+                     std::tuple{dp, "string(@target = /sys-sage/components/Topology/Node/HW_thread[@id='1']/@addr)", "true"},
+                 })
+            {
+                auto result = raii<xmlXPathObject>{xmlXPathNodeEval(node, BAD_CAST(xpath), pathContext.get()), xmlXPathFreeObject};
+                expect((result != nullptr) and that % XmlStringView{BAD_CAST(value)} == XmlStringView{result->stringval});
+            }
+        }
+
+        Component c;
+        expect(that % 1 == exportToXml(&c, "does-not-exist/test.xml"));
+    };
+
+    "Each DataPath is listed once"_test = []
+    {
+        auto topo = new Topology;
+        auto node = new Node{topo, 0};
+        auto t0 = new Thread{node, 0};
+        auto t1 = new Thread{node, 1};
+        new DataPath{t0, t1, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT};
+        new DataPath{t0, t1, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT};
+        new DataPath{t1, t0, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 10, 20};
+        new DataPath{t1, t1, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_LOGICAL};
+
+        auto countDataPaths = []
+        {
+            auto doc = raii<xmlDoc>{xmlParseFile("test.xml"), xmlFreeDoc};
+            expect(that % (doc != nullptr) >> fatal);
+            auto pathContext = raii<xmlXPathContext>{xmlXPathNewContext(doc.get()), xmlXPathFreeContext};
+            auto result = raii<xmlXPathObject>{xmlXPathEvalExpression(BAD_CAST("count(/sys-sage/data-paths/datapath)"), pathContext.get()), xmlXPathFreeObject};
+            return (int)result->floatval;
+        };
+
+        exportToXml(topo, "test.xml");
+        validate("test.xml");
+        expect(that % 4 == countDataPaths());
+
+        //the source of the bidirectional DataPaths is not exported: they are listed at their target; the oriented one is not listed
+        exportToXml(t1, "test.xml");
+        expect(that % 3 == countDataPaths());
+
+        topo->DeleteSubtree();
+        topo->DeleteAllDataPaths();
+        delete topo;
+    };
+
+    "Sharded export"_test = []
+    {
+        auto topo = new Topology;
+        std::vector<Component *> threads;
+        for (int n = 0; n < 3; n++)
+        {
+            auto node = new Node{topo, n};
+            threads.push_back(new Thread{node, 0});
+            threads.push_back(new Thread{node, 1});
+            new DataPath{threads[2 * n], threads[2 * n + 1], SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT};
+            new DataPath{threads[2 * n + 1], threads[2 * n], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 10, 20};
+        }
+        new Memory{topo, "shared", 1024};
+        new DataPath{threads[0], threads[2], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1, 2};
+        new DataPath{threads[5], threads[1], SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL};
+
+        expect(that % 0 == exportToXmlShards(topo, "test_shards.xml", 2));
+
+        auto count = [](const char *path, const char *xpath)
+        {
+            auto doc = raii<xmlDoc>{xmlParseFile(path), xmlFreeDoc};
+            expect(that % (doc != nullptr) >> fatal);
+            auto pathContext = raii<xmlXPathContext>{xmlXPathNewContext(doc.get()), xmlXPathFreeContext};
+            auto result = raii<xmlXPathObject>{xmlXPathEvalExpression(BAD_CAST(xpath), pathContext.get()), xmlXPathFreeObject};
+            return (int)result->floatval;
+        };
+
+        for (const char *shard : {"test_shards.shard0.xml", "test_shards.shard1.xml", "test_shards.shard2.xml"})
+        {
+            validate(shard);
+            expect(that % 1 == count(shard, "count(/sys-sage/components/Node)"));
+            expect(that % 2 == count(shard, "count(/sys-sage/data-paths/datapath)"));
+        }
+
+        expect(that % 3 == count("test_shards.xml", "count(/sys-sage-manifest/components/Topology/Node[@shard])"));
+        expect(that % 0 == count("test_shards.xml", "count(/sys-sage-manifest/components/Topology/Node/*)"));
+        expect(that % 1 == count("test_shards.xml", "count(/sys-sage-manifest/components/Topology/Memory)"));
+        expect(that % 2 == count("test_shards.xml", "count(/sys-sage-manifest/data-paths/datapath)"));
+        expect(that % 1 == count("test_shards.xml", "count(/sys-sage-manifest/components/Topology/Node[@id='2'][@shard='test_shards.shard2.xml'])"));
+
+        topo->DeleteSubtree();
+        topo->DeleteAllDataPaths();
+        delete topo;
+    };
 };
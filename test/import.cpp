@@ -0,0 +1,258 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <tuple>
+
+using namespace boost::ut;
+
+static suite<"import"> _ = []
+{
+    "Sample output"_test = []
+    {
+        Component *topo = importFromXml(SYS_SAGE_TEST_RESOURCE_DIR "/sys-sage_sample_output.xml");
+        expect(that % (topo != nullptr) >> fatal);
+        expect(that % SYS_SAGE_COMPONENT_TOPOLOGY == topo->GetComponentType());
+        expect(that % 50 == topo->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CACHE));
+        expect(that % 24 == topo->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 24 == topo->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD));
+        expect(that % 0 == topo->CheckComponentTreeConsistency());
+
+        std::vector<Component *> numas;
+        topo->FindAllSubcomponentsByType(&numas, SYS_SAGE_COMPONENT_NUMA);
+        expect(that % (4 == numas.size()) >> fatal);
+        for (Component *numa : numas)
+            expect(that % 4 == numa->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        DataPath *dp = numas[0]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING)[0];
+        expect(that % SYS_SAGE_DATAPATH_ORIENTED == dp->GetOriented());
+        expect(that % 8621 == dp->GetBw());
+        expect(that % 244 == dp->GetLatency());
+
+        topo->Delete(true);
+    };
+
+    "Custom attribute decoders"_test = []
+    {
+        auto decoder = [](std::string key, std::string value, AttributeStore *attrib)
+        {
+            if (key != "rack_no")
+                return 0;
+            attrib->Set<int>(key, std::atoi(value.c_str()));
+            return 1;
+        };
+        auto complexDecoder = [](std::string key, xmlNodePtr n, AttributeStore *attrib)
+        {
+            if (key != "my_core_info")
+                return 0;
+            xmlChar *temperature = xmlGetProp(xmlFirstElementChild(n), BAD_CAST "temperature");
+            attrib->Set<double>(key, std::atof((const char *)temperature));
+            xmlFree(temperature);
+            return 1;
+        };
+        Component *topo = importFromXml(SYS_SAGE_TEST_RESOURCE_DIR "/sys-sage_custom_attributes.xml", decoder, complexDecoder);
+        expect(that % (topo != nullptr) >> fatal);
+
+        Component *node = topo->GetChild(1);
+        expect(that % (node != nullptr) >> fatal);
+        expect(that % (node->attrib.Get<std::string>("codename") != nullptr) >> fatal);
+        expect(that % std::string{"marsupial"} == *node->attrib.Get<std::string>("codename"));
+        expect(that % (node->attrib.Get<int>("rack_no") != nullptr) >> fatal);
+        expect(that % 15 == *node->attrib.Get<int>("rack_no"));
+
+        Component *core = node->FindSubcomponentById(1, SYS_SAGE_COMPONENT_CORE);
+        expect(that % (core != nullptr) >> fatal);
+        expect(that % (core->attrib.Get<double>("my_core_info") != nullptr) >> fatal);
+        expect(that % 38.222 == *core->attrib.Get<double>("my_core_info"));
+
+        topo->Delete(true);
+    };
+
+    "Round trip"_test = []
+    {
+        {
+            auto topo = new Topology;
+            auto node = new Node{topo, 3};
+            auto chip = new Chip{node, 0, "socket"};
+            chip->SetVendor("GenuineIntel");
+            auto l3 = new Cache{chip, 7, "3", 17301504, 11, 64};
+            auto core = new Core{l3, 1};
+            auto thread = new Thread{core, 2};
+            new Memory{node, "ram", 1024};
+            auto numa = new Numa{node, 0, 2048};
+            auto gpu = new Subdivision{chip, 4, "sm", SYS_SAGE_COMPONENT_SUBDIVISION};
+            gpu->SetSubdivisionType(SYS_SAGE_SUBDIVISION_TYPE_GPU_SM);
+            node->attrib.Set<long long>("mig_size", 5);
+
+            new DataPath{core, thread, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_LOGICAL};
+            new DataPath{core, thread, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_LOGICAL};
+            auto cat = new DataPath{thread, l3, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_L3CAT};
+            cat->attrib.Set<uint64_t>("CATcos", 3);
+            cat->attrib.Set<uint64_t>("CATL3mask", 0xff);
+            new DataPath{thread, numa, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 100, 80};
+            node->attrib.Set<std::tuple<double, std::string>>("GPU_Clock_Rate", {1.5, "GHz"});
+
+            auto m = new DataPathMatrix{node, {core, thread}, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_DATAPATH_BIDIRECTIONAL};
+            m->Set(0, 1, -1, 42);
+            m->SetMetric(m->AddMetric("latency_max"), 0, 1, 50);
+
+            exportToXml(topo, "test.xml");
+            topo->Delete(true);
+        }
+
+        Component *topo = importFromXml("test.xml");
+        expect(that % (topo != nullptr) >> fatal);
+        expect(that % 0 == topo->CheckComponentTreeConsistency());
+        Node *node = (Node *)topo->GetChild(3);
+        expect(that % (node != nullptr) >> fatal);
+        expect(that % 5 == *node->attrib.Get<long long>("mig_size"));
+        auto clock = node->attrib.Get<std::tuple<double, std::string>>("GPU_Clock_Rate");
+        expect(that % (clock != nullptr) >> fatal);
+        expect(that % std::string{"GHz"} == std::get<1>(*clock));
+
+        Chip *chip = (Chip *)node->GetChild(0);
+        expect(that % (chip != nullptr) >> fatal);
+        expect(that % std::string{"GenuineIntel"} == chip->GetVendor());
+        Cache *l3 = (Cache *)chip->GetChild(7);
+        expect(that % (l3 != nullptr) >> fatal);
+        expect(that % 3 == l3->GetCacheLevel());
+        expect(that % 17301504 == l3->GetCacheSize());
+        expect(that % 11 == l3->GetCacheAssociativityWays());
+        expect(that % 64 == l3->GetCacheLineSize());
+        Subdivision *sm = (Subdivision *)chip->GetChild(4);
+        expect(that % (sm != nullptr) >> fatal);
+        expect(that % SYS_SAGE_SUBDIVISION_TYPE_GPU_SM == sm->GetSubdivisionType());
+        Memory *memory = (Memory *)node->FindSubcomponentById(0, SYS_SAGE_COMPONENT_MEMORY);
+        expect(that % (memory != nullptr) >> fatal);
+        expect(that % 1024 == memory->GetSize());
+        Numa *numa = (Numa *)node->FindSubcomponentById(0, SYS_SAGE_COMPONENT_NUMA);
+        expect(that % (numa != nullptr) >> fatal);
+        expect(that % 2048 == numa->GetSize());
+
+        Component *thread = node->FindSubcomponentById(2, SYS_SAGE_COMPONENT_THREAD);
+        expect(that % (thread != nullptr) >> fatal);
+        expect(that % 1 == l3->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % 2 == thread->GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_LOGICAL, SYS_SAGE_DATAPATH_INCOMING).size());
+        DataPath *cat = thread->GetDataPathsByType(SYS_SAGE_DATAPATH_TYPE_L3CAT, SYS_SAGE_DATAPATH_OUTGOING)[0];
+        expect(that % SYS_SAGE_DATAPATH_BIDIRECTIONAL == cat->GetOriented());
+        expect(that % (cat->attrib.Get<uint64_t>("CATL3mask") != nullptr) >> fatal);
+        expect(that % 0xff == *cat->attrib.Get<uint64_t>("CATL3mask"));
+        expect(that % 1 == numa->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size());
+        expect(that % 80 == numa->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING)[0]->GetLatency());
+
+        expect(that % (1 == node->GetDataPathMatrices().size()) >> fatal);
+        DataPathMatrix *m = node->GetDataPathMatrices()[0];
+        expect(that % 2 == m->GetNumDataPaths());
+        expect(that % 42 == m->GetLatency(1, 0));
+        expect(that % 50.0f == m->GetDataPath(thread, thread->GetParent()).GetMetric("latency_max"));
+
+        topo->Delete(true);
+    };
+
+    "Not a sys-sage export"_test = []
+    {
+        expect(that % (importFromXml(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml") == nullptr));
+        expect(that % (importFromXml("does-not-exist.xml") == nullptr));
+    };
+
+    "Shard of a sharded export"_test = []
+    {
+        {
+            auto topo = new Topology;
+            for (int n = 0; n < 4; n++)
+            {
+                auto node = new Node{topo, 10 + n};
+                auto t0 = new Thread{node, 0};
+                auto t1 = new Thread{node, 1};
+                node->attrib.Set<long long>("mig_size", n);
+                new DataPath{t0, t1, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, (double)(100 + n), 80};
+                if (n > 0)
+                    new DataPath{t0, topo->GetChild(10)->GetChild(0), SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, 1, 1};
+            }
+            expect(that % 0 == exportToXmlShards(topo, "test_shards.xml"));
+            topo->DeleteSubtree();
+            topo->DeleteAllDataPaths();
+            delete topo;
+        }
+
+        Component *node = importXmlShard("test_shards.xml", 12);
+        expect(that % (node != nullptr) >> fatal);
+        expect(that % SYS_SAGE_COMPONENT_NODE == node->GetComponentType());
+        expect(that % 12 == node->GetId());
+        expect(that % 2 == *node->attrib.Get<long long>("mig_size"));
+        Component *thread = node->GetChild(1);
+        expect(that % (thread != nullptr) >> fatal);
+        expect(that % (1 == thread->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).size()) >> fatal);
+        expect(that % 102 == thread->GetDataPathList(SYS_SAGE_DATAPATH_INCOMING)[0]->GetBw());
+        //the DataPath to Node 10 is listed in the manifest, not in the shard
+        expect(that % 1 == node->GetChild(0)->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).size());
+        node->Delete(true);
+
+        expect(that % (importXmlShard("test_shards.xml", 42) == nullptr));
+        expect(that % (importXmlShard("test.xml", 12) == nullptr));
+    };
+
+    "Typed attribute codecs"_test = []
+    {
+        struct Rack
+        {
+            int row;
+            int slot;
+        };
+        AttributeCodecRegistry codecs;
+        codecs.Register<int>(AttributeKey("rack_no"), [](const int &v) { return std::to_string(v); },
+                             [](const std::string &s, int *v) { *v = std::atoi(s.c_str()); return true; });
+        codecs.RegisterXml<Rack>(
+            AttributeKey("rack"),
+            [](const Rack &r, xmlNodePtr n)
+            {
+                xmlNodePtr pos = xmlNewChild(n, NULL, BAD_CAST "position", NULL);
+                xmlNewProp(pos, BAD_CAST "row", BAD_CAST std::to_string(r.row).c_str());
+                xmlNewProp(pos, BAD_CAST "slot", BAD_CAST std::to_string(r.slot).c_str());
+            },
+            [](xmlNodePtr n, Rack *r)
+            {
+                xmlNodePtr pos = xmlFirstElementChild(n);
+                if (pos == NULL)
+                    return false;
+                xmlChar *row = xmlGetProp(pos, BAD_CAST "row");
+                xmlChar *slot = xmlGetProp(pos, BAD_CAST "slot");
+                r->row = std::atoi((const char *)row);
+                r->slot = std::atoi((const char *)slot);
+                xmlFree(row);
+                xmlFree(slot);
+                return true;
+            });
+
+        {
+            auto topo = new Topology;
+            auto node = new Node{topo, 1};
+            node->attrib.Set<int>("rack_no", 15);
+            node->attrib.Set<Rack>("rack", Rack{3, 7});
+            node->attrib.Set<long long>("mig_size", 5);
+            expect(that % 0 == exportToXml(topo, "test.xml", &codecs));
+            topo->Delete(true);
+        }
+
+        Component *topo = importFromXml("test.xml", &codecs);
+        expect(that % (topo != nullptr) >> fatal);
+        Component *node = topo->GetChild(1);
+        expect(that % (node != nullptr) >> fatal);
+        expect(that % (node->attrib.Get<int>("rack_no") != nullptr) >> fatal);
+        expect(that % 15 == *node->attrib.Get<int>("rack_no"));
+        Rack *rack = node->attrib.Get<Rack>("rack");
+        expect(that % (rack != nullptr) >> fatal);
+        expect(that % 3 == rack->row);
+        expect(that % 7 == rack->slot);
+        expect(that % 5 == *node->attrib.Get<long long>("mig_size"));
+        topo->Delete(true);
+
+        //without the codecs, the typed attributes are not known
+        topo = importFromXml("test.xml");
+        expect(that % (topo != nullptr) >> fatal);
+        expect(that % (topo->GetChild(1)->attrib.Get<std::string>("rack_no") != nullptr));
+        expect(that % !topo->GetChild(1)->attrib.Has("rack"));
+        topo->Delete(true);
+    };
+};
@@ -0,0 +1,106 @@
+#include <boost/ut.hpp>
+#include <cmath>
+#include <cstdint>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"matrix"> _ = []
+{
+    "Latency and bandwidth matrices"_test = []
+    {
+        Node root;
+        Core a{&root, 0};
+        Core b{&root, 1};
+        Core c{&root, 2};
+        Thread t{&a, 0};
+        DataPath ab{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 4.0, 10.0};
+        DataPath ab2{&a, &b, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 8.0, 20.0};
+        DataPath ac{&a, &c, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 2.0, 5.0};
+        DataPath bc{&b, &c, SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_C2C, 6.0, 7.0};
+        DataPath phys{&c, &a, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 100.0, 1.0};
+        DataPath toThread{&a, &t, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 1.0, 1.0};
+
+        MetricMatrix latency{&root, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % 3 == latency.GetNumRows());
+        expect(that % 3 == latency.GetNumCols());
+        expect(that % 0 == latency.GetStride() % 16);
+        expect(that % 0u == (uintptr_t)latency.GetData() % SYS_SAGE_MATRIX_ALIGNMENT);
+        expect(that % 0u == (uintptr_t)latency.GetRow(1) % SYS_SAGE_MATRIX_ALIGNMENT);
+        int ia = latency.GetRowIndex(&a), ib = latency.GetColIndex(&b), ic = latency.GetColIndex(&c);
+        expect(that % &a == latency.GetRowComponent(ia));
+        expect(that % -1 == latency.GetRowIndex(&t));
+        expect(that % 10.0f == latency.Get(ia, ib));
+        expect(that % 5.0f == latency.Get(ia, ic));
+        expect(that % 7.0f == latency.Get(latency.GetRowIndex(&c), latency.GetColIndex(&b)));
+        expect(that % std::isnan(latency.Get(latency.GetRowIndex(&c), latency.GetColIndex(&a))));
+        expect(that % std::isnan(latency.Get(ia, latency.GetColIndex(&a))));
+        expect(that % ic == latency.RowArgMin(ia));
+        expect(that % ib == latency.RowArgMax(ia));
+        expect(that % ib == latency.RowArgMax(latency.GetRowIndex(&c)));
+
+        MetricMatrix fromThreads{&root, SYS_SAGE_COMPONENT_THREAD, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % 1 == fromThreads.GetNumRows());
+        expect(that % -1 == fromThreads.RowArgMax(0));
+        expect(that % -1 == fromThreads.RowArgMin(0));
+
+        MetricMatrix *bw = BuildMatrix(&root, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_DATAPATH_TYPE_ANY, SYS_SAGE_METRIC_BW);
+        expect(that % 8.0f == bw->Get(ia, ib));
+        expect(that % 100.0f == bw->Get(bw->GetRowIndex(&c), bw->GetColIndex(&a)));
+        std::vector<int> cols;
+        expect(that % 2 == bw->RowTopK(ia, 5, &cols));
+        expect(that % cols == std::vector<int>{ib, ic});
+        cols.clear();
+        expect(that % 1 == bw->RowTopK(bw->GetRowIndex(&c), 1, &cols, false));
+        expect(that % cols == std::vector<int>{bw->GetColIndex(&b)});
+        delete bw;
+    };
+
+    "Arg max and min of rows spanning several vectors"_test = []
+    {
+        Node root;
+        Core *cores[20];
+        for(int i = 0; i < 20; i++)
+            cores[i] = new Core(&root, i);
+        //ties between columns in different lanes: the first column wins
+        double latencies[20] = { -1, 7, 9, 3, 5, 8, 9, 4, 6, 5, 3, 7, 8, 4, 6, 9, 5, 8, 3, 6 };
+        for(int j = 1; j < 20; j++)
+            new DataPath(cores[0], cores[j], SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, -1, latencies[j]);
+
+        MetricMatrix latency{&root, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_COMPONENT_CORE, SYS_SAGE_DATAPATH_TYPE_C2C, SYS_SAGE_METRIC_LATENCY};
+        expect(that % 32 == latency.GetStride());
+        expect(that % 2 == latency.RowArgMax(0));
+        expect(that % 3 == latency.RowArgMin(0));
+        expect(that % -1 == latency.RowArgMax(19));
+        root.DeleteSubtree();
+    };
+
+    "NUMA bandwidth matrix of caps-numa-benchmark"_test = []
+    {
+        Topology topo;
+        Node node{&topo};
+        expect(that % (0 == parseHwlocOutput(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % (0 == parseCapsNumaBenchmark(&node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv")) >> fatal);
+
+        MetricMatrix bw{&node, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_COMPONENT_NUMA, SYS_SAGE_DATAPATH_TYPE_DATATRANSFER, SYS_SAGE_METRIC_BW};
+        expect(that % 4 == bw.GetNumRows());
+        for(int i = 0; i < bw.GetNumRows(); i++)
+        {
+            //compare with a scalar search over the data paths
+            double max_bw = -1;
+            Component *max_bw_component = NULL;
+            for(DataPath *dp : bw.GetRowComponent(i)->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING))
+            {
+                if(dp->GetBw() > max_bw)
+                {
+                    max_bw = dp->GetBw();
+                    max_bw_component = dp->GetTarget();
+                }
+            }
+            int j = bw.RowArgMax(i);
+            expect(that % max_bw_component == bw.GetColComponent(j));
+            expect(that % (float)max_bw == bw.Get(i, j));
+        }
+    };
+};
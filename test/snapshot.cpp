@@ -0,0 +1,177 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+using namespace boost::ut;
+
+static suite<"snapshot"> _ = []
+{
+    "Hardware topology with benchmark data"_test = []
+    {
+        Topology topo;
+        Node *node = new Node{&topo, 1};
+        expect(that % (0 == parseHwlocOutput(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml")) >> fatal);
+        expect(that % (0 == parseCapsNumaBenchmark(node, SYS_SAGE_TEST_RESOURCE_DIR "/skylake_caps_numa_benchmark.csv")) >> fatal);
+        node->attrib.Set<std::string>("codename", "marsupial");
+        node->attrib.Set<int>("rack_no", -15);
+        std::vector<Component *> numas;
+        node->FindAllSubcomponentsByType(&numas, SYS_SAGE_COMPONENT_NUMA);
+        DataPath *dp = numas[1]->GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING)[2];
+        dp->attrib.Set<double>("error", 0.5);
+        dp->attrib.Set<uint64_t>("runs", 3);
+        new DataPath{numas[0], numas[1], SYS_SAGE_DATAPATH_BIDIRECTIONAL, SYS_SAGE_DATAPATH_TYPE_PHYSICAL, 1, 2};
+
+        expect(that % (0 == exportToBinary(&topo, "test.snapshot")) >> fatal);
+
+        BinarySnapshot *snapshot = openBinarySnapshot("test.snapshot");
+        expect(that % (snapshot != nullptr) >> fatal);
+
+        TopologyView view(&topo);
+        expect(that % (view.GetNumComponents() == snapshot->GetNumComponents()) >> fatal);
+        bool same = true;
+        for (int i = 0; i < view.GetNumComponents(); ++i)
+        {
+            Component *c = view.GetComponent(i);
+            same = same && c->GetComponentType() == snapshot->GetComponentType(i) && c->GetId() == snapshot->GetId(i) &&
+                   c->GetName() == snapshot->GetName(i) && view.GetParentIndex(i) == snapshot->GetParentIndex(i) &&
+                   view.GetFirstChildIndex(i) == snapshot->GetFirstChildIndex(i) && view.GetNextSiblingIndex(i) == snapshot->GetNextSiblingIndex(i) &&
+                   view.GetSubtreeEnd(i) == snapshot->GetSubtreeEnd(i) && view.GetDepth(i) == snapshot->GetDepth(i) &&
+                   view.GetNumThreads(i) == snapshot->GetNumThreads(i);
+        }
+        expect(that % same);
+        expect(that % topo.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CACHE) == snapshot->CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CACHE));
+
+        int cache = snapshot->GetAllSubcomponentIndexesByType(SYS_SAGE_COMPONENT_CACHE)[0];
+        Cache *c = (Cache *)view.GetComponent(cache);
+        expect(that % c->GetCacheSize() == snapshot->GetSize(cache));
+        expect(that % c->GetCacheLineSize() == snapshot->GetComponentEntry(cache)->property[1]);
+
+        int n = view.GetIndex(node);
+        int attr = snapshot->FindAttribute(n, "codename");
+        expect(that % (attr >= 0) >> fatal);
+        expect(that % SYS_SAGE_SNAPSHOT_ATTRIB_STRING == snapshot->GetAttributeKind(attr));
+        expect(that % std::string_view{"marsupial"} == snapshot->GetAttributeString(attr));
+        attr = snapshot->FindAttribute(n, "rack_no");
+        expect(that % (attr >= 0) >> fatal);
+        expect(that % -15 == snapshot->GetAttributeInt(attr));
+        expect(that % -1 == snapshot->FindAttribute(n, "missing"));
+
+        expect(that % 17 == snapshot->GetNumDataPaths());
+        int numa0 = view.GetIndex(numas[0]);
+        int numa1 = view.GetIndex(numas[1]);
+        expect(that % 5 == snapshot->GetDataPaths(numa0, SYS_SAGE_DATAPATH_OUTGOING).size());
+        expect(that % 5 == snapshot->GetDataPaths(numa1, SYS_SAGE_DATAPATH_INCOMING).size());
+        bool found = false;
+        for (uint32_t k : snapshot->GetDataPaths(numa1, SYS_SAGE_DATAPATH_OUTGOING))
+        {
+            const BinarySnapshotDataPath *e = snapshot->GetDataPath(k);
+            if (e->target != view.GetIndex(numas[2]) || e->dp_type != SYS_SAGE_DATAPATH_TYPE_DATATRANSFER)
+                continue;
+            found = true;
+            expect(that % dp->GetBw() == e->bw);
+            expect(that % dp->GetLatency() == e->latency);
+            attr = snapshot->FindDataPathAttribute(k, "error");
+            expect(that % (attr >= 0) >> fatal);
+            expect(that % 0.5 == snapshot->GetAttributeDouble(attr));
+            attr = snapshot->FindDataPathAttribute(k, "runs");
+            expect(that % (attr >= 0) >> fatal);
+            expect(that % 3u == snapshot->GetAttributeUint(attr));
+        }
+        expect(that % found);
+
+        delete snapshot;
+        node->DeleteSubtree();
+        node->DeleteAllDataPaths();
+    };
+
+    "Invalid snapshots"_test = []
+    {
+        expect(that % (openBinarySnapshot("does-not-exist.snapshot") == nullptr));
+        expect(that % (openBinarySnapshot(SYS_SAGE_TEST_RESOURCE_DIR "/skylake_hwloc.xml") == nullptr));
+
+        Component c;
+        expect(that % (0 == exportToBinary(&c, "test.snapshot")) >> fatal);
+        std::string data;
+        {
+            std::ifstream in("test.snapshot", std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out("test.snapshot", std::ios::binary | std::ios::trunc);
+            out.write(data.data(), data.size() - 1);
+        }
+        expect(that % (openBinarySnapshot("test.snapshot") == nullptr));
+    };
+
+    "Snapshots with corrupted entries"_test = []
+    {
+        Node node;
+        Core core{&node, 0};
+        new DataPath(&node, &core, SYS_SAGE_DATAPATH_ORIENTED, SYS_SAGE_DATAPATH_TYPE_C2C, 1.0, 2.0);
+        core.attrib.Set<std::string>("label", "core");
+        expect(that % (0 == exportToBinary(&node, "test.snapshot")) >> fatal);
+        std::string data;
+        {
+            std::ifstream in("test.snapshot", std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        BinarySnapshotHeader h;
+        memcpy(&h, data.data(), sizeof(h));
+        expect(that % (2u == h.num_components && 1u == h.num_data_paths && 1u == h.num_attributes) >> fatal);
+
+        // each corruption writes a value into the original file at the given offset
+        auto opens_with = [&](size_t offset, auto value) {
+            std::string corrupted = data;
+            memcpy(&corrupted[offset], &value, sizeof(value));
+            std::ofstream out("test.snapshot", std::ios::binary | std::ios::trunc);
+            out.write(corrupted.data(), corrupted.size());
+            out.close();
+            BinarySnapshot *snapshot = openBinarySnapshot("test.snapshot");
+            delete snapshot;
+            return snapshot != nullptr;
+        };
+        size_t core_entry = h.components_offset + sizeof(BinarySnapshotComponent);
+        expect(that % opens_with(core_entry + offsetof(BinarySnapshotComponent, id), (int32_t)7));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, firstOutgoing), (uint32_t)1000));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, numIncoming), (uint32_t)0xffffffff));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, numAttributes), (uint32_t)2));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, parent), (int32_t)5));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, subtreeEnd), (int32_t)3));
+        expect(that % !opens_with(core_entry + offsetof(BinarySnapshotComponent, name), (uint32_t)h.strings_size));
+        expect(that % !opens_with(h.components_offset + offsetof(BinarySnapshotComponent, firstChild), (int32_t)-5));
+        expect(that % !opens_with(h.data_paths_offset + offsetof(BinarySnapshotDataPath, target), (int32_t)2));
+        expect(that % !opens_with(h.outgoing_offset, (uint32_t)1));
+        size_t attribute = h.attributes_offset + offsetof(BinarySnapshotAttribute, value);
+        expect(that % !opens_with(attribute + sizeof(uint32_t), (uint32_t)h.strings_size));
+        node.DeleteAllDataPaths();
+    };
+
+    "Attributes with a text codec"_test = []
+    {
+        AttributeCodecRegistry codecs;
+        codecs.Register<std::tuple<double, std::string>>(
+            AttributeKey("GPU_Clock_Rate"), [](const std::tuple<double, std::string> &v) { return std::to_string(std::get<0>(v)) + " " + std::get<1>(v); }, NULL);
+
+        Component c;
+        c.attrib.Set<std::tuple<double, std::string>>("GPU_Clock_Rate", {1.5, "GHz"});
+        expect(that % (0 == exportToBinary(&c, "test.snapshot")) >> fatal);
+        BinarySnapshot *snapshot = openBinarySnapshot("test.snapshot");
+        expect(that % (snapshot != nullptr) >> fatal);
+        expect(that % -1 == snapshot->FindAttribute(0, "GPU_Clock_Rate"));
+        delete snapshot;
+
+        expect(that % (0 == exportToBinary(&c, "test.snapshot", &codecs)) >> fatal);
+        snapshot = openBinarySnapshot("test.snapshot");
+        expect(that % (snapshot != nullptr) >> fatal);
+        int attr = snapshot->FindAttribute(0, "GPU_Clock_Rate");
+        expect(that % (attr >= 0) >> fatal);
+        expect(that % std::string_view{"1.500000 GHz"} == snapshot->GetAttributeString(attr));
+        delete snapshot;
+    };
+};
@@ -312,4 +312,198 @@ static suite<"topology"> _ = []
 
         expect(that % 3 == a.GetTopoTreeDepth());
     };
+
+    "Frozen view"_test = []
+    {
+        Topology topo;
+        Node a{&topo, 0};
+        Chip b{&a, 1};
+        Core c{&b, 2};
+        Thread d{&c, 3};
+        Thread e{&c, 4};
+        Core f{&b, 5};
+        Thread g{&f, 6};
+        Node h{&topo, 7};
+
+        TopologyView view = topo.Freeze();
+        expect(that % 9 == view.GetNumComponents());
+        expect(that % &topo == view.GetComponent(0));
+        expect(that % 0 == view.GetIndex(&topo));
+        expect(that % -1 == view.GetParentIndex(0));
+        expect(that % &h == view.GetComponent(view.GetNextSiblingIndex(view.GetIndex(&a))));
+        expect(that % &c == view.GetComponent(view.GetFirstChildIndex(view.GetIndex(&b))));
+        expect(that % 4 == view.GetDepth(view.GetIndex(&d)));
+        expect(that % view.GetIndex(&h) == view.GetSubtreeEnd(view.GetIndex(&a)));
+
+        expect(that % &e == view.GetSubcomponentById(4, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % nullptr == view.GetSubcomponentById(6, SYS_SAGE_COMPONENT_THREAD, view.GetIndex(&c)));
+        expect(that % view.GetAllSubcomponentsByType(SYS_SAGE_COMPONENT_THREAD) == (std::vector<Component *>{&d, &e, &g}));
+        expect(that % 2 == view.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 3 == view.GetNumThreads());
+        expect(that % 2 == view.GetNumThreads(view.GetIndex(&c)));
+        expect(that % 0 == view.GetNumThreads(view.GetIndex(&h)));
+    };
+
+    "Subcomponent index"_test = []
+    {
+        Node a{1};
+        Core b{&a, 2};
+        Thread c{&b, 3};
+        Core d{&a, 4};
+        Thread e{&d, 3};
+
+        a.EnableSubcomponentIndex();
+        expect(that % a.HasSubcomponentIndex());
+        expect(that % &c == a.GetSubcomponentById(3, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % a.GetAllSubcomponentsById(3, SYS_SAGE_COMPONENT_THREAD) == (std::vector<Component *>{&c, &e}));
+        expect(that % &a == a.GetSubcomponentById(1, SYS_SAGE_COMPONENT_NODE));
+        expect(that % nullptr == a.GetSubcomponentById(3, SYS_SAGE_COMPONENT_CORE));
+
+        Thread f{&b, 5};
+        expect(that % &f == a.GetSubcomponentById(5, SYS_SAGE_COMPONENT_THREAD));
+
+        a.RemoveChild(&b);
+        expect(that % &e == a.GetSubcomponentById(3, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % nullptr == a.GetSubcomponentById(5, SYS_SAGE_COMPONENT_THREAD));
+
+        //re-inserted after d -> e stays the first match in DFS order
+        a.InsertChild(&b);
+        expect(that % &e == a.GetSubcomponentById(3, SYS_SAGE_COMPONENT_THREAD));
+        expect(that % a.GetAllSubcomponentsById(3, SYS_SAGE_COMPONENT_THREAD) == (std::vector<Component *>{&e, &c}));
+
+        a.DisableSubcomponentIndex();
+        expect(that % !a.HasSubcomponentIndex());
+        expect(that % &e == a.GetSubcomponentById(3, SYS_SAGE_COMPONENT_THREAD));
+    };
+
+    "Ancestor queries"_test = []
+    {
+        Node a;
+        Chip b{&a};
+        Cache l3{&b, 0, "L3"};
+        Cache l2a{&l3, 0, "L2"};
+        Cache l2b{&l3, 1, "L2"};
+        Thread t0{&l2a, 0};
+        Thread t1{&l2a, 1};
+        Thread t2{&l2b, 2};
+        Node other;
+
+        expect(that % t0.IsDescendantOf(&a));
+        expect(that % t2.IsDescendantOf(&l3));
+        expect(that % !t2.IsDescendantOf(&l2a));
+        expect(that % !l3.IsDescendantOf(&l3));
+        expect(that % !l3.IsDescendantOf(&t0));
+        expect(that % !t0.IsDescendantOf(&other));
+
+        expect(that % &l2a == t0.GetLowestCommonAncestor(&t1));
+        expect(that % &l3 == t0.GetLowestCommonAncestor(&t2));
+        expect(that % &l3 == t0.GetLowestCommonAncestor(&l3));
+        expect(that % &l3 == t0.GetLowestCommonAncestor(&t2, SYS_SAGE_COMPONENT_CACHE));
+        expect(that % &b == t0.GetLowestCommonAncestor(&t2, SYS_SAGE_COMPONENT_CHIP));
+        expect(that % nullptr == t0.GetLowestCommonAncestor(&t2, SYS_SAGE_COMPONENT_NUMA));
+        expect(that % nullptr == t0.GetLowestCommonAncestor(&other));
+        expect(that % &b == t0.GetAncestorType(SYS_SAGE_COMPONENT_CHIP));
+        expect(that % nullptr == t0.GetAncestorType(SYS_SAGE_COMPONENT_NUMA));
+
+        //labels follow modifications of the tree
+        l3.RemoveChild(&l2b);
+        other.InsertChild(&l2b);
+        expect(that % t2.IsDescendantOf(&other));
+        expect(that % !t2.IsDescendantOf(&l3));
+        expect(that % nullptr == t0.GetLowestCommonAncestor(&t2));
+
+        //each tree has its own epoch
+        uint64_t epoch = a.GetTreeEpoch();
+        expect(that % epoch == t0.GetTreeEpoch());
+        Thread t3{&l2b, 3};
+        expect(that % epoch == a.GetTreeEpoch());
+        expect(that % other.GetTreeEpoch() == t3.GetTreeEpoch());
+        expect(that % t0.IsDescendantOf(&l2a));
+        Thread t4{&l2a, 4};
+        expect(that % epoch != a.GetTreeEpoch());
+        expect(that % t4.IsDescendantOf(&b));
+    };
+
+    "Ancestor queries after moving a subtree out of a deleted tree"_test = []
+    {
+        Node *old_root = new Node;
+        Cache *l3 = new Cache{old_root, 0, "L3"};
+        Thread *t = new Thread{l3, 0};
+        expect(that % t->IsDescendantOf(old_root));
+        Node new_root;
+        old_root->RemoveChild(l3);
+        new_root.InsertChild(l3);
+        old_root->Delete(true);
+        expect(that % t->IsDescendantOf(&new_root));
+        expect(that % l3 == t->GetAncestorType(SYS_SAGE_COMPONENT_CACHE));
+        new_root.DeleteSubtree();
+    };
+
+    "Subtree aggregates"_test = []
+    {
+        Node a;
+        Chip b{&a};
+        Core c{&b};
+        Thread d{&c};
+        Thread e{&c};
+        Core f{&a};
+        Thread g{&f};
+
+        expect(that % 6 == a.CountAllSubcomponents());
+        expect(that % 3 == a.GetNumThreads());
+        expect(that % 2 == a.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 0 == c.CountAllSubcomponentsByType(SYS_SAGE_COMPONENT_CORE));
+        expect(that % 3 == a.GetTopoTreeDepth());
+
+        a.RemoveChild(&b);
+        expect(that % 2 == a.CountAllSubcomponents());
+        expect(that % 1 == a.GetNumThreads());
+        expect(that % 2 == a.GetTopoTreeDepth());
+
+        Thread h{&g};
+        expect(that % 1 == g.GetNumThreads());
+        expect(that % 2 == a.GetNumThreads());
+        expect(that % 3 == a.GetTopoTreeDepth());
+
+        f.InsertChild(&b);
+        expect(that % 4 == a.GetNumThreads());
+        expect(that % 4 == a.GetTopoTreeDepth());
+        expect(that % 7 == a.CountAllSubcomponents());
+
+        //custom component types are counted by a DFS
+        Component custom{&e, 0, "custom", 4096};
+        expect(that % 1 == a.CountAllSubcomponentsByType(4096));
+        expect(that % 8 == a.CountAllSubcomponents());
+    };
+
+    "Bulk subtree deletion"_test = []
+    {
+        Node root;
+        Memory outside{&root};
+        auto chip = new Chip{&root};
+        auto core0 = new Core{chip, 0};
+        auto core1 = new Core{chip, 1};
+        new Thread{core0, 0};
+        new Thread{core1, 1};
+        new DataPath{core0, core1, SYS_SAGE_DATAPATH_ORIENTED};
+        new DataPath{core1, &outside, SYS_SAGE_DATAPATH_BIDIRECTIONAL};
+        new DataPath{&outside, core0, SYS_SAGE_DATAPATH_ORIENTED};
+        auto kept = new DataPath{&outside, &root, SYS_SAGE_DATAPATH_ORIENTED};
+        root.EnableSubcomponentIndex();
+
+        chip->DeleteSubtree();
+        expect(that % chip->GetChildren()->empty());
+        expect(that % 2 == root.CountAllSubcomponents());
+        expect(that % 0 == root.GetNumThreads());
+        expect(that % 1 == root.GetTopoTreeDepth());
+        expect(that % nullptr == root.GetSubcomponentById(1, SYS_SAGE_COMPONENT_CORE));
+        expect(that % std::vector<DataPath *>{kept} == outside.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING));
+        expect(that % outside.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).empty());
+
+        chip->Delete(true);
+        expect(that % 1 == root.CountAllSubcomponents());
+        outside.DeleteAllDataPaths();
+        expect(that % outside.GetDataPathList(SYS_SAGE_DATAPATH_OUTGOING).empty());
+        expect(that % root.GetDataPathList(SYS_SAGE_DATAPATH_INCOMING).empty());
+    };
 };
@@ -0,0 +1,81 @@
+#include <boost/ut.hpp>
+
+#include "sys-sage.hpp"
+
+using namespace boost::ut;
+
+static suite<"traversal"> _ = []
+{
+    "Pre-order and post-order"_test = []
+    {
+        Node a;
+        Chip b{&a};
+        Core c{&b};
+        Core d{&b};
+        Memory e{&a};
+
+        std::vector<Component *> pre;
+        for (Component *comp : subtree(&a))
+            pre.push_back(comp);
+        expect(that % pre == (std::vector<Component *>{&a, &b, &c, &d, &e}));
+
+        std::vector<Component *> post;
+        for (Component *comp : subtree_postorder(&a))
+            post.push_back(comp);
+        expect(that % post == (std::vector<Component *>{&c, &d, &b, &e, &a}));
+
+        //a subtree does not leave its root
+        std::vector<Component *> sub;
+        for (Component *comp : subtree(&b))
+            sub.push_back(comp);
+        expect(that % sub == (std::vector<Component *>{&b, &c, &d}));
+    };
+
+    "Type filter"_test = []
+    {
+        Node a;
+        Core b{&a, 1};
+        Thread c{&b, 2};
+        Core d{&a, 3};
+        Thread e{&d, 4};
+
+        std::vector<int> ids;
+        for (Core *core : subtree(&a) | of_type<Core>())
+            ids.push_back(core->GetId());
+        expect(that % ids == (std::vector<int>{1, 3}));
+
+        int threads = 0;
+        for (Component *thread : subtree_postorder(&a) | of_type(SYS_SAGE_COMPONENT_THREAD))
+            threads += thread->GetComponentType() == SYS_SAGE_COMPONENT_THREAD;
+        expect(that % 2 == threads);
+
+        //stop early
+        auto first = subtree(&a) | of_type<Thread>() | std::views::take(1);
+        expect(that % &c == *first.begin());
+        expect(that % (subtree(&c) | of_type<Core>()).empty());
+    };
+
+    "Deep tree"_test = []
+    {
+        //deeper than SYS_SAGE_TRAVERSAL_STACK_DEPTH
+        const int depth = 3 * SYS_SAGE_TRAVERSAL_STACK_DEPTH;
+        std::vector<Component *> chain{new Component(0)};
+        for (int i = 1; i < depth; i++)
+        {
+            chain.push_back(new Component(chain.back(), 2 * i));
+            new Component(chain[i - 1], 2 * i + 1);
+        }
+
+        int cnt = 0;
+        for (Component *comp : subtree(chain[0]))
+            cnt += comp != nullptr;
+        expect(that % (2 * depth - 1) == cnt);
+        cnt = 0;
+        for ([[maybe_unused]] Component *comp : subtree_postorder(chain[0]))
+            cnt++;
+        expect(that % (2 * depth - 1) == cnt);
+        expect(that % chain[0] == *std::ranges::next(subtree_postorder(chain[0]).begin(), 2 * depth - 2));
+
+        chain[0]->Delete(true);
+    };
+};